@@ -0,0 +1,1504 @@
+/**
+ * @file bench_sara.c
+ * @brief Microbenchmarks and trace replay for the array arena of sara.c.
+ *
+ * Runs a set of synthetic workloads (LIFO, FIFO, random-size churn,
+ * producer/consumer, and realloc growth) against StaticArrayAlloc(),
+ * StaticArrayTryRealloc(), and StaticArrayFree(), then replays any traces given
+ * on the command line. For each, the ns per call, the p50/p99/p999/max
+ * latency, the peak waste (bytes held by the arena beyond what was requested,
+ * as a share of the pool), and the failure rate are reported. Failures while
+ * the arena had enough bytes free in total are counted separately, as those
+ * are down to fragmentation, and so are failures of requests that no block
+ * could hold (e.g., past the largest block size /w ARRAY_ARENA_REALTIME).
+ *
+ * For the segregated free-lists (save for ARRAY_ARENA_THREAD_SAFE, where the
+ * caches are in the way), the worst-case paths through alloc, free, and
+ * realloc are then timed on their own (the most splits, the most merges, the
+ * longest search for a free block, and a realloc that has to move the block),
+ * and the max of each is reported in ticks too, i.e., in cycles on Cortex-M.
+ * That is the number to certify an ARRAY_ARENA_REALTIME build by, taken on
+ * the target: on a host, preemption inflates the max.
+ *
+ * sara.c is built into this file (as the vector lib does), so the backend and
+ * its options are picked /w the usual ARRAY_ARENA_* macros (see the bench-*
+ * targets in the Makefile).
+ *
+ * Traces are either the text format of scripts/tune_arena.py (lines of
+ * 'alloc <id> <bytes>', 'realloc <id> <bytes>', or 'free <id>') or a raw
+ * (little-endian) ARRAY_ARENA_TELEMETRY capture, as saved by
+ * scripts/decode_telemetry.py --save. Traces can only be read on a hosted
+ * target.
+ *
+ * @copyright MIT License
+ */
+
+#if defined(__ARM_EABI__) && !defined(__linux__)
+#define BENCH_BARE_METAL
+#endif
+
+#if !defined(BENCH_BARE_METAL) && !defined(_WIN32)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef BENCH_BARE_METAL
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+#if !defined(BENCH_BARE_METAL) && defined(ARRAY_ARENA_THREAD_SAFE)
+#include <pthread.h>
+#define BENCH_THREADS
+#endif
+
+/*************************** The Arena Under Test *****************************/
+
+#define STATIC
+
+#ifndef VEC_ARRAY_ARENA_SIZE
+#ifdef BENCH_BARE_METAL
+#define VEC_ARRAY_ARENA_SIZE 8192
+#else
+#define VEC_ARRAY_ARENA_SIZE 16384
+#endif
+#endif
+
+// Stand-in for the vector lib's header, which the object pool is sized by
+struct Vector_S
+{
+   void * data;
+   size_t len;
+   size_t capacity;
+};
+
+#include "sara.c"
+
+/****************************** Configuration *********************************/
+
+#ifndef BENCH_CFG_NAME
+#define BENCH_CFG_NAME "custom"
+#endif
+
+// Calls per synthetic workload
+#ifndef BENCH_OPS
+#ifdef BENCH_BARE_METAL
+#define BENCH_OPS 20000u
+#else
+#define BENCH_OPS 400000u
+#endif
+#endif
+
+// Blocks a synthetic workload keeps live at most
+#ifndef BENCH_SLOTS
+#define BENCH_SLOTS 48u
+#endif
+
+// Requests are spread log-uniformly over [1, BENCH_MAX_REQ] bytes
+#ifndef BENCH_MAX_REQ
+#define BENCH_MAX_REQ 512u
+#endif
+
+// Buffers in the realloc-growth workload grow to at most this many bytes
+#ifndef BENCH_GROW_MAX
+#define BENCH_GROW_MAX 4096u
+#endif
+
+// Objects of the fixed-size workloads (e.g., message headers)
+#ifndef BENCH_FIXED_BYTES
+#define BENCH_FIXED_BYTES 24u
+#endif
+
+// The random requests and the fixed-size objects fit a single block, canary
+// included, so that a hardened run fails no more often than a plain one
+#ifndef ARRAY_ARENA_SCHEME_BUMP
+typedef char Bench_MaxReqFitsABlock[ ((BENCH_MAX_REQ + ARRAY_ARENA_BLOCK_OVERHEAD) <= LARGEST_BLOCK_SIZE) ? 1 : -1 ];
+typedef char Bench_FixedBytesFitAClass[ (BENCH_FIXED_BYTES <= ARRAY_ARENA_MAX_CLASS_REQ) ? 1 : -1 ];
+#endif
+
+#ifndef BENCH_SEED
+#define BENCH_SEED 0x5A4A0001u
+#endif
+
+// Only the segregated free-lists have worst-case paths to take, and /w the
+// per-thread caches in the way, what the shared lists look like is out of
+// the benchmark's hands.
+#if !defined(ARRAY_ARENA_SCHEME_BUMP) && !defined(ARRAY_ARENA_THREAD_SAFE)
+#define BENCH_WCET
+#endif
+
+// Times each worst-case path is taken
+#ifndef BENCH_WCET_REPS
+#ifdef BENCH_BARE_METAL
+#define BENCH_WCET_REPS 500u
+#else
+#define BENCH_WCET_REPS 20000u
+#endif
+#endif
+
+// Blocks a trace may have live at once
+#ifndef BENCH_TRACE_SLOTS
+#define BENCH_TRACE_SLOTS 4096u
+#endif
+
+#if BENCH_TRACE_SLOTS > UINT16_MAX
+#error "BENCH_TRACE_SLOTS must fit in a uint16_t"
+#endif
+
+#ifdef BENCH_BARE_METAL
+#define BENCH_MAX_SLOTS BENCH_SLOTS
+#elif BENCH_TRACE_SLOTS > BENCH_SLOTS
+#define BENCH_MAX_SLOTS BENCH_TRACE_SLOTS
+#else
+#define BENCH_MAX_SLOTS BENCH_SLOTS
+#endif
+
+/********************************** Timer *************************************/
+
+// BENCH_TICKS() reads a free-running counter of BENCH_TICKS_MASK bits (the
+// difference of two reads comes out right across a wrap). A target not
+// covered below can supply its own, along /w BENCH_TICKS_PER_MS.
+#if defined(BENCH_TICKS)
+#ifndef BENCH_TICKS_PER_MS
+#error "A custom BENCH_TICKS() needs BENCH_TICKS_PER_MS"
+#endif
+
+#elif defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define BENCH_TICKS() ( (uint32_t)__builtin_ia32_rdtsc() )
+#define BENCH_CALIBRATE_TICKS
+
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define BENCH_DWT_CYCCNT  ( *(volatile uint32_t *)0xE0001004u )
+#define BENCH_DWT_CTRL    ( *(volatile uint32_t *)0xE0001000u )
+#define BENCH_DEMCR       ( *(volatile uint32_t *)0xE000EDFCu )
+#define BENCH_TICKS()     BENCH_DWT_CYCCNT
+
+#elif defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__)
+// No DWT cycle counter here, so SysTick (24 bits, counting down) has to do
+#define BENCH_SYST_CSR    ( *(volatile uint32_t *)0xE000E010u )
+#define BENCH_SYST_RVR    ( *(volatile uint32_t *)0xE000E014u )
+#define BENCH_SYST_CVR    ( *(volatile uint32_t *)0xE000E018u )
+#define BENCH_TICKS()     ( 0x00FFFFFFu - BENCH_SYST_CVR )
+#define BENCH_TICKS_MASK  0x00FFFFFFu
+
+#elif !defined(BENCH_BARE_METAL)
+#define BENCH_TICKS() ( (uint32_t)Bench_NowNs() )
+#define BENCH_TICKS_PER_MS 1000000u
+
+#else
+#error "Define BENCH_TICKS() and BENCH_TICKS_PER_MS for this target."
+#endif
+
+#ifndef BENCH_TICKS_MASK
+#define BENCH_TICKS_MASK 0xFFFFFFFFu
+#endif
+
+#if defined(BENCH_BARE_METAL) && !defined(BENCH_TICKS_PER_MS)
+#ifndef BENCH_CPU_HZ
+#error "Define BENCH_CPU_HZ (the core clock) so that cycles can be given in ns."
+#endif
+#define BENCH_TICKS_PER_MS ( (uint32_t)(BENCH_CPU_HZ / 1000u) )
+#endif
+
+// Keeps the compiler from moving the call being timed across the timer reads
+#if defined(__GNUC__)
+#define BENCH_BARRIER() __asm__ volatile ( "" ::: "memory" )
+#else
+#error "Define BENCH_BARRIER() (a compiler memory barrier) for this compiler."
+#endif
+
+/********************************** Results ***********************************/
+
+// Latencies are binned log-linearly: 8 bins per power of 2 of ticks, so a
+// percentile is off by at most an eighth.
+#define BENCH_HIST_SUB_BITS 3u
+#define BENCH_HIST_LEN      ( (32u - BENCH_HIST_SUB_BITS + 1u) << BENCH_HIST_SUB_BITS )
+
+struct BenchResult_S
+{
+   uint32_t hist[BENCH_HIST_LEN];
+   uint64_t total_ticks;
+   uint32_t max_ticks;
+   uint32_t ops;
+   uint32_t alloc_reqs;
+   uint32_t fails;
+   uint32_t frag_fails; // Failures /w at least as many bytes free (in total) as were requested
+   uint32_t size_fails; // Failures of requests that no block could hold, however much were free
+   size_t peak_waste_bytes;
+   uint32_t rng;
+};
+
+struct BenchSlot_S
+{
+   void * ptr;
+   size_t bytes;
+};
+
+typedef void (*BenchWorkload_T)(struct BenchResult_S *);
+
+static struct BenchSlot_S BenchSlots[BENCH_MAX_SLOTS];
+
+// Bytes requested for the blocks that are live, across all threads
+static size_t BenchLiveBytes;
+#ifdef BENCH_THREADS
+#define BENCH_LIVE_ADD(n)  ( (void)__atomic_add_fetch( &BenchLiveBytes, (n), __ATOMIC_RELAXED ) )
+#define BENCH_LIVE_SUB(n)  ( (void)__atomic_sub_fetch( &BenchLiveBytes, (n), __ATOMIC_RELAXED ) )
+#define BENCH_LIVE_LOAD()  __atomic_load_n( &BenchLiveBytes, __ATOMIC_RELAXED )
+#else
+#define BENCH_LIVE_ADD(n)  ( BenchLiveBytes += (n) )
+#define BENCH_LIVE_SUB(n)  ( BenchLiveBytes -= (n) )
+#define BENCH_LIVE_LOAD()  BenchLiveBytes
+#endif
+
+static uint32_t BenchTicksPerMs;
+static uint32_t BenchTimerOverhead; // Ticks of two back-to-back reads
+static size_t BenchPoolBytes;       // Bytes the arena has to give out when empty
+static bool BenchLeaked;
+static bool BenchWcetInvalid;       // A worst-case path failed, so its row does not time it
+
+/************************* Local Function Prototypes **************************/
+
+#ifndef BENCH_BARE_METAL
+/**
+ * @brief Reads the monotonic clock of the host, in ns.
+ */
+static uint64_t Bench_NowNs(void);
+#endif
+
+/**
+ * @brief Starts the cycle counter (if it needs to be), and works out the
+ *        ticks per ms and the overhead of reading it.
+ */
+static void Bench_TimerInit(void);
+
+/**
+ * @brief Converts ticks to ns.
+ */
+static uint32_t Bench_TicksToNs( uint64_t ticks );
+
+/**
+ * @brief Bins a latency into the histogram of a result.
+ */
+static void Bench_Record( struct BenchResult_S * res, uint32_t ticks );
+
+/**
+ * @brief Upper bound of the latency (in ticks) at permille pm of a result.
+ */
+static uint32_t Bench_Percentile( const struct BenchResult_S * res, uint32_t pm );
+
+/**
+ * @brief Prints a result as a row of the table.
+ */
+static void Bench_Print( const char * name, const struct BenchResult_S * res );
+
+#ifdef BENCH_THREADS
+/**
+ * @brief Folds what src measured into dst (i.e., for the threads of a workload).
+ */
+static void Bench_Merge( struct BenchResult_S * dst, const struct BenchResult_S * src );
+#endif
+
+/**
+ * @brief xorshift32, seeded per workload so that every run is the same.
+ */
+static uint32_t Bench_Rand( struct BenchResult_S * res );
+
+/**
+ * @brief A request size, spread log-uniformly over [1, BENCH_MAX_REQ].
+ */
+static size_t Bench_RandSize( struct BenchResult_S * res );
+
+/**
+ * @brief Bytes the arena has free or held, by the backend's own bookkeeping.
+ */
+static size_t Bench_FreeBytes(void);
+static size_t Bench_HeldBytes(void);
+
+/**
+ * @brief Whether no block of the arena could hold a request of that many
+ *        bytes, however much were free (as ARRAY_ARENA_TOO_LARGE has it).
+ */
+static bool Bench_IsTooLarge( size_t bytes );
+
+/**
+ * @brief Raises the peak waste of a result to what the arena wastes now, if higher.
+ */
+static void Bench_SampleWaste( struct BenchResult_S * res );
+
+/**
+ * @brief Timed wrappers of StaticArrayAlloc(), StaticArrayTryRealloc(), and
+ *        StaticArrayFree(), which also keep the counts of a result. The fixed
+ *        alloc is of BENCH_FIXED_BYTES, through STATIC_ARRAY_ALLOC_FIXED().
+ */
+static void * Bench_Alloc( struct BenchResult_S * res, size_t bytes );
+static void * Bench_AllocFixed( struct BenchResult_S * res );
+static bool   Bench_Realloc( struct BenchResult_S * res, struct BenchSlot_S * slot, size_t bytes );
+static void   Bench_Free( struct BenchResult_S * res, const void * ptr, size_t bytes );
+
+/**
+ * @brief Slot versions of the wrappers above, which skip empty slots.
+ */
+static void Bench_SlotAlloc( struct BenchResult_S * res, struct BenchSlot_S * slot, size_t bytes );
+static void Bench_SlotFree( struct BenchResult_S * res, struct BenchSlot_S * slot );
+static void Bench_FreeAllSlots( struct BenchResult_S * res, size_t num_of_slots );
+
+/**
+ * @brief The synthetic workloads.
+ */
+static void Bench_Lifo( struct BenchResult_S * res );
+static void Bench_Fifo( struct BenchResult_S * res );
+static void Bench_Churn( struct BenchResult_S * res );
+static void Bench_ProducerConsumer( struct BenchResult_S * res );
+static void Bench_ReallocGrowth( struct BenchResult_S * res );
+static void Bench_FixedSize( struct BenchResult_S * res );
+static void Bench_FixedSizeFast( struct BenchResult_S * res );
+
+#ifdef BENCH_WCET
+/**
+ * @brief Takes the whole arena as blocks of the smallest size, and hands back
+ *        the ones in [offset, offset + len) or all of them, so that the
+ *        worst-case paths have the free lists they need (untimed).
+ */
+static void Bench_WcetFill(void);
+static void Bench_WcetRelease( size_t offset, size_t len );
+static void Bench_WcetDrain(void);
+
+/**
+ * @brief The worst-case paths, each of which times only the one call.
+ */
+static void Bench_WcetAllocSplit( struct BenchResult_S * res );
+static void Bench_WcetFreeMerge( struct BenchResult_S * res );
+static void Bench_WcetAllocSearch( struct BenchResult_S * res );
+static void Bench_WcetReallocMove( struct BenchResult_S * res );
+
+/**
+ * @brief Runs a worst-case path and prints its max in ticks as well, flagging
+ *        the row (and the exit status) if the path failed even once.
+ */
+static void Bench_RunWcet( const char * name, BenchWorkload_T workload );
+#endif
+
+/**
+ * @brief Runs a workload on the (empty) arena and prints what it measured.
+ * @note Every workload hands back what it allocated, and the arena is checked
+ *       to be just as empty afterwards.
+ * @return What the workload measured (until the next run)
+ */
+static const struct BenchResult_S * Bench_Run( const char * name, BenchWorkload_T workload, uint32_t seed );
+
+#ifndef BENCH_BARE_METAL
+/**
+ * @brief Loads a text or telemetry trace into BenchTraceOps.
+ * @return false if the trace could not be read.
+ */
+static bool Bench_LoadTrace( const char * path );
+
+/**
+ * @brief Replays the ops of the loaded trace.
+ */
+static void Bench_Replay( struct BenchResult_S * res );
+#endif
+
+/******************************* Entry Point **********************************/
+
+#ifdef BENCH_SEMIHOSTING
+extern void initialise_monitor_handles(void);
+#endif
+
+int main(int argc, char * argv[])
+{
+#ifdef BENCH_SEMIHOSTING
+   initialise_monitor_handles();
+#endif
+
+   Bench_TimerInit();
+   StaticArrayPoolInit();
+   BenchPoolBytes = Bench_FreeBytes();
+
+   printf( "== %s: %u-byte arena, %" PRIu32 " ticks/ms, timer overhead of %" PRIu32 " ticks subtracted ==\n",
+           BENCH_CFG_NAME, (unsigned)VEC_ARRAY_ARENA_SIZE, BenchTicksPerMs, BenchTimerOverhead );
+   printf( "%-24s %9s %8s %7s %7s %7s %8s %7s %7s %9s %9s\n",
+           "workload", "ops", "ns/op", "p50", "p99", "p999", "max", "waste%", "fail%", "frag-fail", "too-large" );
+
+   Bench_Run( "lifo",              Bench_Lifo,             BENCH_SEED ^ 1u );
+   Bench_Run( "fifo",              Bench_Fifo,             BENCH_SEED ^ 2u );
+   Bench_Run( "churn",             Bench_Churn,            BENCH_SEED ^ 3u );
+   Bench_Run( "producer-consumer", Bench_ProducerConsumer, BENCH_SEED ^ 4u );
+   Bench_Run( "realloc-growth",    Bench_ReallocGrowth,    BENCH_SEED ^ 5u );
+   Bench_Run( "fixed-size",        Bench_FixedSize,        BENCH_SEED ^ 6u );
+   Bench_Run( "fixed-size-fast",   Bench_FixedSizeFast,    BENCH_SEED ^ 6u );
+#ifdef BENCH_WCET
+   Bench_RunWcet( "wcet-alloc-split",   Bench_WcetAllocSplit );
+   Bench_RunWcet( "wcet-free-merge",    Bench_WcetFreeMerge );
+   Bench_RunWcet( "wcet-alloc-search",  Bench_WcetAllocSearch );
+   Bench_RunWcet( "wcet-realloc-move",  Bench_WcetReallocMove );
+#endif
+
+#ifndef BENCH_BARE_METAL
+   for ( int i = 1; i < argc; i++ )
+   {
+      if ( !Bench_LoadTrace( argv[i] ) )
+      {
+         fprintf( stderr, "Could not read the trace %s\n", argv[i] );
+         return 1;
+      }
+      Bench_Run( argv[i], Bench_Replay, BENCH_SEED );
+   }
+#else
+   (void)argc;
+   (void)argv;
+#endif
+
+   printf( "\n" );
+   return (BenchLeaked || BenchWcetInvalid) ? 1 : 0;
+}
+
+/*************************** Timer & Result Helpers ***************************/
+
+#ifndef BENCH_BARE_METAL
+static uint64_t Bench_NowNs(void)
+{
+#ifdef _WIN32
+   static LARGE_INTEGER freq;
+   LARGE_INTEGER count;
+   if ( 0 == freq.QuadPart )   (void)QueryPerformanceFrequency( &freq );
+   (void)QueryPerformanceCounter( &count );
+   uint64_t f = (uint64_t)freq.QuadPart;
+   uint64_t c = (uint64_t)count.QuadPart;
+   return ( (c / f) * 1000000000u ) + ( ((c % f) * 1000000000u) / f );
+#else
+   struct timespec ts;
+   (void)clock_gettime( CLOCK_MONOTONIC, &ts );
+   return ( (uint64_t)ts.tv_sec * 1000000000u ) + (uint64_t)ts.tv_nsec;
+#endif
+}
+#endif // BENCH_BARE_METAL
+
+static void Bench_TimerInit(void)
+{
+#if defined(BENCH_DWT_CYCCNT)
+   BENCH_DEMCR |= (1u << 24); // TRCENA
+   BENCH_DWT_CYCCNT = 0;
+   BENCH_DWT_CTRL |= 1u;      // CYCCNTENA
+#elif defined(BENCH_SYST_CSR)
+   BENCH_SYST_RVR = 0x00FFFFFFu;
+   BENCH_SYST_CVR = 0;
+   BENCH_SYST_CSR = 0x5u;     // CLKSOURCE = the core clock, ENABLE, no interrupt
+#endif
+
+#ifdef BENCH_CALIBRATE_TICKS
+   // The TSC runs at a fixed rate, which the host clock tells us
+   uint64_t ns_start = Bench_NowNs();
+   uint32_t ticks_start = BENCH_TICKS();
+   while ( (Bench_NowNs() - ns_start) < 50000000u ) {}
+   uint64_t cal_ticks = (uint64_t)((BENCH_TICKS() - ticks_start) & BENCH_TICKS_MASK);
+   uint64_t cal_ns = Bench_NowNs() - ns_start;
+   BenchTicksPerMs = (uint32_t)( (cal_ticks * 1000000u) / cal_ns );
+#else
+   BenchTicksPerMs = BENCH_TICKS_PER_MS;
+#endif
+
+   BenchTimerOverhead = UINT32_MAX;
+   for ( uint32_t i = 0; i < 1000u; i++ )
+   {
+      uint32_t start = BENCH_TICKS();
+      BENCH_BARRIER();
+      uint32_t ticks = (BENCH_TICKS() - start) & BENCH_TICKS_MASK;
+      if ( ticks < BenchTimerOverhead )   BenchTimerOverhead = ticks;
+   }
+}
+
+static uint32_t Bench_TicksToNs( uint64_t ticks )
+{
+   return (uint32_t)( (ticks * 1000000u) / BenchTicksPerMs );
+}
+
+static void Bench_Record( struct BenchResult_S * res, uint32_t ticks )
+{
+   ticks = (ticks > BenchTimerOverhead) ? (ticks - BenchTimerOverhead) : 0;
+
+   uint32_t bin = ticks;
+   if ( ticks >= (1u << BENCH_HIST_SUB_BITS) )
+   {
+      uint32_t log2 = BENCH_HIST_SUB_BITS;
+      while ( (ticks >> (log2 + 1u)) != 0 )   log2++;
+      uint32_t sub = (ticks >> (log2 - BENCH_HIST_SUB_BITS)) & ((1u << BENCH_HIST_SUB_BITS) - 1u);
+      bin = ((log2 - BENCH_HIST_SUB_BITS + 1u) << BENCH_HIST_SUB_BITS) | sub;
+   }
+   res->hist[bin]++;
+   res->total_ticks += ticks;
+   if ( ticks > res->max_ticks )   res->max_ticks = ticks;
+   res->ops++;
+}
+
+static uint32_t Bench_Percentile( const struct BenchResult_S * res, uint32_t pm )
+{
+   // The smallest bin by which more than pm / 1000 of the ops had completed
+   uint64_t target = ((uint64_t)res->ops * pm) / 1000u;
+   uint64_t seen = 0;
+   for ( uint32_t bin = 0; bin < BENCH_HIST_LEN; bin++ )
+   {
+      seen += res->hist[bin];
+      if ( seen > target )
+      {
+         if ( bin < (1u << BENCH_HIST_SUB_BITS) )   return bin;
+         uint32_t shift = (bin >> BENCH_HIST_SUB_BITS) - 1u;
+         uint32_t lo = ((1u << BENCH_HIST_SUB_BITS) | (bin & ((1u << BENCH_HIST_SUB_BITS) - 1u))) << shift;
+         uint32_t hi = lo + ((1u << shift) - 1u);
+         return (hi < res->max_ticks) ? hi : res->max_ticks;
+      }
+   }
+   return res->max_ticks;
+}
+
+static void Bench_Print( const char * name, const struct BenchResult_S * res )
+{
+   uint32_t ops = (res->ops > 0) ? res->ops : 1u;
+   // In tenths of a ns/percent, to print one decimal /wout floating point
+   uint32_t ns_per_op = (uint32_t)( (res->total_ticks * 10000000u) / ((uint64_t)BenchTicksPerMs * ops) );
+   uint32_t waste = (uint32_t)( ((uint64_t)res->peak_waste_bytes * 1000u) / BenchPoolBytes );
+   uint32_t fails = (res->alloc_reqs > 0) ? (uint32_t)( ((uint64_t)res->fails * 1000u) / res->alloc_reqs ) : 0;
+
+   printf( "%-24s %9" PRIu32 " %6" PRIu32 ".%" PRIu32 " %7" PRIu32 " %7" PRIu32 " %7" PRIu32 " %8" PRIu32
+           " %5" PRIu32 ".%" PRIu32 " %5" PRIu32 ".%" PRIu32 " %9" PRIu32 " %9" PRIu32 "\n",
+           name, res->ops, ns_per_op / 10u, ns_per_op % 10u,
+           Bench_TicksToNs( Bench_Percentile( res, 500u ) ),
+           Bench_TicksToNs( Bench_Percentile( res, 990u ) ),
+           Bench_TicksToNs( Bench_Percentile( res, 999u ) ),
+           Bench_TicksToNs( res->max_ticks ),
+           waste / 10u, waste % 10u, fails / 10u, fails % 10u, res->frag_fails, res->size_fails );
+}
+
+#ifdef BENCH_THREADS
+static void Bench_Merge( struct BenchResult_S * dst, const struct BenchResult_S * src )
+{
+   for ( uint32_t bin = 0; bin < BENCH_HIST_LEN; bin++ )   dst->hist[bin] += src->hist[bin];
+   dst->total_ticks += src->total_ticks;
+   if ( src->max_ticks > dst->max_ticks )   dst->max_ticks = src->max_ticks;
+   dst->ops += src->ops;
+   dst->alloc_reqs += src->alloc_reqs;
+   dst->fails += src->fails;
+   dst->frag_fails += src->frag_fails;
+   dst->size_fails += src->size_fails;
+   if ( src->peak_waste_bytes > dst->peak_waste_bytes )   dst->peak_waste_bytes = src->peak_waste_bytes;
+}
+#endif
+
+static uint32_t Bench_Rand( struct BenchResult_S * res )
+{
+   uint32_t x = res->rng;
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   res->rng = x;
+   return x;
+}
+
+static size_t Bench_RandSize( struct BenchResult_S * res )
+{
+   uint32_t log2_max = 0;
+   while ( (1u << (log2_max + 1u)) <= BENCH_MAX_REQ )   log2_max++;
+
+   uint32_t log2 = Bench_Rand( res ) % (log2_max + 1u);
+   uint32_t lo = (1u << log2) >> 1;
+   uint32_t span = (1u << log2) - lo;
+   return (size_t)( lo + 1u + (Bench_Rand( res ) % span) );
+}
+
+/***************************** Arena Bookkeeping ******************************/
+
+static size_t Bench_FreeBytes(void)
+{
+#ifdef ARRAY_ARENA_SCHEME_BUMP
+   return ArrayArena.pool_size - ArrayArena.top;
+#else
+   return ArrayArena.space_available;
+#endif
+}
+
+static bool Bench_IsTooLarge( size_t bytes )
+{
+#ifdef ARRAY_ARENA_SCHEME_BUMP
+   return ARRAY_ARENA_TOO_LARGE == BUMP_FAIL_STATUS( &ArrayArena, bytes );
+#else
+   return ARRAY_ARENA_TOO_LARGE == Helper_AllocFailure( &ArrayArena, bytes, 0 );
+#endif
+}
+
+static size_t Bench_HeldBytes(void)
+{
+   // Blocks sitting in a per-thread cache count as held
+   size_t free_bytes = Bench_FreeBytes();
+   return (free_bytes < BenchPoolBytes) ? (BenchPoolBytes - free_bytes) : 0;
+}
+
+static void Bench_SampleWaste( struct BenchResult_S * res )
+{
+   size_t held = Bench_HeldBytes();
+   size_t live = BENCH_LIVE_LOAD();
+   size_t waste = (held > live) ? (held - live) : 0;
+   if ( waste > res->peak_waste_bytes )   res->peak_waste_bytes = waste;
+}
+
+/******************************* Timed Wrappers *******************************/
+
+static void * Bench_Alloc( struct BenchResult_S * res, size_t bytes )
+{
+   uint32_t start = BENCH_TICKS();
+   BENCH_BARRIER();
+   void * ptr = StaticArrayAlloc( bytes );
+   BENCH_BARRIER();
+   Bench_Record( res, (BENCH_TICKS() - start) & BENCH_TICKS_MASK );
+
+   res->alloc_reqs++;
+   if ( NULL == ptr )
+   {
+      res->fails++;
+      if ( Bench_IsTooLarge( bytes ) )   res->size_fails++;
+      else if ( bytes <= Bench_FreeBytes() )   res->frag_fails++;
+      return NULL;
+   }
+   BENCH_LIVE_ADD( bytes );
+   Bench_SampleWaste( res );
+   return ptr;
+}
+
+static void * Bench_AllocFixed( struct BenchResult_S * res )
+{
+   uint32_t start = BENCH_TICKS();
+   BENCH_BARRIER();
+   void * ptr = STATIC_ARRAY_ALLOC_FIXED( BENCH_FIXED_BYTES );
+   BENCH_BARRIER();
+   Bench_Record( res, (BENCH_TICKS() - start) & BENCH_TICKS_MASK );
+
+   res->alloc_reqs++;
+   if ( NULL == ptr )
+   {
+      res->fails++;
+      if ( BENCH_FIXED_BYTES <= Bench_FreeBytes() )   res->frag_fails++;
+      return NULL;
+   }
+   BENCH_LIVE_ADD( BENCH_FIXED_BYTES );
+   Bench_SampleWaste( res );
+   return ptr;
+}
+
+static bool Bench_Realloc( struct BenchResult_S * res, struct BenchSlot_S * slot, size_t bytes )
+{
+   uint32_t start = BENCH_TICKS();
+   BENCH_BARRIER();
+   void * ptr = slot->ptr;
+   enum ArrayArenaStatus status = StaticArrayTryRealloc( &ptr, bytes, NULL );
+   BENCH_BARRIER();
+   Bench_Record( res, (BENCH_TICKS() - start) & BENCH_TICKS_MASK );
+
+   res->alloc_reqs++;
+   if ( status != ARRAY_ARENA_OK )
+   {
+      res->fails++;
+      if ( ARRAY_ARENA_TOO_LARGE == status )   res->size_fails++;
+      else if ( (bytes > slot->bytes) && ((bytes - slot->bytes) <= Bench_FreeBytes()) )   res->frag_fails++;
+      return false;
+   }
+   BENCH_LIVE_ADD( bytes );
+   BENCH_LIVE_SUB( slot->bytes );
+   slot->ptr = ptr;
+   slot->bytes = bytes;
+   Bench_SampleWaste( res );
+   return true;
+}
+
+static void Bench_Free( struct BenchResult_S * res, const void * ptr, size_t bytes )
+{
+   uint32_t start = BENCH_TICKS();
+   BENCH_BARRIER();
+   StaticArrayFree( ptr );
+   BENCH_BARRIER();
+   Bench_Record( res, (BENCH_TICKS() - start) & BENCH_TICKS_MASK );
+
+   BENCH_LIVE_SUB( bytes );
+}
+
+static void Bench_SlotAlloc( struct BenchResult_S * res, struct BenchSlot_S * slot, size_t bytes )
+{
+   slot->ptr = Bench_Alloc( res, bytes );
+   slot->bytes = (NULL == slot->ptr) ? 0 : bytes;
+}
+
+static void Bench_SlotFree( struct BenchResult_S * res, struct BenchSlot_S * slot )
+{
+   if ( NULL == slot->ptr )   return;
+   Bench_Free( res, slot->ptr, slot->bytes );
+   slot->ptr = NULL;
+   slot->bytes = 0;
+}
+
+static void Bench_FreeAllSlots( struct BenchResult_S * res, size_t num_of_slots )
+{
+   for ( size_t i = 0; i < num_of_slots; i++ )   Bench_SlotFree( res, &BenchSlots[i] );
+}
+
+/***************************** Synthetic Workloads ****************************/
+
+static void Bench_Lifo( struct BenchResult_S * res )
+{
+   // Stack-like: a random number of blocks, then all of them freed in reverse
+   while ( res->ops < BENCH_OPS )
+   {
+      uint32_t depth = 1u + (Bench_Rand( res ) % BENCH_SLOTS);
+      for ( uint32_t i = 0; i < depth; i++ )
+      {
+         Bench_SlotAlloc( res, &BenchSlots[i], Bench_RandSize( res ) );
+      }
+      for ( uint32_t i = depth; i-- > 0; )
+      {
+         Bench_SlotFree( res, &BenchSlots[i] );
+      }
+   }
+}
+
+static void Bench_Fifo( struct BenchResult_S * res )
+{
+   // Queue-like: the oldest block is freed to make way for the next
+   for ( uint32_t i = 0; i < BENCH_SLOTS; i++ )
+   {
+      Bench_SlotAlloc( res, &BenchSlots[i], Bench_RandSize( res ) );
+   }
+   uint32_t oldest = 0;
+   while ( res->ops < BENCH_OPS )
+   {
+      Bench_SlotFree( res, &BenchSlots[oldest] );
+      Bench_SlotAlloc( res, &BenchSlots[oldest], Bench_RandSize( res ) );
+      oldest = (oldest + 1u) % BENCH_SLOTS;
+   }
+   Bench_FreeAllSlots( res, BENCH_SLOTS );
+}
+
+static void Bench_Churn( struct BenchResult_S * res )
+{
+   // Blocks of random sizes come and go in no particular order
+   while ( res->ops < BENCH_OPS )
+   {
+      struct BenchSlot_S * slot = &BenchSlots[ Bench_Rand( res ) % BENCH_SLOTS ];
+      if ( NULL == slot->ptr )
+      {
+         Bench_SlotAlloc( res, slot, Bench_RandSize( res ) );
+      }
+      else
+      {
+         Bench_SlotFree( res, slot );
+      }
+   }
+   Bench_FreeAllSlots( res, BENCH_SLOTS );
+}
+
+static void Bench_FixedSize( struct BenchResult_S * res )
+{
+   // Churn of objects all of one constant size, through the general alloc
+   while ( res->ops < BENCH_OPS )
+   {
+      struct BenchSlot_S * slot = &BenchSlots[ Bench_Rand( res ) % BENCH_SLOTS ];
+      if ( NULL == slot->ptr )
+      {
+         Bench_SlotAlloc( res, slot, BENCH_FIXED_BYTES );
+      }
+      else
+      {
+         Bench_SlotFree( res, slot );
+      }
+   }
+   Bench_FreeAllSlots( res, BENCH_SLOTS );
+}
+
+static void Bench_FixedSizeFast( struct BenchResult_S * res )
+{
+   // The same churn, through the size-class fast path for the constant size
+   while ( res->ops < BENCH_OPS )
+   {
+      struct BenchSlot_S * slot = &BenchSlots[ Bench_Rand( res ) % BENCH_SLOTS ];
+      if ( NULL == slot->ptr )
+      {
+         slot->ptr = Bench_AllocFixed( res );
+         slot->bytes = (NULL == slot->ptr) ? 0 : BENCH_FIXED_BYTES;
+      }
+      else
+      {
+         Bench_SlotFree( res, slot );
+      }
+   }
+   Bench_FreeAllSlots( res, BENCH_SLOTS );
+}
+
+#ifdef BENCH_THREADS
+
+// Blocks go from the producer to the consumer through a single-producer,
+// single-consumer ring, so that every free is a cross-thread one.
+#define BENCH_RING_LEN 64u
+
+struct BenchRing_S
+{
+   struct BenchSlot_S slots[BENCH_RING_LEN];
+   uint32_t head; // Written by the producer only
+   uint32_t tail; // Written by the consumer only
+   bool done;
+};
+
+static struct BenchRing_S BenchRing;
+
+/**
+ * @brief The two sides of the threaded producer/consumer workload.
+ */
+static void * Bench_Producer( void * arg );
+static void * Bench_Consumer( void * arg );
+
+static void * Bench_Producer( void * arg )
+{
+   struct BenchResult_S * res = arg;
+   while ( res->ops < (BENCH_OPS / 2u) )
+   {
+      uint32_t head = BenchRing.head;
+      if ( (head - __atomic_load_n( &BenchRing.tail, __ATOMIC_ACQUIRE )) == BENCH_RING_LEN )   continue;
+
+      struct BenchSlot_S * slot = &BenchRing.slots[ head % BENCH_RING_LEN ];
+      Bench_SlotAlloc( res, slot, Bench_RandSize( res ) );
+      if ( NULL != slot->ptr )   __atomic_store_n( &BenchRing.head, head + 1u, __ATOMIC_RELEASE );
+   }
+   __atomic_store_n( &BenchRing.done, true, __ATOMIC_RELEASE );
+   StaticArrayCacheFlush();
+   return NULL;
+}
+
+static void * Bench_Consumer( void * arg )
+{
+   struct BenchResult_S * res = arg;
+   for ( ;; )
+   {
+      bool done = __atomic_load_n( &BenchRing.done, __ATOMIC_ACQUIRE );
+      uint32_t tail = BenchRing.tail;
+      if ( tail == __atomic_load_n( &BenchRing.head, __ATOMIC_ACQUIRE ) )
+      {
+         if ( done )   break;
+         continue;
+      }
+      Bench_SlotFree( res, &BenchRing.slots[ tail % BENCH_RING_LEN ] );
+      __atomic_store_n( &BenchRing.tail, tail + 1u, __ATOMIC_RELEASE );
+   }
+   StaticArrayCacheFlush();
+   return NULL;
+}
+
+static void Bench_ProducerConsumer( struct BenchResult_S * res )
+{
+   static struct BenchResult_S consumer_res;
+   memset( &BenchRing, 0, sizeof(BenchRing) );
+   memset( &consumer_res, 0, sizeof(consumer_res) );
+
+   pthread_t producer;
+   pthread_t consumer;
+   if ( (0 != pthread_create( &consumer, NULL, Bench_Consumer, &consumer_res )) ||
+        (0 != pthread_create( &producer, NULL, Bench_Producer, res )) )
+   {
+      fprintf( stderr, "Could not start the producer/consumer threads\n" );
+      exit( 1 );
+   }
+   (void)pthread_join( producer, NULL );
+   (void)pthread_join( consumer, NULL );
+
+   Bench_Merge( res, &consumer_res );
+}
+
+#else
+
+static void Bench_ProducerConsumer( struct BenchResult_S * res )
+{
+   // Bursts of messages, drained in order by a consumer that may lag behind
+   uint32_t head = 0;
+   uint32_t tail = 0;
+   while ( res->ops < BENCH_OPS )
+   {
+      for ( uint32_t burst = 1u + (Bench_Rand( res ) % 16u);
+            (burst > 0) && ((head - tail) < BENCH_SLOTS); burst-- )
+      {
+         Bench_SlotAlloc( res, &BenchSlots[ head % BENCH_SLOTS ], Bench_RandSize( res ) );
+         head++;
+      }
+      for ( uint32_t drain = 1u + (Bench_Rand( res ) % 16u);
+            (drain > 0) && (tail != head); drain-- )
+      {
+         Bench_SlotFree( res, &BenchSlots[ tail % BENCH_SLOTS ] );
+         tail++;
+      }
+   }
+   Bench_FreeAllSlots( res, BENCH_SLOTS );
+}
+
+#endif // BENCH_THREADS
+
+static void Bench_ReallocGrowth( struct BenchResult_S * res )
+{
+   // A few buffers, each grown by half again until it is big enough (or no
+   // longer can be), then dropped and started over
+   const uint32_t num_of_bufs = 8u;
+   while ( res->ops < BENCH_OPS )
+   {
+      struct BenchSlot_S * slot = &BenchSlots[ Bench_Rand( res ) % num_of_bufs ];
+      if ( NULL == slot->ptr )
+      {
+         Bench_SlotAlloc( res, slot, 8u );
+         continue;
+      }
+
+      size_t bytes = slot->bytes + (slot->bytes / 2u) + 1u;
+      if ( (bytes > BENCH_GROW_MAX) || !Bench_Realloc( res, slot, bytes ) )
+      {
+         Bench_SlotFree( res, slot );
+      }
+   }
+   Bench_FreeAllSlots( res, num_of_bufs );
+}
+
+#ifdef BENCH_WCET
+
+// Pointers to every block of the arena, when it is taken as the smallest size
+#define BENCH_WCET_MAX_BLOCKS ( VEC_ARRAY_ARENA_SIZE / SMALLEST_BLOCK_SIZE )
+typedef char Bench_WcetNeedsTwoLargestBlocks[ (VEC_ARRAY_ARENA_SIZE >= (2 * LARGEST_BLOCK_SIZE)) ? 1 : -1 ];
+
+static void * BenchWcetBlocks[BENCH_WCET_MAX_BLOCKS];
+static size_t BenchWcetNumOfBlocks;
+
+// Offset of the last largest block that fits in the pool
+#define BENCH_WCET_LAST_LARGEST \
+   ( ((ArrayArena.pool_size / LARGEST_BLOCK_SIZE) - 1u) * LARGEST_BLOCK_SIZE )
+
+static void Bench_WcetFill(void)
+{
+   BenchWcetNumOfBlocks = 0;
+   while ( BenchWcetNumOfBlocks < BENCH_WCET_MAX_BLOCKS )
+   {
+      void * ptr = StaticArrayAlloc( 1u );
+      if ( NULL == ptr )   break;
+      memset( ptr, 0, 1u ); // So that no page is touched for the first time while timed (on a host)
+      BenchWcetBlocks[BenchWcetNumOfBlocks++] = ptr;
+   }
+}
+
+static void Bench_WcetRelease( size_t offset, size_t len )
+{
+   for ( size_t i = 0; i < BenchWcetNumOfBlocks; i++ )
+   {
+      if ( NULL == BenchWcetBlocks[i] )   continue;
+      size_t blk_offset = (size_t)((uint8_t *)BenchWcetBlocks[i] - ArrayArena.pool);
+      if ( (blk_offset < offset) || (blk_offset >= (offset + len)) )   continue;
+
+      StaticArrayFree( BenchWcetBlocks[i] );
+      BenchWcetBlocks[i] = NULL;
+   }
+}
+
+static void Bench_WcetDrain(void)
+{
+   Bench_WcetRelease( 0, ArrayArena.pool_size );
+   BenchWcetNumOfBlocks = 0;
+}
+
+static void Bench_WcetAllocSplit( struct BenchResult_S * res )
+{
+   // The last largest block is the only free block left, so the smallest
+   // request has to look at every size, then split it all the way down
+   Bench_WcetFill();
+   Bench_WcetRelease( BENCH_WCET_LAST_LARGEST, LARGEST_BLOCK_SIZE );
+   for ( uint32_t i = 0; i < BENCH_WCET_REPS; i++ )
+   {
+      void * ptr = Bench_Alloc( res, 1u );
+      if ( NULL == ptr )   break;
+      StaticArrayFree( ptr );
+      BENCH_LIVE_SUB( 1u );
+   }
+   Bench_WcetDrain();
+}
+
+static void Bench_WcetFreeMerge( struct BenchResult_S * res )
+{
+   // ...and freeing that block merges it all the way back up
+   Bench_WcetFill();
+   Bench_WcetRelease( BENCH_WCET_LAST_LARGEST, LARGEST_BLOCK_SIZE );
+   for ( uint32_t i = 0; i < BENCH_WCET_REPS; i++ )
+   {
+      void * ptr = StaticArrayAlloc( 1u );
+      if ( NULL == ptr )   break;
+      BENCH_LIVE_ADD( 1u );
+      Bench_Free( res, ptr, 1u );
+   }
+   Bench_WcetDrain();
+}
+
+static void Bench_WcetAllocSearch( struct BenchResult_S * res )
+{
+   // The only free block is the last block of the smallest size, i.e., the
+   // last bit of the longest bitmap (which a scan would get to last)
+   Bench_WcetFill();
+   if ( BenchWcetNumOfBlocks > 0 )
+   {
+      size_t last = 0;
+      for ( size_t i = 1; i < BenchWcetNumOfBlocks; i++ )
+      {
+         if ( (uintptr_t)BenchWcetBlocks[i] > (uintptr_t)BenchWcetBlocks[last] )   last = i;
+      }
+      StaticArrayFree( BenchWcetBlocks[last] );
+      BenchWcetBlocks[last] = NULL;
+      for ( uint32_t i = 0; i < BENCH_WCET_REPS; i++ )
+      {
+         void * ptr = Bench_Alloc( res, 1u );
+         if ( NULL == ptr )   break;
+         StaticArrayFree( ptr );
+         BENCH_LIVE_SUB( 1u );
+      }
+   }
+   Bench_WcetDrain();
+}
+
+static void Bench_WcetReallocMove( struct BenchResult_S * res )
+{
+   // A block that fills the lower part of the second to last largest block,
+   // grown to a largest block while the rest of that one is taken, can be
+   // neither resized in place nor merged /w, so it is copied into the last.
+   // The sizes are what the blocks hold, i.e., less the overhead of each.
+#ifdef ARRAY_ARENA_INTERMEDIATE_SIZES
+   const size_t head_blk_bytes = (LARGEST_BLOCK_SIZE / 2u) + (LARGEST_BLOCK_SIZE / 4u);
+#else
+   const size_t head_blk_bytes = LARGEST_BLOCK_SIZE / 2u;
+#endif
+   const size_t head_bytes = head_blk_bytes - ARRAY_ARENA_BLOCK_OVERHEAD;
+   const size_t tail_bytes = (LARGEST_BLOCK_SIZE - head_blk_bytes) - ARRAY_ARENA_BLOCK_OVERHEAD;
+   Bench_WcetFill();
+   Bench_WcetRelease( BENCH_WCET_LAST_LARGEST - LARGEST_BLOCK_SIZE, 2u * LARGEST_BLOCK_SIZE );
+   for ( uint32_t i = 0; i < BENCH_WCET_REPS; i++ )
+   {
+      struct BenchSlot_S slot = { .ptr = StaticArrayAlloc( head_bytes ), .bytes = head_bytes };
+      void * tail = StaticArrayAlloc( tail_bytes );
+      if ( (NULL == slot.ptr) || (NULL == tail) )
+      {
+         StaticArrayFree( slot.ptr );
+         StaticArrayFree( tail );
+         break;
+      }
+      BENCH_LIVE_ADD( head_bytes );
+
+      (void)Bench_Realloc( res, &slot, ARRAY_ARENA_MAX_CLASS_REQ );
+      StaticArrayFree( slot.ptr );
+      StaticArrayFree( tail );
+      BENCH_LIVE_SUB( slot.bytes );
+   }
+   Bench_WcetDrain();
+}
+
+static void Bench_RunWcet( const char * name, BenchWorkload_T workload )
+{
+   const struct BenchResult_S * res = Bench_Run( name, workload, BENCH_SEED );
+   printf( "   worst case of %" PRIu32 " ticks over %" PRIu32 " calls (%" PRIu32 " failed)\n",
+           res->max_ticks, res->ops, res->fails );
+
+   // A path that failed (or could not be set up every time) was not the one
+   // meant to be timed, so its max is not a worst case of anything
+   if ( (res->fails > 0) || (res->ops < BENCH_WCET_REPS) )
+   {
+      printf( "   INVALID: the worst-case path was not taken every time!\n" );
+      BenchWcetInvalid = true;
+   }
+}
+
+#endif // BENCH_WCET
+
+static const struct BenchResult_S * Bench_Run( const char * name, BenchWorkload_T workload, uint32_t seed )
+{
+   static struct BenchResult_S res;
+   memset( &res, 0, sizeof(res) );
+   res.rng = (0 == seed) ? 1u : seed;
+
+#ifdef ARRAY_ARENA_SCHEME_BUMP
+   StaticArrayArenaReset();
+#endif
+   BenchLiveBytes = 0;
+
+   workload( &res );
+
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   StaticArrayCacheFlush();
+#endif
+   Bench_Print( name, &res );
+
+#ifndef ARRAY_ARENA_SCHEME_BUMP
+   // A bump arena only gets back what was freed in LIFO order, hence the reset
+   if ( Bench_FreeBytes() != BenchPoolBytes )
+   {
+      printf( "   %" PRIu32 " bytes were not handed back to the arena!\n",
+              (uint32_t)(BenchPoolBytes - Bench_FreeBytes()) );
+      BenchLeaked = true;
+   }
+#endif
+   return &res;
+}
+
+/******************************** Trace Replay ********************************/
+
+#ifndef BENCH_BARE_METAL
+
+enum BenchOpType
+{
+   BENCH_OP_ALLOC,
+   BENCH_OP_REALLOC,
+   BENCH_OP_FREE,
+   BENCH_OP_PROBE, // An alloc that failed when traced: freed again right away if granted now
+};
+
+struct BenchOp_S
+{
+   uint8_t type;
+   uint16_t slot;
+   uint32_t bytes;
+};
+
+// Keys of the trace (ids, or offsets for telemetry) -> slots, by open
+// addressing. Only keys that are live are kept, so it never fills up.
+#define BENCH_KEY_MAP_LEN ( 2u * BENCH_TRACE_SLOTS )
+#define BENCH_NO_SLOT     UINT16_MAX
+
+struct BenchKeyMap_S
+{
+   uint64_t keys[BENCH_KEY_MAP_LEN];
+   uint16_t slots[BENCH_KEY_MAP_LEN];
+   uint16_t free_slots[BENCH_TRACE_SLOTS];
+   size_t num_of_free_slots;
+};
+
+// Must match enum ArrayArenaTelemType and struct ArrayArenaTelemRec_S of sara.c,
+// which are only there /w ARRAY_ARENA_TELEMETRY (and so may not be here)
+enum BenchTelemType
+{
+   BENCH_TELEM_ALLOC,
+   BENCH_TELEM_FREE,
+   BENCH_TELEM_FAIL,
+   BENCH_TELEM_SPLIT,
+   BENCH_TELEM_COALESCE,
+   BENCH_TELEM_MOVE,
+   BENCH_TELEM_INFO,
+   BENCH_TELEM_LOST,
+   BENCH_TELEM_TAG,
+};
+#define BENCH_TELEM_SYNC     0xA0u
+#define BENCH_TELEM_REC_SIZE 16u
+
+static struct BenchKeyMap_S BenchKeyMap;
+static struct BenchOp_S * BenchTraceOps;
+static size_t BenchTraceLen;
+static size_t BenchTraceCap;
+static uint32_t BenchTraceDropped; // Allocs beyond BENCH_TRACE_SLOTS live blocks
+
+/**
+ * @brief Key map helpers.
+ * @return The slot of key, or BENCH_NO_SLOT if key is not live (or, for
+ *         Bench_KeyAdd(), there are no slots left).
+ */
+static size_t   Bench_KeyFind( uint64_t key );
+static uint16_t Bench_KeyGet( uint64_t key );
+static uint16_t Bench_KeyAdd( uint64_t key );
+static uint16_t Bench_KeyRemove( uint64_t key );
+
+/**
+ * @brief Appends an op to the loaded trace.
+ */
+static void Bench_TraceAppend( enum BenchOpType type, uint16_t slot, uint32_t bytes );
+
+/**
+ * @brief Appends what an alloc, free, or move of a key turns into.
+ */
+static void Bench_TraceAlloc( uint64_t key, uint32_t bytes, bool is_realloc );
+static void Bench_TraceFree( uint64_t key );
+static void Bench_TraceMove( uint64_t old_key, uint64_t new_key );
+
+/**
+ * @brief Parsers of the two trace formats.
+ */
+static bool Bench_LoadTextTrace( FILE * f );
+static bool Bench_LoadTelemetryTrace( FILE * f );
+
+static size_t Bench_KeyFind( uint64_t key )
+{
+   // Keys are mixed (fibonacci hashing), because offsets are all multiples of the granule
+   size_t i = (size_t)( (key * 0x9E3779B97F4A7C15u) >> 40 ) % BENCH_KEY_MAP_LEN;
+   while ( (BenchKeyMap.slots[i] != BENCH_NO_SLOT) && (BenchKeyMap.keys[i] != key) )
+   {
+      i = (i + 1u) % BENCH_KEY_MAP_LEN;
+   }
+   return i;
+}
+
+static uint16_t Bench_KeyGet( uint64_t key )
+{
+   return BenchKeyMap.slots[ Bench_KeyFind( key ) ];
+}
+
+static uint16_t Bench_KeyAdd( uint64_t key )
+{
+   if ( 0 == BenchKeyMap.num_of_free_slots )   return BENCH_NO_SLOT;
+
+   size_t i = Bench_KeyFind( key );
+   BenchKeyMap.keys[i] = key;
+   BenchKeyMap.slots[i] = BenchKeyMap.free_slots[ --BenchKeyMap.num_of_free_slots ];
+   return BenchKeyMap.slots[i];
+}
+
+static uint16_t Bench_KeyRemove( uint64_t key )
+{
+   size_t i = Bench_KeyFind( key );
+   uint16_t slot = BenchKeyMap.slots[i];
+   if ( BENCH_NO_SLOT == slot )   return BENCH_NO_SLOT;
+
+   // Backward-shift deletion: pull later keys of the probe chain into the hole
+   BenchKeyMap.slots[i] = BENCH_NO_SLOT;
+   size_t hole = i;
+   for ( size_t j = (i + 1u) % BENCH_KEY_MAP_LEN;
+         BenchKeyMap.slots[j] != BENCH_NO_SLOT;
+         j = (j + 1u) % BENCH_KEY_MAP_LEN )
+   {
+      size_t home = (size_t)( (BenchKeyMap.keys[j] * 0x9E3779B97F4A7C15u) >> 40 ) % BENCH_KEY_MAP_LEN;
+      // Move it if its home is not in (hole, j]
+      bool stays = (hole <= j) ? ((home > hole) && (home <= j)) : ((home > hole) || (home <= j));
+      if ( stays )   continue;
+      BenchKeyMap.keys[hole] = BenchKeyMap.keys[j];
+      BenchKeyMap.slots[hole] = BenchKeyMap.slots[j];
+      BenchKeyMap.slots[j] = BENCH_NO_SLOT;
+      hole = j;
+   }
+   BenchKeyMap.free_slots[ BenchKeyMap.num_of_free_slots++ ] = slot;
+   return slot;
+}
+
+static void Bench_TraceAppend( enum BenchOpType type, uint16_t slot, uint32_t bytes )
+{
+   if ( BenchTraceLen == BenchTraceCap )
+   {
+      size_t cap = (0 == BenchTraceCap) ? 4096u : (2u * BenchTraceCap);
+      struct BenchOp_S * ops = realloc( BenchTraceOps, cap * sizeof(*ops) );
+      if ( NULL == ops )
+      {
+         fprintf( stderr, "Out of memory for the trace\n" );
+         exit( 1 );
+      }
+      BenchTraceOps = ops;
+      BenchTraceCap = cap;
+   }
+   BenchTraceOps[BenchTraceLen].type = (uint8_t)type;
+   BenchTraceOps[BenchTraceLen].slot = slot;
+   BenchTraceOps[BenchTraceLen].bytes = bytes;
+   BenchTraceLen++;
+}
+
+static void Bench_TraceAlloc( uint64_t key, uint32_t bytes, bool is_realloc )
+{
+   uint16_t slot = Bench_KeyGet( key );
+   if ( BENCH_NO_SLOT != slot )
+   {
+      if ( is_realloc )
+      {
+         Bench_TraceAppend( BENCH_OP_REALLOC, slot, bytes );
+         return;
+      }
+      // Allocated again /wout a free in between (e.g., a record went missing)
+      Bench_TraceFree( key );
+   }
+
+   slot = Bench_KeyAdd( key );
+   if ( BENCH_NO_SLOT == slot )
+   {
+      BenchTraceDropped++;
+      return;
+   }
+   Bench_TraceAppend( BENCH_OP_ALLOC, slot, bytes );
+}
+
+static void Bench_TraceFree( uint64_t key )
+{
+   uint16_t slot = Bench_KeyRemove( key );
+   if ( BENCH_NO_SLOT != slot )   Bench_TraceAppend( BENCH_OP_FREE, slot, 0 );
+}
+
+static void Bench_TraceMove( uint64_t old_key, uint64_t new_key )
+{
+   // The block keeps its slot, it is only known by a new offset
+   uint16_t slot = Bench_KeyRemove( old_key );
+   if ( BENCH_NO_SLOT == slot )   return;
+   BenchKeyMap.num_of_free_slots--; // Take the same slot straight back
+   size_t i = Bench_KeyFind( new_key );
+   BenchKeyMap.keys[i] = new_key;
+   BenchKeyMap.slots[i] = slot;
+}
+
+static bool Bench_LoadTextTrace( FILE * f )
+{
+   char line[256];
+   unsigned line_num = 0;
+   while ( NULL != fgets( line, sizeof(line), f ) )
+   {
+      line_num++;
+      char op[16];
+      char id[128];
+      unsigned long bytes = 0;
+      int fields = sscanf( line, "%15s %127s %lu", op, id, &bytes );
+      if ( (fields <= 0) || ('#' == op[0]) )   continue;
+
+      // FNV-1a of the id
+      uint64_t key = 0xCBF29CE484222325u;
+      for ( const char * c = id; (fields >= 2) && ('\0' != *c); c++ )
+      {
+         key = (key ^ (uint8_t)*c) * 0x100000001B3u;
+      }
+
+      bool is_alloc = (0 == strcmp( op, "alloc" ));
+      bool is_realloc = (0 == strcmp( op, "realloc" ));
+      if ( (is_alloc || is_realloc) && (3 == fields) && (bytes <= UINT32_MAX) )
+      {
+         Bench_TraceAlloc( key, (uint32_t)bytes, is_realloc );
+      }
+      else if ( (0 == strcmp( op, "free" )) && (2 == fields) )
+      {
+         Bench_TraceFree( key );
+      }
+      else
+      {
+         fprintf( stderr, "line %u: expected 'alloc <id> <bytes>', 'realloc <id> <bytes>', or 'free <id>'\n",
+                  line_num );
+         return false;
+      }
+   }
+   return true;
+}
+
+static bool Bench_LoadTelemetryTrace( FILE * f )
+{
+   // Records are taken to be from a little-endian target
+   uint8_t buf[4096];
+   size_t len = 0;
+   for ( ;; )
+   {
+      len += fread( &buf[len], 1u, sizeof(buf) - len, f );
+      if ( len < BENCH_TELEM_REC_SIZE )   break;
+
+      size_t i = 0;
+      while ( (len - i) >= BENCH_TELEM_REC_SIZE )
+      {
+         const uint8_t * rec = &buf[i];
+         uint8_t type = rec[0] & 0x0Fu;
+         if ( ((rec[0] & 0xF0u) != BENCH_TELEM_SYNC) || (type > (uint8_t)BENCH_TELEM_TAG) )
+         {
+            i++; // Resync on the next record start
+            continue;
+         }
+         uint32_t offset = (uint32_t)rec[8]  | ((uint32_t)rec[9]  << 8) | ((uint32_t)rec[10] << 16) | ((uint32_t)rec[11] << 24);
+         uint32_t arg    = (uint32_t)rec[12] | ((uint32_t)rec[13] << 8) | ((uint32_t)rec[14] << 16) | ((uint32_t)rec[15] << 24);
+         switch ( (enum BenchTelemType)type )
+         {
+            case BENCH_TELEM_ALLOC:
+               Bench_TraceAlloc( offset, arg, false );
+               break;
+            case BENCH_TELEM_FREE:
+               Bench_TraceFree( offset );
+               break;
+            case BENCH_TELEM_FAIL:
+               for ( uint32_t n = 0; n < offset; n++ )   Bench_TraceAppend( BENCH_OP_PROBE, 0, arg );
+               break;
+            case BENCH_TELEM_MOVE:
+               Bench_TraceMove( arg, offset );
+               break;
+            case BENCH_TELEM_SPLIT:
+            case BENCH_TELEM_COALESCE:
+            case BENCH_TELEM_INFO:
+            case BENCH_TELEM_LOST:
+            case BENCH_TELEM_TAG:
+            default:
+               break;
+         }
+         i += BENCH_TELEM_REC_SIZE;
+      }
+      memmove( buf, &buf[i], len - i );
+      len -= i;
+   }
+   return 0 == ferror( f );
+}
+
+static bool Bench_LoadTrace( const char * path )
+{
+   FILE * f = fopen( path, "rb" );
+   if ( NULL == f )   return false;
+
+   BenchTraceLen = 0;
+   BenchTraceDropped = 0;
+   for ( size_t i = 0; i < BENCH_KEY_MAP_LEN; i++ )   BenchKeyMap.slots[i] = BENCH_NO_SLOT;
+   for ( size_t i = 0; i < BENCH_TRACE_SLOTS; i++ )
+   {
+      BenchKeyMap.free_slots[i] = (uint16_t)(BENCH_TRACE_SLOTS - 1u - i);
+   }
+   BenchKeyMap.num_of_free_slots = BENCH_TRACE_SLOTS;
+
+   // Telemetry records all start /w the sync nibble, which no text line does
+   int first = fgetc( f );
+   bool ok = (EOF != first);
+   if ( ok )
+   {
+      (void)ungetc( first, f );
+      ok = ( ((unsigned)first & 0xF0u) == BENCH_TELEM_SYNC ) ? Bench_LoadTelemetryTrace( f )
+                                                                     : Bench_LoadTextTrace( f );
+   }
+   (void)fclose( f );
+
+   if ( BenchTraceDropped > 0 )
+   {
+      printf( "   (%" PRIu32 " allocs of %s left out, over %u blocks live)\n",
+              BenchTraceDropped, path, (unsigned)BENCH_TRACE_SLOTS );
+   }
+   return ok;
+}
+
+static void Bench_Replay( struct BenchResult_S * res )
+{
+   for ( size_t i = 0; i < BenchTraceLen; i++ )
+   {
+      const struct BenchOp_S * op = &BenchTraceOps[i];
+      struct BenchSlot_S * slot = &BenchSlots[op->slot];
+      switch ( (enum BenchOpType)op->type )
+      {
+         case BENCH_OP_ALLOC:
+            Bench_SlotAlloc( res, slot, op->bytes );
+            break;
+         case BENCH_OP_REALLOC:
+            // May have failed to allocate here, even though it did when traced
+            if ( NULL == slot->ptr )   Bench_SlotAlloc( res, slot, op->bytes );
+            else                       (void)Bench_Realloc( res, slot, op->bytes );
+            break;
+         case BENCH_OP_FREE:
+            Bench_SlotFree( res, slot );
+            break;
+         case BENCH_OP_PROBE:
+         {
+            void * ptr = Bench_Alloc( res, op->bytes );
+            if ( NULL != ptr )   Bench_Free( res, ptr, op->bytes );
+            break;
+         }
+         default:
+            break;
+      }
+   }
+   Bench_FreeAllSlots( res, BENCH_TRACE_SLOTS );
+}
+
+#endif // BENCH_BARE_METAL
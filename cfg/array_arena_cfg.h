@@ -6,7 +6,7 @@
  * @note This file can be generated by the scripts/discretize_arena.py script
  *       (manually run) or it can be manually modified as the user wishes.
  *
- * @date Sat, Jul 05, 2025 :: 09:50:50 AM 
+ * @date Wed, Oct 14, 2026 :: 10:06:17 AM 
  * @copyright MIT License
  */
 
@@ -16,6 +16,9 @@
 // Given the arena size: 15000 bytes, discretize_python.py allocates the bytes
 // as shown below:
 
+// The block sizes the lengths below are for (see sara.c).
+#define ARRAY_ARENA_BLOCK_SIZES(X) X(1024) X(512) X(256) X(128) X(64) X(32)
+
 #define BLOCKS_1024_LIST_INIT_LEN   3 // 3072 bytes
 #define BLOCKS_512_LIST_INIT_LEN    6 // 3072 bytes
 #define BLOCKS_256_LIST_INIT_LEN   12 // 3072 bytes
@@ -24,6 +27,75 @@
 #define BLOCKS_32_LIST_INIT_LEN     8 // 256 bytes
 //                                       24 byte gap
 
+// Free bitmaps of the layout above, so that the arena needs no run-time init.
+// If you modify the lengths above by hand, either re-run the script or delete
+// the tables below (through to the #endif) to fall back to run-time init.
+#define ARRAY_ARENA_CFG_HAS_INIT_TABLES
+#define ARRAY_ARENA_CFG_HAS_SUMMARY_TABLES
+#define ARRAY_ARENA_CFG_ARENA_SIZE      15000
+#define ARRAY_ARENA_CFG_SPACE_AVAILABLE 14976
+
+#define BLOCKS_1024_FREE_MAP_INIT \
+   { \
+      0x00000007u \
+   }
+#define BLOCKS_512_FREE_MAP_INIT \
+   { \
+      0x00000FC0u \
+   }
+#define BLOCKS_256_FREE_MAP_INIT \
+   { \
+      0xFF000000u, 0x0000000Fu \
+   }
+#define BLOCKS_128_FREE_MAP_INIT \
+   { \
+      0x00000000u, 0x00000000u, 0xFFFFFF00u, 0x00000001u \
+   }
+#define BLOCKS_64_FREE_MAP_INIT \
+   { \
+      0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, \
+      0x00000000u, 0x00000000u, 0xFFFFFFFCu, 0x0000003Fu \
+   }
+#define BLOCKS_32_FREE_MAP_INIT \
+   { \
+      0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, \
+      0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, \
+      0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, \
+      0x00000000u, 0x00000000u, 0x000FF000u \
+   }
+
+// Summaries of the bitmaps above, for ARRAY_ARENA_REALTIME (see sara.c).
+#define BLOCKS_1024_FREE_SUMMARY_INIT \
+   { \
+      0x00000001u \
+   }
+#define BLOCKS_1024_FREE_TOP_INIT 0x00000001u
+#define BLOCKS_512_FREE_SUMMARY_INIT \
+   { \
+      0x00000001u \
+   }
+#define BLOCKS_512_FREE_TOP_INIT 0x00000001u
+#define BLOCKS_256_FREE_SUMMARY_INIT \
+   { \
+      0x00000003u \
+   }
+#define BLOCKS_256_FREE_TOP_INIT 0x00000001u
+#define BLOCKS_128_FREE_SUMMARY_INIT \
+   { \
+      0x0000000Cu \
+   }
+#define BLOCKS_128_FREE_TOP_INIT 0x00000001u
+#define BLOCKS_64_FREE_SUMMARY_INIT \
+   { \
+      0x000000C0u \
+   }
+#define BLOCKS_64_FREE_TOP_INIT 0x00000001u
+#define BLOCKS_32_FREE_SUMMARY_INIT \
+   { \
+      0x00004000u \
+   }
+#define BLOCKS_32_FREE_TOP_INIT 0x00000001u
+
 
 #endif // _ARRAY_CFG_H_
 
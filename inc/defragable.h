@@ -1,4 +1,4 @@
-#ifdef DEFRAGABLE_TRAIT_H
+#ifndef DEFRAGABLE_TRAIT_H
 #define DEFRAGABLE_TRAIT_H
 
 #include <stdbool.h>
@@ -0,0 +1,565 @@
+/**
+ * @file sara.h
+ * @brief Public interface of the static array arena allocator (sara.c).
+ *
+ * sara.c is either built on its own, or into the translation unit that uses
+ * it, /w STATIC defined as static ahead of both (as the vector lib does), so
+ * that the compiler sees all of it at once. Config macros (ARRAY_ARENA_*) have
+ * to be the same for every translation unit that includes this.
+ *
+ * @copyright MIT License
+ */
+
+#ifndef SARA_H
+#define SARA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef STATIC
+#define STATIC
+#endif
+
+STATIC void StaticArrayPoolInit(void);
+STATIC bool StaticArrayPoolIsInitialized(void);
+
+STATIC struct Vector_S * StaticVectorArenaAlloc(void);
+STATIC void   StaticVectorArenaFree(const struct Vector_S *);
+STATIC bool   StaticVectorIsAlloc(const struct Vector_S *);
+
+STATIC void * StaticArrayAlloc(size_t);
+STATIC void * StaticArrayRealloc(void *, size_t);
+STATIC void   StaticArrayFree(const void *);
+STATIC bool   StaticArrayIsAlloc(const void *);
+
+// Arena objects. The StaticArray*() fcns all work on the default arena, which
+// is the statically allocated one of VEC_ARRAY_ARENA_SIZE bytes. Any number of
+// other arenas can be set up over buffers of the user's choosing (e.g., in DMA-
+// capable or tightly coupled memory), each wholly independent of the others.
+// Each StaticArray*() fcn has an ArrayArena*() counterpart that takes the arena
+// to work on as its first parameter, and otherwise behaves the same.
+struct ArrayArena_S;
+STATIC bool   ArrayArenaInit(struct ArrayArena_S *, void *, size_t);
+STATIC bool   ArrayArenaIsInitialized(const struct ArrayArena_S *);
+STATIC void * ArrayArenaAlloc(struct ArrayArena_S *, size_t);
+STATIC void * ArrayArenaRealloc(struct ArrayArena_S *, void *, size_t);
+STATIC void   ArrayArenaFree(struct ArrayArena_S *, const void *);
+STATIC bool   ArrayArenaIsAlloc(struct ArrayArena_S *, const void *);
+
+// Blocks by their offset into an arena's pool rather than by address (e.g., to
+// lay them out for a visualizer, or to keep in a persistent arena).
+#define ARRAY_ARENA_NO_OFFSET SIZE_MAX
+STATIC size_t ArrayArenaOffsetOf(const struct ArrayArena_S *, const void *);
+STATIC void * ArrayArenaAtOffset(const struct ArrayArena_S *, size_t);
+
+// Batches of same-size blocks (e.g., for a burst of packets), allocated or
+// freed in one pass. As many blocks of the batch as can be had are allocated,
+// and the count is returned; the rest of out[] is set to NULL. Blocks from a
+// batch may be freed singly, and singly allocated blocks freed in a batch.
+STATIC size_t StaticArrayAllocBatch(size_t, size_t, void * []);
+STATIC void   StaticArrayFreeBatch(void * const [], size_t);
+STATIC size_t ArrayArenaAllocBatch(struct ArrayArena_S *, size_t, size_t, void * []);
+STATIC void   ArrayArenaFreeBatch(struct ArrayArena_S *, void * const [], size_t);
+
+// Blocks aligned to a power of 2 of the caller's choosing (e.g., for DMA or SIMD).
+// The start of each pool is aligned to ARRAY_ARENA_POOL_ALIGNMENT if defined (for
+// a pointer otherwise). In the segregated free-lists scheme, every block is
+// aligned to its size relative to the start of the pool, so an aligned block is
+// simply a block of at least the alignment, and an alignment finer than the
+// pool's or coarser than the largest block cannot be had. Blocks stay aligned
+// across a resize so long as they are not shrunk below the alignment.
+//
+// With ARRAY_ARENA_CACHE_LINE_ISOLATION, no two blocks share a cache line of
+// ARRAY_ARENA_CACHE_LINE_SIZE bytes, so that the small blocks that threads on
+// different cores allocate do not falsely share lines. Requests smaller than a
+// line are granted a whole one, and pools are aligned to a line.
+STATIC void * StaticArrayAllocAligned(size_t, size_t);
+STATIC void * ArrayArenaAllocAligned(struct ArrayArena_S *, size_t, size_t);
+
+// Result-type counterparts of alloc, realloc, and free, for callers that need
+// to know why a request failed (e.g., to tell a request that can never be had
+// from one that might after some frees), and how many bytes they were granted,
+// so that the slack at the end of a block can be used /wout a realloc. A
+// request that fails leaves things as they were: an alloc gives a NULL ptr, and
+// a realloc leaves ptr and its block as they are. granted is optional; it is set
+// to how many bytes the block at *ptr may be used for afterwards (at least
+// req_bytes on success), or to 0 if there is no block (or no telling, for a
+// failed realloc in the bump allocator). Freeing NULL is ARRAY_ARENA_OK, as for
+// free(). The bump allocator cannot tell a double free from any other pointer
+// below its top, and never reports ARRAY_ARENA_FRAGMENTED.
+enum ArrayArenaStatus
+{
+   ARRAY_ARENA_OK = 0,
+   ARRAY_ARENA_TOO_LARGE,    // No block could hold req_bytes, however much were free
+   ARRAY_ARENA_OUT_OF_SPACE, // Too few bytes are free for the block req_bytes needs
+   ARRAY_ARENA_FRAGMENTED,   // Enough bytes are free, but not as a block of the size needed
+   ARRAY_ARENA_INVALID_PTR,  // ptr is not an allocated block of the arena
+   ARRAY_ARENA_DOUBLE_FREE,  // ptr is in free memory of the arena (e.g., it was freed already)
+   NUM_OF_ARRAY_ARENA_STATUSES
+};
+STATIC enum ArrayArenaStatus StaticArrayTryAlloc(size_t, void **, size_t *);
+STATIC enum ArrayArenaStatus StaticArrayTryRealloc(void **, size_t, size_t *);
+STATIC enum ArrayArenaStatus StaticArrayTryFree(const void *);
+STATIC enum ArrayArenaStatus ArrayArenaTryAlloc(struct ArrayArena_S *, size_t, void **, size_t *);
+STATIC enum ArrayArenaStatus ArrayArenaTryRealloc(struct ArrayArena_S *, void **, size_t, size_t *);
+STATIC enum ArrayArenaStatus ArrayArenaTryFree(struct ArrayArena_S *, const void *);
+
+// Allocator statistics (segregated free-lists only), compiled in /w
+// ARRAY_ARENA_STATS. Allocs, frees, failures, splits, merges, and live blocks
+// are counted per block size (that of the head block, for trimmed blocks and
+// runs). /w ARRAY_ARENA_STATS_CYCLES as well, how many cycles each alloc and
+// free took (by ARRAY_ARENA_CYCLE_COUNT()) is binned into a histogram. Save
+// for the ones that track what is live, the counters only ever count up, so
+// the activity over a stretch of time is the difference of two snapshots.
+#ifdef ARRAY_ARENA_STATS
+struct ArrayArenaStats_S;
+STATIC void StaticArrayGetStats(struct ArrayArenaStats_S *);
+STATIC void ArrayArenaGetStats(const struct ArrayArena_S *, struct ArrayArenaStats_S *);
+#endif
+
+// Per-owner tagging (segregated free-lists only), compiled in /w
+// ARRAY_ARENA_TAGS, to find out who holds what (and who leaks). An alloc may be
+// given a tag below ARRAY_ARENA_MAX_TAGS (e.g., the id of the subsystem or the
+// call site it is for, in a numbering of the application's), and how many
+// blocks and bytes each tag holds, and the most bytes it has held, is kept in
+// a table of its own. Blocks carry no header for it: the tag of each lives in
+// a side table of one byte per granule, next to the granule table. Allocs
+// that are not given one are ARRAY_ARENA_UNTAGGED, a block keeps its tag when
+// it is resized or relocated, and ArrayArenaSetTag() hands it over to another
+// owner. /w ARRAY_ARENA_VIZ, the layout entries of allocated blocks carry their
+// tag, and /w ARRAY_ARENA_TELEMETRY, each drain sends a TAG record for every
+// tag whose holdings changed since the last one.
+#ifdef ARRAY_ARENA_TAGS
+#ifndef ARRAY_ARENA_MAX_TAGS
+#define ARRAY_ARENA_MAX_TAGS 16
+#endif
+typedef uint8_t ArrayArenaTag_T;
+#define ARRAY_ARENA_UNTAGGED ((ArrayArenaTag_T)0)
+struct ArrayArenaTagStats_S
+{
+   size_t live_blocks; // Blocks the tag presently holds
+   size_t live_bytes; // Bytes of those blocks
+   size_t peak_bytes; // High-water mark of live_bytes
+};
+STATIC void * StaticArrayAllocTagged(size_t, ArrayArenaTag_T);
+STATIC bool   StaticArraySetTag(const void *, ArrayArenaTag_T);
+STATIC bool   StaticArrayGetTagStats(ArrayArenaTag_T, struct ArrayArenaTagStats_S *);
+STATIC void * ArrayArenaAllocTagged(struct ArrayArena_S *, size_t, ArrayArenaTag_T);
+STATIC bool   ArrayArenaSetTag(struct ArrayArena_S *, const void *, ArrayArenaTag_T);
+STATIC bool   ArrayArenaGetTagStats(const struct ArrayArena_S *, ArrayArenaTag_T, struct ArrayArenaTagStats_S *);
+#endif
+
+// Layout export for visualizers (the Vizable trait), compiled in /w
+// ARRAY_ARENA_VIZ. Each export lists the blocks of the part of the arena that
+// has changed since the last one as (offset, length, state), /w neighbours in
+// the same state merged into one entry. At most max_entries are written, and
+// whatever does not fit is left for the next export, so an export never takes
+// longer than its bound and the arena is never copied. The first export (and
+// the first one after ArrayArenaVizRefresh()) covers the whole arena.
+#ifdef ARRAY_ARENA_VIZ
+#include "vizable.h"
+STATIC size_t StaticArrayVizLayout(struct ArenaVizList *, size_t);
+STATIC size_t StaticArrayVizSize(void);
+STATIC size_t ArrayArenaVizLayout(struct ArrayArena_S *, struct ArenaVizList *, size_t);
+STATIC void   ArrayArenaVizRefresh(struct ArrayArena_S *);
+#endif
+
+// Telemetry stream (segregated free-lists only), compiled in /w
+// ARRAY_ARENA_TELEMETRY. Each alloc, free, failed request, split, merge, and
+// relocation is written as one fixed-size binary record into a lock-free ring,
+// and that one write is all the allocator does about it. A background task
+// drains the ring through a sink of the application's (e.g., a send() on a
+// non-blocking UDP/TCP socket, or SWO via ArrayArenaTelemetryItmSink()) when
+// it gets around to it. When the ring is full, records are dropped (and the
+// loss is reported in the stream) rather than waited on. The records are in
+// the target's byte order. scripts/decode_telemetry.py decodes, replays, and
+// summarizes the stream, live or from a saved trace.
+#ifdef ARRAY_ARENA_TELEMETRY
+enum ArrayArenaTelemType
+{
+   ARRAY_ARENA_TELEM_ALLOC = 0, // offset: block handed out; arg: bytes requested
+   ARRAY_ARENA_TELEM_FREE,      // offset: block handed back; arg: bytes it was granted
+   ARRAY_ARENA_TELEM_FAIL,      // offset: how many blocks could not be had (> 1 for batches); arg: bytes requested
+   ARRAY_ARENA_TELEM_SPLIT,     // offset: block split in halves; arg: its size
+   ARRAY_ARENA_TELEM_COALESCE,  // offset: block two buddies were merged into; arg: its size
+   ARRAY_ARENA_TELEM_MOVE,      // offset: where the block was moved to (by compaction); arg: where it was
+   ARRAY_ARENA_TELEM_INFO,      // blk_sz: a block size idx; offset: size of the pool; arg: that block size
+   ARRAY_ARENA_TELEM_LOST,      // arg: how many records were dropped since the last drain
+   ARRAY_ARENA_TELEM_TAG,       // blk_sz: a tag (ARRAY_ARENA_TAGS); offset: bytes it holds; arg: the most it has held
+};
+#define ARRAY_ARENA_TELEM_SYNC     0xA0u // High nibble of every record's type byte, to find record boundaries by
+#define ARRAY_ARENA_TELEM_NO_SIZE  0xFFu // blk_sz of records that are not about a block
+
+struct ArrayArenaTelemRec_S
+{
+   uint8_t type; // ARRAY_ARENA_TELEM_SYNC | enum ArrayArenaTelemType
+   uint8_t blk_sz; // Block size idx of the (head) block, or ARRAY_ARENA_TELEM_NO_SIZE
+   uint16_t seq; // Position of the record in the stream, counting from 1 (mod 2^16); gaps are lost records
+   uint32_t timestamp; // ARRAY_ARENA_TELEMETRY_TIMESTAMP() at the time of the event
+   uint32_t offset; // Offset into the pool (see enum ArrayArenaTelemType)
+   uint32_t arg;
+};
+
+// Sinks are handed whole records, and return how many of them they took, which
+// may be fewer than were handed over (e.g., if the socket would block). The
+// rest are handed over again on the next drain.
+typedef size_t (*ArrayArenaTelemSink_T)(void * ctx, const struct ArrayArenaTelemRec_S recs[], size_t n);
+STATIC size_t StaticArrayTelemetryDrain(ArrayArenaTelemSink_T, void *);
+STATIC size_t ArrayArenaTelemetryDrain(struct ArrayArena_S *, ArrayArenaTelemSink_T, void *);
+STATIC void   ArrayArenaTelemetryRefresh(struct ArrayArena_S *);
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+STATIC size_t ArrayArenaTelemetryItmSink(void *, const struct ArrayArenaTelemRec_S [], size_t);
+#endif
+#endif
+
+// Allocation scheme selection. Exactly one scheme is compiled in:
+//    - ARRAY_ARENA_SCHEME_BUMP: bump/stack allocation. Allocating is a pointer
+//      bump, frees are LIFO (via the marks below), and a reset is O(1). Suited
+//      to scratch memory that is set up and then dropped all at once.
+//    - default: segregated free-lists of power-of-2 sizes /w buddy splitting
+//      and coalescing, for arbitrarily ordered alloc/free.
+#ifdef ARRAY_ARENA_SCHEME_BUMP
+typedef size_t ArrayArenaMark_T;
+STATIC ArrayArenaMark_T StaticArrayArenaMark(void);
+STATIC void StaticArrayArenaRewind(ArrayArenaMark_T);
+STATIC void StaticArrayArenaReset(void);
+STATIC ArrayArenaMark_T ArrayArenaMark(const struct ArrayArena_S *);
+STATIC void ArrayArenaRewind(struct ArrayArena_S *, ArrayArenaMark_T);
+STATIC void ArrayArenaReset(struct ArrayArena_S *);
+#endif
+
+// Compaction (segregated free-lists only). Blocks that have been marked movable
+// may be relocated toward the start of the arena to rebuild larger free blocks.
+// Whenever one is, the relocation callback is told where it went, so that the
+// application can update its references to it.
+#ifdef ARRAY_ARENA_DEFRAG
+#include "defragable.h"
+typedef void (*ArrayArenaRelocateCb_T)(void * old_ptr, void * new_ptr, void * ctx);
+STATIC void StaticArraySetRelocateCb(ArrayArenaRelocateCb_T, void *);
+STATIC bool StaticArraySetMovable(const void *, bool);
+STATIC bool StaticArrayIsFragmented(void);
+STATIC bool StaticArrayDefragStep(size_t, size_t);
+STATIC bool StaticArrayDefragment(void);
+STATIC void ArrayArenaSetRelocateCb(struct ArrayArena_S *, ArrayArenaRelocateCb_T, void *);
+STATIC bool ArrayArenaSetMovable(struct ArrayArena_S *, const void *, bool);
+STATIC bool ArrayArenaIsFragmented(const struct ArrayArena_S *);
+STATIC bool ArrayArenaDefragStep(struct ArrayArena_S *, size_t, size_t);
+#endif
+
+// Lazy coalescing (segregated free-lists only), compiled in /w
+// ARRAY_ARENA_LAZY_COALESCE. A free only marks the block free in the list of
+// its own size, so that it is a few bit operations, and the next alloc of that
+// size has the block straight back. Freed blocks are merged /w their buddies
+// later, in a pass over the free bitmaps that finds a word's worth of buddy
+// pairs at a time: whenever an alloc finds nothing free of its size or larger,
+// and whenever ArrayArenaCoalesce() is called (e.g., from an idle task). The
+// pass only looks at the lists that were freed into since the last one, and
+// never at the pool. The Defragable trait (ArrayArenaDefragable) is then there
+// for the default arena /wout ARRAY_ARENA_DEFRAG too: IsFragmented() is also
+// true while there are freed blocks left to merge, and Defragment() merges
+// them before it compacts anything. A realloc that grows a block merges just
+// the free blocks it would grow over, so that it still stays in place whenever
+// it would have /w eager coalescing.
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+#include "defragable.h"
+STATIC bool StaticArrayCoalesce(void);
+STATIC bool ArrayArenaCoalesce(struct ArrayArena_S *);
+#ifndef ARRAY_ARENA_DEFRAG
+STATIC bool StaticArrayIsFragmented(void);
+STATIC bool StaticArrayDefragment(void);
+STATIC bool ArrayArenaIsFragmented(const struct ArrayArena_S *);
+#endif
+#endif
+
+// Handle-based allocation (segregated free-lists only). Rather than a pointer,
+// the block is referred to by a small integer handle, which is turned into a
+// pointer only for as long as the handle is locked. Unlocked blocks are free to
+// be moved (by compaction or by a realloc), so that when they are, only the
+// handle table needs to be updated. The null handle is never a valid one.
+#ifdef ARRAY_ARENA_HANDLES
+#ifndef ARRAY_ARENA_MAX_HANDLES
+#define ARRAY_ARENA_MAX_HANDLES 32
+#endif
+#if ( ARRAY_ARENA_MAX_HANDLES <= UINT8_MAX )
+typedef uint8_t ArrayArenaHandle_T;
+#else
+typedef uint16_t ArrayArenaHandle_T;
+#endif
+#define ARRAY_ARENA_NULL_HANDLE ((ArrayArenaHandle_T)0)
+STATIC ArrayArenaHandle_T StaticArrayHandleAlloc(size_t);
+STATIC bool   StaticArrayHandleRealloc(ArrayArenaHandle_T, size_t);
+STATIC void   StaticArrayHandleFree(ArrayArenaHandle_T);
+STATIC void * StaticArrayHandleLock(ArrayArenaHandle_T);
+STATIC void   StaticArrayHandleUnlock(ArrayArenaHandle_T);
+STATIC ArrayArenaHandle_T ArrayArenaHandleAlloc(struct ArrayArena_S *, size_t);
+STATIC bool   ArrayArenaHandleRealloc(struct ArrayArena_S *, ArrayArenaHandle_T, size_t);
+STATIC void   ArrayArenaHandleFree(struct ArrayArena_S *, ArrayArenaHandle_T);
+STATIC void * ArrayArenaHandleLock(struct ArrayArena_S *, ArrayArenaHandle_T);
+STATIC void   ArrayArenaHandleUnlock(struct ArrayArena_S *, ArrayArenaHandle_T);
+#endif
+
+// Thread-safe mode (segregated free-lists only). Each thread keeps a small
+// cache of free blocks of each size, so that most allocs and frees never touch
+// the shared free lists. The caches are refilled from and drained back to them
+// in batches, under a short critical section. A block freed by some other
+// thread than the one it was allocated by is handed back to the allocating
+// thread's cache lock-free. A thread that is done /w the arena should flush
+// its cache, or the blocks in it stay out of circulation. Only the default
+// arena has caches; the others are simply locked around every call.
+#ifdef ARRAY_ARENA_THREAD_SAFE
+STATIC void StaticArrayCacheFlush(void);
+#endif
+
+// Hardened mode (segregated free-lists only), compiled in /w
+// ARRAY_ARENA_HARDENED, to catch misuse of the arena in the field rather than
+// only in a debug build. All of its checks are O(1):
+//    - Frees (and reallocs) of pointers that are not allocated blocks are
+//      told apart, by the free bitmaps, into double frees (the pointer is in
+//      free memory) and bad frees (anything else), and are refused. A double
+//      free after the block has been handed out again cannot be told from a
+//      valid free, as blocks carry no header to tell them apart by.
+//    - The last word of each block is a canary (keyed by the block's offset),
+//      which is checked when the block is handed back, to catch writes past
+//      the end of what was asked for. It takes that many bytes more out of
+//      each block (so a request of exactly a block size takes the next one up).
+// /w ARRAY_ARENA_HARDENED_POISON as well, freed blocks are filled /w
+// ARRAY_ARENA_POISON_BYTE, and the first and last word of each block are
+// checked for it when the block is handed out again, to catch writes to a
+// block after it was freed. The fill makes a free O(block size), so it costs
+// more than the rest of this. Faults are counted per arena, and reported to
+// the fault callback, if one is set. The arena's own tables are kept apart
+// from the blocks, so it goes on working whatever the blocks were written /w.
+#ifdef ARRAY_ARENA_HARDENED
+enum ArrayArenaFault
+{
+   ARRAY_ARENA_FAULT_BAD_FREE = 0, // ptr is neither an allocated block nor free memory of the arena
+   ARRAY_ARENA_FAULT_DOUBLE_FREE,  // ptr is in free memory (e.g., it was freed already)
+   ARRAY_ARENA_FAULT_CANARY,       // The canary at the end of the block at ptr was overwritten
+   ARRAY_ARENA_FAULT_POISON,       // The free block at ptr was written to while it was free
+   ARRAY_ARENA_FAULT_BAD_HANDLE,   // A handle that is not in use (e.g., it was freed already) was freed; ptr is NULL
+   NUM_OF_ARRAY_ARENA_FAULTS
+};
+typedef void (*ArrayArenaFaultCb_T)(enum ArrayArenaFault fault, const void * ptr, void * ctx);
+STATIC void   StaticArraySetFaultCb(ArrayArenaFaultCb_T, void *);
+STATIC size_t StaticArrayFaultCount(enum ArrayArenaFault);
+STATIC void   ArrayArenaSetFaultCb(struct ArrayArena_S *, ArrayArenaFaultCb_T, void *);
+STATIC size_t ArrayArenaFaultCount(const struct ArrayArena_S *, enum ArrayArenaFault);
+#endif
+
+// Persistent arenas (segregated free-lists only), compiled in /w
+// ARRAY_ARENA_PERSISTENT, for a pool that outlives the process (e.g., in a
+// mmap'd file or a shared-memory segment), so that a restarted process picks
+// up where the last one left off instead of rebuilding its state. All of the
+// metadata of an arena set up by ArrayArenaInit() already lives in the buffer,
+// and refers to blocks by offset rather than by address, so the buffer is all
+// there is to keep. ArrayArenaInit() then also writes a header to the start of
+// the buffer (magic, format version, a fingerprint of the compile-time config
+// that shapes the metadata, the lengths, and a checksum over all of that), and
+// ArrayArenaAttach() sets an arena back up over such a buffer once the header
+// and the free bitmaps check out. Attaching is a pass over the metadata, never
+// over the pool. If the process that last had the arena died in the middle of
+// an alloc or free, the free and allocated blocks do not add up to the space
+// that was laid out (as the header records), and the attach fails.
+// The buffer has to be mapped at the same pool alignment as before (any page
+// aligned mapping will do), but not at the same address: pointers are only
+// good in the mapping they came from, so whatever is kept in the pool should
+// refer to blocks by ArrayArenaOffsetOf(), and get back to them by
+// ArrayArenaAtOffset(). Other processes may map the same buffer to read what
+// is in it (zero-copy), but only one arena may be attached to it at a time.
+// What an arena keeps beside the buffer (callbacks, telemetry, fault counts)
+// starts over on attach, and stats and tags count what is live from there.
+#ifdef ARRAY_ARENA_PERSISTENT
+STATIC bool   ArrayArenaAttach(struct ArrayArena_S *, void *, size_t);
+#endif
+
+// Shared arenas (on top of ARRAY_ARENA_PERSISTENT), compiled in /w
+// ARRAY_ARENA_SHARED, to pass blocks between processes that map the same
+// buffer (e.g., a POSIX shared-memory object) /wout copying what is in them.
+// The process that set the arena up (or attached it) owns it, and is the only
+// one to allocate from it. Other processes open it as peers: they get at a
+// block by the offset the owner hands them (see ArrayArenaOffsetOf(); it can
+// be sent over a pipe, a socket, or anything else), and once done /w it, free
+// it by that offset. A peer's free pushes the block onto a lock-free queue in
+// the buffer, and the owner takes back what is on the queue whenever it
+// allocates, or when it calls ArrayArenaReclaim(). Which process holds a block
+// is up to the processes, as for a pointer passed between threads: a block
+// must be freed once, by whoever holds it last.
+#ifdef ARRAY_ARENA_SHARED
+struct ArrayArenaPeer_S
+{
+   uint8_t * pool; // This process's mapping of the pool
+   size_t pool_size;
+   uint32_t * remote_free_head; // The queue of the owner's blocks to take back (in the buffer)
+};
+STATIC bool   ArrayArenaPeerOpen(struct ArrayArenaPeer_S *, void *, size_t);
+STATIC void * ArrayArenaPeerAt(const struct ArrayArenaPeer_S *, size_t);
+STATIC bool   ArrayArenaPeerFree(const struct ArrayArenaPeer_S *, size_t);
+STATIC size_t ArrayArenaReclaim(struct ArrayArena_S *);
+#endif
+
+// Real-time mode (segregated free-lists only), compiled in /w
+// ARRAY_ARENA_REALTIME, for callers that need a worst-case bound on the time
+// an alloc, free, or realloc takes (e.g., from a control loop). None of them
+// then does anything that depends on the size of the pool or on what is
+// allocated in it. For N block sizes:
+//    - alloc: finding the lowest-addressed free block of a size is no longer
+//      a scan of its bitmap, but three ctz's down two levels of summary
+//      bitmaps. At most N sizes are looked at and at most N - 1 splits made.
+//    - free: at most N - 1 merges.
+//    - realloc: at most a free, two claims of a block where it is (each of at
+//      most N - 1 splits), and an alloc plus a copy of at most the largest
+//      block size.
+// Requests larger than the largest block size fail rather than being granted
+// a run of blocks, since finding a run is a search. The allocator's own
+// asserts are all O(1). ARRAY_ARENA_THREAD_SAFE cannot be combined /w it (the
+// lock and the draining of remote frees have no bound), and batches, compaction
+// steps, layout exports, and telemetry drains are bounded by their counts, not
+// by a constant. The cycle counts to certify an MCU by come from the WCET
+// workload of benchmark/bench_sara.c. The bump scheme is O(1) throughout
+// already, so this changes nothing there.
+
+// The block sizes of the segregated free-lists, as an X-macro, largest first.
+// Each size must be half of the one before it (the buddy system relies on
+// this). array_arena_cfg.h sets them along /w the initial list lengths (if
+// USE_EXTERNAL_INIT_LENS). For each size sz:
+//    - BLKS_<sz> is its enum BlockSize (in sara.c), and its size class
+//    - BLOCKS_<sz>_LIST_INIT_LEN is its initial length (if USE_EXTERNAL_INIT_LENS)
+//    - BLOCKS_<sz>_FREE_MAP_INIT is its initial free bitmap (if ARRAY_ARENA_CFG_HAS_INIT_TABLES)
+#ifdef USE_EXTERNAL_INIT_LENS
+#include "array_arena_cfg.h"
+#endif // USE_EXTERNAL_INIT_LENS
+#ifndef ARRAY_ARENA_BLOCK_SIZES
+#define ARRAY_ARENA_BLOCK_SIZES(X) X(1024) X(512) X(256) X(128) X(64) X(32)
+#endif
+
+// Size-class fast paths (segregated free-lists only). Each block size is a
+// size class, numbered from 0 for the largest size on down, and a request is
+// served from the smallest class that holds it plus ARRAY_ARENA_BLOCK_OVERHEAD
+// (the canary, in hardened mode). Which class that is takes a CLZ at run-time
+// (ArrayArenaSizeClass()), and nothing at all for a constant size, for which
+// ARRAY_ARENA_SIZE_CLASS() is a constant expression. ArrayArenaAllocClass()
+// then takes a block of the class straight off its free list (or splits one
+// off a larger block, as any alloc would), and skips working out the class
+// and whether the request needs a run of blocks or a trimmed one. So for a
+// fixed-size request (e.g., of sizeof a message), ARRAY_ARENA_ALLOC_FIXED()
+// is a call /w constant arguments and a pop from the free bitmap of the class.
+// Blocks from these are freed and resized like any other.
+//    - A class too small for req_bytes, or a req_bytes larger than the largest
+//      block size, falls back to ArrayArenaAlloc().
+//    - /w ARRAY_ARENA_INTERMEDIATE_SIZES, a whole block of the class is taken,
+//      never a trimmed one.
+//    - /w ARRAY_ARENA_CACHE_LINE_ISOLATION, classes of blocks smaller than a
+//      line are served by the class of a line.
+//    - /w ARRAY_ARENA_THREAD_SAFE, the block comes from the thread's cache,
+//      as for any alloc from the default arena.
+// In the bump scheme, all of these are plain allocs.
+#ifndef ARRAY_ARENA_SCHEME_BUMP
+#define X_ARRAY_ARENA_CLASS_COUNT(sz)  + 1
+#define X_ARRAY_ARENA_CLASS_SUM(sz)    + (sz)
+
+// As in sara.c, N sizes that are each half of the one before sum to
+// SMALLEST * (2^N - 1)
+enum
+{
+   ARRAY_ARENA_NUM_OF_CLASSES = 0 ARRAY_ARENA_BLOCK_SIZES(X_ARRAY_ARENA_CLASS_COUNT),
+   ARRAY_ARENA_SMALLEST_CLASS_BYTES =
+      (0 ARRAY_ARENA_BLOCK_SIZES(X_ARRAY_ARENA_CLASS_SUM)) / ((1 << ARRAY_ARENA_NUM_OF_CLASSES) - 1),
+   ARRAY_ARENA_LARGEST_CLASS_BYTES = ARRAY_ARENA_SMALLEST_CLASS_BYTES << (ARRAY_ARENA_NUM_OF_CLASSES - 1)
+};
+
+// ARRAY_ARENA_BYTES_CLASS() below goes up to 16 classes, which is as many as
+// there can be /w block sizes that fit in 16 bits (as sara.c checks they do)
+typedef char ArrayArena_ClassesFitClassMacro[ (ARRAY_ARENA_NUM_OF_CLASSES <= 16) ? 1 : -1 ];
+
+#ifdef ARRAY_ARENA_HARDENED
+#define ARRAY_ARENA_BLOCK_OVERHEAD  sizeof(uint32_t) // The canary
+#else
+#define ARRAY_ARENA_BLOCK_OVERHEAD  0u
+#endif
+
+// Whether the blocks of class k hold bytes (for a k and bytes in range)
+#define ARRAY_ARENA_CLASS_HOLDS(k, bytes) \
+   ( ((k) < ARRAY_ARENA_NUM_OF_CLASSES) && ((bytes) <= ((size_t)ARRAY_ARENA_LARGEST_CLASS_BYTES >> (k))) )
+
+// The smallest class /w blocks of at least bytes (0 if bytes is larger than
+// any), as a constant expression if bytes is one: how many classes below the
+// largest hold it. bytes is evaluated more than once.
+#define ARRAY_ARENA_BYTES_CLASS(bytes) \
+   ( (uint8_t)( ARRAY_ARENA_CLASS_HOLDS(1, (bytes))  + ARRAY_ARENA_CLASS_HOLDS(2, (bytes))  + \
+                ARRAY_ARENA_CLASS_HOLDS(3, (bytes))  + ARRAY_ARENA_CLASS_HOLDS(4, (bytes))  + \
+                ARRAY_ARENA_CLASS_HOLDS(5, (bytes))  + ARRAY_ARENA_CLASS_HOLDS(6, (bytes))  + \
+                ARRAY_ARENA_CLASS_HOLDS(7, (bytes))  + ARRAY_ARENA_CLASS_HOLDS(8, (bytes))  + \
+                ARRAY_ARENA_CLASS_HOLDS(9, (bytes))  + ARRAY_ARENA_CLASS_HOLDS(10, (bytes)) + \
+                ARRAY_ARENA_CLASS_HOLDS(11, (bytes)) + ARRAY_ARENA_CLASS_HOLDS(12, (bytes)) + \
+                ARRAY_ARENA_CLASS_HOLDS(13, (bytes)) + ARRAY_ARENA_CLASS_HOLDS(14, (bytes)) + \
+                ARRAY_ARENA_CLASS_HOLDS(15, (bytes)) ) )
+
+// The class a request of req_bytes is served from
+#define ARRAY_ARENA_SIZE_CLASS(req_bytes) \
+   ARRAY_ARENA_BYTES_CLASS( (size_t)(req_bytes) + ARRAY_ARENA_BLOCK_OVERHEAD )
+
+STATIC void * StaticArrayAllocClass(uint8_t, size_t);
+STATIC void * ArrayArenaAllocClass(struct ArrayArena_S *, uint8_t, size_t);
+
+/**
+ * @brief The smallest class /w blocks of at least bytes (≤ the largest block
+ *        size), as ARRAY_ARENA_BYTES_CLASS() but in constant time for a
+ *        bytes only known at run-time.
+ */
+static inline uint8_t ArrayArenaBytesClass(size_t bytes)
+{
+   if ( bytes <= ARRAY_ARENA_SMALLEST_CLASS_BYTES )   return (uint8_t)(ARRAY_ARENA_NUM_OF_CLASSES - 1);
+
+#if defined(__GNUC__)
+   // A block of 2^k holds bytes for k ≥ 32 - clz(bytes - 1), and the class of
+   // the largest size (of 2^K) is 0, so the class is the difference of the two
+   return (uint8_t)(__builtin_clz( (uint32_t)(bytes - 1) ) -
+                    __builtin_clz( (uint32_t)ARRAY_ARENA_LARGEST_CLASS_BYTES - 1u ));
+#else
+   return ARRAY_ARENA_BYTES_CLASS( bytes );
+#endif
+}
+
+// Largest request that is served from a single block (of class 0)
+#define ARRAY_ARENA_MAX_CLASS_REQ  ( (size_t)ARRAY_ARENA_LARGEST_CLASS_BYTES - ARRAY_ARENA_BLOCK_OVERHEAD )
+
+/**
+ * @brief The class a request of req_bytes (≤ ARRAY_ARENA_MAX_CLASS_REQ) is
+ *        served from.
+ */
+static inline uint8_t ArrayArenaSizeClass(size_t req_bytes)
+{
+   return ArrayArenaBytesClass( req_bytes + ARRAY_ARENA_BLOCK_OVERHEAD );
+}
+
+/**
+ * @brief Allocs of a size only known at run-time: through the class of it, if
+ *        it is served from a single block.
+ */
+static inline void * ArrayArenaAllocSmall(struct ArrayArena_S * arena, size_t req_bytes)
+{
+   if ( req_bytes > ARRAY_ARENA_MAX_CLASS_REQ )   return ArrayArenaAlloc( arena, req_bytes );
+   return ArrayArenaAllocClass( arena, ArrayArenaSizeClass( req_bytes ), req_bytes );
+}
+
+static inline void * StaticArrayAllocSmall(size_t req_bytes)
+{
+   if ( req_bytes > ARRAY_ARENA_MAX_CLASS_REQ )   return StaticArrayAlloc( req_bytes );
+   return StaticArrayAllocClass( ArrayArenaSizeClass( req_bytes ), req_bytes );
+}
+
+// Allocs of a constant size, /w the class resolved at compile-time
+#define ARRAY_ARENA_ALLOC_FIXED(arena, req_bytes) \
+   ArrayArenaAllocClass( (arena), ARRAY_ARENA_SIZE_CLASS(req_bytes), (req_bytes) )
+#define STATIC_ARRAY_ALLOC_FIXED(req_bytes) \
+   StaticArrayAllocClass( ARRAY_ARENA_SIZE_CLASS(req_bytes), (req_bytes) )
+
+#else
+#define ArrayArenaAllocSmall(arena, req_bytes)       ArrayArenaAlloc( (arena), (req_bytes) )
+#define StaticArrayAllocSmall(req_bytes)             StaticArrayAlloc( (req_bytes) )
+#define ARRAY_ARENA_ALLOC_FIXED(arena, req_bytes)    ArrayArenaAlloc( (arena), (req_bytes) )
+#define STATIC_ARRAY_ALLOC_FIXED(req_bytes)          StaticArrayAlloc( (req_bytes) )
+#endif // ARRAY_ARENA_SCHEME_BUMP
+
+#endif // SARA_H
@@ -2,11 +2,21 @@
 #define VIZABLE_TRAIT_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+enum ArenaVizBlkState
+{
+   ARENA_VIZ_BLK_FREE,
+   ARENA_VIZ_BLK_ALLOCATED,
+   ARENA_VIZ_BLK_UNLISTED // Neither allocated nor free (e.g., a gap no list covers)
+};
 
 struct ArenaVizBlk
 {
    size_t blk_offset;
    size_t blk_len;
+   enum ArenaVizBlkState state;
+   uint8_t tag; // Owner of an allocated block, for arenas that keep track of one (0 otherwise)
 };
 
 struct ArenaVizList
@@ -0,0 +1,271 @@
+import sys
+import socket
+import struct
+import argparse
+from collections import defaultdict
+
+MAGENTA = "\033[1;35m"
+CYAN = "\033[1;36m"
+RED = "\033[1;31m"
+YEL = "\033[0;33m"
+GREEN = "\033[1;32m"
+RESET = "\033[0m"
+
+# Must match struct ArrayArenaTelemRec_S and enum ArrayArenaTelemType in sara.c
+REC_SIZE = 16
+REC_FIELDS = "BBHIII" # type, blk_sz, seq, timestamp, offset, arg
+SYNC = 0xA0
+NO_SIZE = 0xFF
+ALLOC, FREE, FAIL, SPLIT, COALESCE, MOVE, INFO, LOST, TAG = range(9)
+TYPE_NAMES = ["ALLOC", "FREE", "FAIL", "SPLIT", "COALESCE", "MOVE", "INFO", "LOST", "TAG"]
+TYPE_COLORS = [GREEN, CYAN, RED, MAGENTA, MAGENTA, YEL, RESET, RED, YEL]
+
+class Record:
+    __slots__ = ("type", "blk_sz", "seq", "timestamp", "offset", "arg")
+
+    def __init__(self, fields):
+        type_byte, self.blk_sz, self.seq, self.timestamp, self.offset, self.arg = fields
+        self.type = type_byte & 0x0F
+
+    def __str__(self):
+        name = TYPE_NAMES[self.type]
+        sz = "-" if self.blk_sz == NO_SIZE or self.type == TAG else str(self.blk_sz)
+        if self.type == FAIL:
+            what = f"{self.arg} bytes x{self.offset}"
+        elif self.type == MOVE:
+            what = f"0x{self.arg:06X} -> 0x{self.offset:06X}"
+        elif self.type == INFO:
+            what = f"pool {self.offset} bytes, size {self.blk_sz} is {self.arg} bytes"
+        elif self.type == LOST:
+            what = f"{self.arg} records dropped on the target"
+        elif self.type == TAG:
+            what = f"tag {self.blk_sz} holds {self.offset} bytes (at most {self.arg})"
+        else:
+            what = f"0x{self.offset:06X} {self.arg} bytes"
+        return (f"{self.timestamp:10} #{self.seq:<5} "
+                f"{TYPE_COLORS[self.type]}{name:8}{RESET} [{sz:>2}] {what}")
+
+def is_record_start(data, i):
+    return ((data[i] & 0xF0) == SYNC) and ((data[i] & 0x0F) <= TAG)
+
+def decode(chunks, big_endian=False):
+    """Yield the records in a stream of byte chunks, which need not be split on
+    record boundaries. Bytes that are not part of a record (e.g., after bytes
+    went missing in transit) are skipped until the next record start."""
+    fmt = struct.Struct((">" if big_endian else "<") + REC_FIELDS)
+    pending = b""
+    for chunk in chunks:
+        data = pending + chunk
+        i = 0
+        while (len(data) - i) >= REC_SIZE:
+            if not is_record_start(data, i):
+                i += 1
+                continue
+            yield Record(fmt.unpack_from(data, i))
+            i += REC_SIZE
+        pending = data[i:]
+
+def strip_itm(chunks, port):
+    """Keep only the payload of the ITM stimulus packets for one port (i.e., what
+    ArrayArenaTelemetryItmSink() wrote), out of a raw SWO capture."""
+    PAYLOAD_LEN = {1: 1, 2: 2, 3: 4}
+    pending = b""
+    for chunk in chunks:
+        data = pending + chunk
+        out = bytearray()
+        i = 0
+        while i < len(data):
+            hdr = data[i]
+            size_code = hdr & 0x03
+            if size_code == 0:
+                # Sync, overflow, timestamp, or extension packets. The last two
+                # go on for as long as the continuation bit is set.
+                end = i + 1
+                if (hdr & 0x80) and (hdr != 0x80):
+                    while (end < len(data)) and (data[end] & 0x80):
+                        end += 1
+                    if end >= len(data):
+                        break # The rest of it is in the next chunk
+                    end += 1
+                i = end
+                continue
+            payload_len = PAYLOAD_LEN[size_code]
+            if (i + 1 + payload_len) > len(data):
+                break
+            if (not (hdr & 0x04)) and ((hdr >> 3) == port):
+                out += data[i + 1 : i + 1 + payload_len]
+            i += 1 + payload_len
+        pending = data[i:]
+        yield bytes(out)
+
+def file_chunks(f, chunk_size=4096):
+    while True:
+        chunk = f.read(chunk_size)
+        if not chunk:
+            return
+        yield chunk
+
+def udp_chunks(port):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("", port))
+    while True:
+        yield sock.recv(65536)
+
+def tcp_chunks(host, port):
+    sock = socket.create_connection((host, port))
+    while True:
+        chunk = sock.recv(65536)
+        if not chunk:
+            return
+        yield chunk
+
+def tee(chunks, f):
+    for chunk in chunks:
+        f.write(chunk)
+        yield chunk
+
+class Replay:
+    """Replays a stream of records to keep track of what is live in the arena."""
+
+    def __init__(self):
+        self.pool_size = None
+        self.block_sizes = {}
+        self.counts = defaultdict(lambda: [0] * len(TYPE_NAMES))
+        self.live = {} # Offset -> bytes requested
+        self.live_bytes = 0
+        self.peak_live_bytes = 0
+        self.granted_bytes = 0
+        self.freed_requested_bytes = 0
+        self.req_hist = defaultdict(int) # Power of 2 a request rounds up to -> count
+        self.tags = {} # Tag -> (bytes held, most bytes held), as last reported
+        self.lost = 0
+        self.gaps = 0
+        self.unmatched = 0
+        self.displaced = 0
+        self.last_seq = None
+        self.first_timestamp = None
+        self.last_timestamp = None
+
+    def _claim(self, offset):
+        # A block already live here means its FREE went missing: drop it
+        if offset in self.live:
+            self.live_bytes -= self.live.pop(offset)
+            self.displaced += 1
+
+    def feed(self, rec):
+        if rec.type == INFO:
+            self.pool_size = rec.offset
+            self.block_sizes[rec.blk_sz] = rec.arg
+            return
+        if rec.type == LOST:
+            # The target dropped these, so whatever is live may be off from here
+            self.lost += rec.arg
+            return
+        if rec.type == TAG:
+            self.tags[rec.blk_sz] = (rec.offset, rec.arg)
+            return
+
+        if (self.last_seq is not None) and (rec.seq != ((self.last_seq + 1) & 0xFFFF)):
+            self.gaps += (rec.seq - self.last_seq - 1) & 0xFFFF
+        self.last_seq = rec.seq
+        if self.first_timestamp is None:
+            self.first_timestamp = rec.timestamp
+        self.last_timestamp = rec.timestamp
+        self.counts[rec.blk_sz][rec.type] += 1
+
+        if rec.type == ALLOC:
+            self._claim(rec.offset)
+            self.live[rec.offset] = rec.arg
+            self.live_bytes += rec.arg
+            self.peak_live_bytes = max(self.peak_live_bytes, self.live_bytes)
+            self.req_hist[1 << max(rec.arg - 1, 0).bit_length()] += 1
+        elif rec.type == FAIL:
+            self.req_hist[1 << max(rec.arg - 1, 0).bit_length()] += rec.offset
+        elif rec.type == FREE:
+            req_bytes = self.live.pop(rec.offset, None)
+            if req_bytes is None:
+                self.unmatched += 1
+                return
+            self.live_bytes -= req_bytes
+            self.granted_bytes += rec.arg
+            self.freed_requested_bytes += req_bytes
+        elif rec.type == MOVE:
+            if rec.arg in self.live:
+                req_bytes = self.live.pop(rec.arg)
+                self._claim(rec.offset)
+                self.live[rec.offset] = req_bytes
+            else:
+                self.unmatched += 1
+
+    def print_summary(self):
+        print(f"\n{CYAN}Summary{RESET}")
+        if self.pool_size is not None:
+            print(f"Pool size: {GREEN}{self.pool_size}{RESET} bytes")
+        print(f"{'size':>6} {'bytes':>6} " + " ".join(f"{name:>9}" for name in TYPE_NAMES[:MOVE + 1]))
+        for blk_sz in sorted(self.counts):
+            label = "-" if blk_sz == NO_SIZE else str(blk_sz)
+            bytes_str = str(self.block_sizes.get(blk_sz, ""))
+            print(f"{MAGENTA}{label:>6}{RESET} {bytes_str:>6} " +
+                  " ".join(f"{n:>9}" for n in self.counts[blk_sz][:MOVE + 1]))
+        print(f"Peak bytes requested and live: {GREEN}{self.peak_live_bytes}{RESET}")
+        if self.granted_bytes > 0:
+            waste = 100.0 * (1.0 - (self.freed_requested_bytes / self.granted_bytes))
+            print(f"Internal fragmentation (of freed blocks): {YEL}{waste:.1f}%{RESET}")
+        print("Requests (incl. failed), by the power of 2 they round up to:")
+        for sz in sorted(self.req_hist):
+            print(f"   {MAGENTA}{sz:>6}{RESET}: {self.req_hist[sz]}")
+        print(f"Still live at the end: {len(self.live)} blocks, {self.live_bytes} bytes")
+        if self.tags:
+            print("Held by each tag (granted bytes, as last reported), and at most:")
+            for tag in sorted(self.tags):
+                held, peak = self.tags[tag]
+                print(f"   {MAGENTA}{tag:>6}{RESET}: {held} (peak {peak})")
+        if self.first_timestamp is not None:
+            ticks = (self.last_timestamp - self.first_timestamp) & 0xFFFFFFFF
+            print(f"Timestamp span: {ticks} ticks")
+        if self.lost or self.gaps or self.unmatched or self.displaced:
+            print(f"{RED}Dropped on the target: {self.lost}, missing in transit: {self.gaps}, "
+                  f"frees/moves of blocks not seen allocated: {self.unmatched}, "
+                  f"allocs/moves onto blocks still live: {self.displaced}{RESET}")
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Decode (and replay) the ARRAY_ARENA_TELEMETRY stream of sara.c.")
+    src = parser.add_mutually_exclusive_group()
+    src.add_argument("trace", nargs="?", default="-", help="saved trace file (default: stdin)")
+    src.add_argument("--udp", type=int, metavar="PORT", help="listen for datagrams on PORT")
+    src.add_argument("--tcp", metavar="HOST:PORT", help="connect to a TCP stream")
+    parser.add_argument("--itm", type=int, metavar="PORT",
+                        help="input is a raw SWO capture; keep ITM stimulus port PORT")
+    parser.add_argument("--big-endian", action="store_true", help="the target is big-endian")
+    parser.add_argument("--save", metavar="FILE", help="also save the raw stream to FILE")
+    parser.add_argument("--quiet", action="store_true", help="only print the summary")
+    args = parser.parse_args()
+
+    if args.udp is not None:
+        chunks = udp_chunks(args.udp)
+    elif args.tcp is not None:
+        host, port = args.tcp.rsplit(":", 1)
+        chunks = tcp_chunks(host, int(port))
+    elif args.trace == "-":
+        chunks = file_chunks(sys.stdin.buffer)
+    else:
+        chunks = file_chunks(open(args.trace, "rb"))
+    if args.itm is not None:
+        chunks = strip_itm(chunks, args.itm)
+    save_file = open(args.save, "wb") if args.save else None
+    if save_file:
+        chunks = tee(chunks, save_file)
+
+    replay = Replay()
+    try:
+        for rec in decode(chunks, args.big_endian):
+            if not args.quiet:
+                print(rec)
+            replay.feed(rec)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if save_file:
+            save_file.close()
+    replay.print_summary()
@@ -28,6 +28,8 @@ def split_arena(arena_size):
     #         must be ≤ arena_size.
     #       - Minimize the mean and standard deviation byte distribution /w
     #         respect to a desired distribution (e.g, uniform, normal, etc.).
+    #       (To fit the lengths to a recorded workload instead, see
+    #       tune_arena.py.)
 
     ############################################
     # Solution 2: The Alternating Walk Solution
@@ -177,7 +179,52 @@ def print_split(arena_size, blocks, gap):
         print(line)
     print()  # Extra newline for clarity
 
-def file_hdr_content(arena, blocks, gap, hdr_name):
+WORD_BITS = 32
+
+def words_init(name, words):
+    WORDS_PER_LINE = 4
+    lines = []
+    for i in range(0, len(words), WORDS_PER_LINE):
+        lines.append(", ".join(f"0x{w:08X}u" for w in words[i:i + WORDS_PER_LINE]))
+    return_str = f"#define {name} \\\n"
+    return_str += "   { \\\n"
+    return_str += ", \\\n".join(f"      {line}" for line in lines)
+    return_str += " \\\n   }\n"
+    return return_str
+
+def summary_words(words):
+    # Bit w of a summary is set iff word w of what it summarizes is non-zero
+    summary = [0] * ((len(words) + WORD_BITS - 1) // WORD_BITS)
+    for w, word in enumerate(words):
+        if word != 0:
+            summary[w // WORD_BITS] |= 1 << (w % WORD_BITS)
+    return summary
+
+def free_map_init(arena, blocks):
+    # Mirror what StaticArrayPoolInit() in sara.c does at run-time: lay the
+    # lists out back-to-back in descending order of block size, and set the
+    # free bit of each block, i.e. bit (offset / size) of that size's bitmap.
+    # The summaries over each bitmap that ARRAY_ARENA_REALTIME keeps are
+    # generated alongside.
+    return_str = ""
+    summaries_str = ""
+    offset = 0
+    for sz in sorted(blocks, reverse=True):
+        capacity = (arena // sz) + 1
+        words = [0] * ((capacity + WORD_BITS - 1) // WORD_BITS)
+        for _ in range(blocks[sz]):
+            idx = offset // sz
+            words[idx // WORD_BITS] |= 1 << (idx % WORD_BITS)
+            offset += sz
+        return_str += words_init(f"BLOCKS_{sz}_FREE_MAP_INIT", words)
+        summary = summary_words(words)
+        top = summary_words(summary)
+        summaries_str += words_init(f"BLOCKS_{sz}_FREE_SUMMARY_INIT", summary)
+        summaries_str += f"#define BLOCKS_{sz}_FREE_TOP_INIT 0x{top[0]:08X}u\n"
+    return_str += "\n// Summaries of the bitmaps above, for ARRAY_ARENA_REALTIME (see sara.c).\n"
+    return return_str + summaries_str, offset
+
+def file_hdr_content(arena, blocks, gap, hdr_name, generator="discretize_python.py"):
     return_str = ""
     current_datetime = datetime.now()
     str_datetime = current_datetime.strftime("%a, %b %d, %Y :: %H:%M:%S %p %Z")
@@ -197,15 +244,31 @@ def file_hdr_content(arena, blocks, gap, hdr_name):
 #ifndef _ARRAY_CFG_H_
 #define _ARRAY_CFG_H_
 
-// Given the arena size: {arena} bytes, discretize_python.py allocates the bytes
+// Given the arena size: {arena} bytes, {generator} allocates the bytes
 // as shown below:
 
+// The block sizes the lengths below are for (see sara.c).
+#define ARRAY_ARENA_BLOCK_SIZES(X) {' '.join(f'X({sz})' for sz in blocks)}
+
 """
     for sz, count in blocks.items():
-        return_str += f"#define {f"BLOCKS_{sz}_LIST_INIT_LEN":25} {count:3}"
+        return_str += f"#define {f'BLOCKS_{sz}_LIST_INIT_LEN':25} {count:3}"
         return_str += f" // {sz * count} bytes\n"
 
-    return_str += f"// {" ":33}     {gap} byte gap\n"
+    return_str += f"// {' ':33}     {gap} byte gap\n"
+
+    free_maps, space_available = free_map_init(arena, blocks)
+    return_str += f"""
+// Free bitmaps of the layout above, so that the arena needs no run-time init.
+// If you modify the lengths above by hand, either re-run the script or delete
+// the tables below (through to the #endif) to fall back to run-time init.
+#define ARRAY_ARENA_CFG_HAS_INIT_TABLES
+#define ARRAY_ARENA_CFG_HAS_SUMMARY_TABLES
+#define ARRAY_ARENA_CFG_ARENA_SIZE      {arena}
+#define ARRAY_ARENA_CFG_SPACE_AVAILABLE {space_available}
+
+"""
+    return_str += free_maps
     return_str += """
 
 #endif // _ARRAY_CFG_H_
@@ -0,0 +1,429 @@
+import sys
+import heapq
+import argparse
+from collections import defaultdict
+
+from discretize_arena import split_arena, print_split, file_hdr_content, MAGENTA, CYAN, RED, GREEN, RESET
+import decode_telemetry as telem
+
+# Tunes cfg/array_arena_cfg.h to a recorded allocation trace: the initial free
+# list lengths and (unless told otherwise) the block sizes themselves. Each
+# candidate is scored by replaying the trace through a model of the segregated
+# free-lists scheme of sara.c, which counts what the arena would have done /w
+# that config. The one /w the fewest failed allocs, and then the least split
+# and merge churn, is written out.
+#
+# Traces are either a saved ARRAY_ARENA_TELEMETRY stream (see
+# decode_telemetry.py --save), or a host-side capture in text, one op a line:
+#    alloc <id> <bytes>
+#    realloc <id> <bytes>
+#    free <id>
+# where <id> is anything that names the block (e.g., the pointer).
+
+FAIL_WEIGHT = 1000 # A failed alloc costs this many splits/merges
+SIZE_SETS_TUNED = 3 # How many of the best-seeded sets of block sizes go on to be tuned
+SINGLE_BLOCK_SHARE = 0.9 # Share of requests the largest block size has to cover, when picking sizes
+
+class ArenaModel:
+    """The segregated free-lists scheme of sara.c, down to which free block an
+    alloc takes (the lowest-addressed one that fits best), how blocks are split
+    and merged, and how requests above the largest size are granted runs."""
+
+    def __init__(self, pool_size, block_sizes, init_lens, intermediate=False):
+        self.sizes = block_sizes # Largest first, each half the one before
+        self.intermediate = intermediate
+        self.free = [set() for _ in block_sizes]
+        self.heaps = [[] for _ in block_sizes] # Lazily pruned, so that the lowest free idx is at hand
+        self.capacity = [(pool_size // sz) + 1 for sz in block_sizes]
+        self.space_available = 0
+        self.splits = 0
+        self.coalesces = 0
+        self.fails = 0
+        self.allocs = 0
+        self.run_blocks = 0 # Largest blocks taken or handed back as part of a run
+        offset = 0
+        for sz_idx, sz in enumerate(block_sizes):
+            for _ in range(init_lens[sz_idx]):
+                assert (offset + sz) <= pool_size, "List lengths overrun the pool"
+                self.mark_free(sz_idx, offset // sz)
+                offset += sz
+        self.space_available = offset
+
+    def mark_free(self, sz, idx):
+        self.free[sz].add(idx)
+        heapq.heappush(self.heaps[sz], idx)
+
+    def take_free(self, sz):
+        heap = self.heaps[sz]
+        while heap:
+            idx = heapq.heappop(heap)
+            if idx in self.free[sz]:
+                self.free[sz].discard(idx)
+                return idx
+        return None
+
+    def request_to_block(self, req_bytes):
+        """(size idx, trimmed, run length) of the best fit, or None"""
+        largest = self.sizes[0]
+        if req_bytes > largest:
+            run_len = -(-req_bytes // largest)
+            if run_len > self.capacity[0]:
+                return None
+            return (0, False, run_len)
+        sz = len(self.sizes) - 1
+        while (sz > 0) and (req_bytes > self.sizes[sz]):
+            sz -= 1
+        if (self.intermediate and ((sz + 2) < len(self.sizes)) and
+                (req_bytes <= (self.sizes[sz + 1] + self.sizes[sz + 2]))):
+            return (sz + 1, True, 0)
+        return (sz, False, 0)
+
+    @staticmethod
+    def block_bytes(blk, sizes):
+        sz, trimmed, run_len = blk
+        if run_len > 0:
+            return run_len * sizes[sz]
+        return sizes[sz] + (sizes[sz] // 2 if trimmed else 0)
+
+    def alloc_block(self, sz):
+        idx = self.take_free(sz)
+        if idx is not None:
+            return idx
+        for larger in range(sz - 1, -1, -1):
+            idx = self.take_free(larger)
+            if idx is None:
+                continue
+            for s in range(larger + 1, sz + 1):
+                self.splits += 1
+                idx *= 2
+                self.mark_free(s, idx + 1)
+            return idx
+        return None
+
+    def take_run(self, run_len):
+        if len(self.free[0]) < run_len:
+            return None
+        run_start, run_found, prev = None, 0, None
+        for idx in sorted(self.free[0]):
+            if (prev is not None) and (idx == prev + 1):
+                run_found += 1
+            else:
+                run_start, run_found = idx, 1
+            prev = idx
+            if run_found == run_len:
+                for i in range(run_start, run_start + run_len):
+                    self.free[0].discard(i)
+                return run_start
+        return None
+
+    def coalesce(self, sz, idx):
+        while sz != 0:
+            buddy = idx ^ 1
+            if buddy not in self.free[sz]:
+                break
+            self.free[sz].discard(buddy)
+            self.coalesces += 1
+            idx //= 2
+            sz -= 1
+        self.mark_free(sz, idx)
+
+    def alloc(self, req_bytes):
+        """Return a handle to the block granted, or None"""
+        blk = self.request_to_block(req_bytes)
+        if (req_bytes > self.space_available) or (blk is None):
+            self.fails += 1
+            return None
+        sz, trimmed, run_len = blk
+        if run_len > 0:
+            idx = self.take_run(run_len)
+            self.run_blocks += run_len
+        elif trimmed:
+            whole_idx = self.alloc_block(sz - 1)
+            idx = None
+            if whole_idx is not None:
+                idx = whole_idx * 2
+                self.mark_free(sz + 1, (whole_idx * 4) + 3)
+                self.splits += 2
+        else:
+            idx = self.alloc_block(sz)
+        if idx is None:
+            self.fails += 1
+            return None
+        self.allocs += 1
+        self.space_available -= self.block_bytes(blk, self.sizes)
+        return (blk, idx)
+
+    def free_block(self, handle):
+        (sz, trimmed, run_len), idx = handle
+        self.space_available += self.block_bytes((sz, trimmed, run_len), self.sizes)
+        if run_len > 0:
+            self.run_blocks += run_len
+            for i in range(idx, idx + run_len):
+                self.mark_free(0, i)
+            return
+        if trimmed:
+            self.coalesce(sz + 1, (idx * 2) + 2)
+        self.coalesce(sz, idx)
+
+    def cost(self):
+        # Each block of a run is a bit to find and mark, as each split or merge is
+        return (self.fails * FAIL_WEIGHT) + self.splits + self.coalesces + self.run_blocks
+
+def ops_from_telemetry(path):
+    """(ops, pool size, block sizes) from a saved telemetry stream. Failed
+    requests are kept as allocs that are freed right away, since they show
+    demand but have no lifetime."""
+    ops, pool_size, sizes, lost = [], None, {}, 0
+    with open(path, "rb") as f:
+        for rec in telem.decode(telem.file_chunks(f)):
+            if rec.type == telem.INFO:
+                pool_size = rec.offset
+                sizes[rec.blk_sz] = rec.arg
+            elif rec.type == telem.LOST:
+                lost += rec.arg
+            elif rec.type == telem.ALLOC:
+                ops.append(("alloc", rec.offset, rec.arg))
+            elif rec.type == telem.FREE:
+                ops.append(("free", rec.offset, 0))
+            elif rec.type == telem.MOVE:
+                ops.append(("move", rec.arg, rec.offset))
+            elif rec.type == telem.FAIL:
+                for _ in range(rec.offset):
+                    ops.append(("alloc", None, rec.arg))
+                    ops.append(("free", None, 0))
+    if lost:
+        print(f"{RED}The trace is missing {lost} records that were dropped on the target.{RESET}")
+    block_sizes = [sizes[i] for i in sorted(sizes)] or None
+    return ops, pool_size, block_sizes
+
+def ops_from_text(path):
+    ops = []
+    with open(path) as f:
+        for line_num, line in enumerate(f, 1):
+            fields = line.split()
+            if (not fields) or fields[0].startswith("#"):
+                continue
+            if (fields[0] in ("alloc", "realloc")) and (len(fields) == 3):
+                if fields[0] == "realloc":
+                    # Modelled as a free and an alloc (an in-place resize churns less)
+                    ops.append(("free", fields[1], 0))
+                ops.append(("alloc", fields[1], int(fields[2])))
+            elif (fields[0] == "free") and (len(fields) == 2):
+                ops.append(("free", fields[1], 0))
+            else:
+                sys.exit(f"{path}:{line_num}: expected 'alloc <id> <bytes>', 'realloc <id> <bytes>', or 'free <id>'")
+    return ops
+
+def replay(ops, pool_size, block_sizes, init_lens, intermediate):
+    model = ArenaModel(pool_size, block_sizes, init_lens, intermediate)
+    live = {}
+    transient = []
+    for op, key, arg in ops:
+        if op == "alloc":
+            handle = model.alloc(arg)
+            if key is None:
+                transient.append(handle)
+            elif handle is not None:
+                if key in live:
+                    model.free_block(live.pop(key))
+                live[key] = handle
+            else:
+                live.pop(key, None)
+        elif op == "free":
+            handle = transient.pop() if key is None else live.pop(key, None)
+            if handle is not None:
+                model.free_block(handle)
+        elif (op == "move") and (key in live):
+            live[arg] = live.pop(key)
+    return model
+
+def peak_demand(ops, block_sizes, intermediate):
+    """Most blocks of each size that were ever live at once, for a pool that
+    never runs out and never splits (i.e., what each list would ideally
+    start out /w)."""
+    model = ArenaModel(0, block_sizes, [0] * len(block_sizes), intermediate)
+    model.capacity = [sys.maxsize] * len(block_sizes)
+    live, transient = {}, []
+    demand = [0] * len(block_sizes)
+    peak = [0] * len(block_sizes)
+
+    def take(blk, n):
+        sz, trimmed, run_len = blk
+        if run_len > 0:
+            demand[0] += n * run_len
+        else:
+            demand[sz] += n
+            if trimmed:
+                demand[sz + 1] += n
+        for i in range(len(demand)):
+            peak[i] = max(peak[i], demand[i])
+
+    for op, key, arg in ops:
+        if op == "alloc":
+            blk = model.request_to_block(arg)
+            if blk is None:
+                continue
+            take(blk, 1)
+            if key is None:
+                transient.append(blk)
+            else:
+                if key in live:
+                    take(live.pop(key), -1)
+                live[key] = blk
+        elif op == "free":
+            blk = transient.pop() if key is None else live.pop(key, None)
+            if blk is not None:
+                take(blk, -1)
+        elif (op == "move") and (key in live):
+            live[arg] = live.pop(key)
+    return peak
+
+def seed_lens(pool_size, block_sizes, peak):
+    """Initial lengths in proportion to the peak demand for each size, scaled
+    down to fit if need be, /w whatever is left over going to the largest
+    sizes that fit."""
+    demand_bytes = sum(n * sz for n, sz in zip(peak, block_sizes))
+    scale = min(1.0, pool_size / demand_bytes) if demand_bytes > 0 else 0.0
+    lens = [int(n * scale) for n in peak]
+    remaining = pool_size - sum(n * sz for n, sz in zip(lens, block_sizes))
+    for i, sz in enumerate(block_sizes):
+        count, remaining = divmod(remaining, sz)
+        lens[i] += count
+    return lens
+
+def neighbours(lens, block_sizes, pool_size):
+    """Lengths one step away: a block split into two of the next size down,
+    two merged into one of the next size up, or a block added /w the gap."""
+    gap = pool_size - sum(n * sz for n, sz in zip(lens, block_sizes))
+    for i in range(len(lens) - 1):
+        if lens[i] > 0:
+            step = list(lens)
+            step[i] -= 1
+            step[i + 1] += 2
+            yield step
+        if lens[i + 1] >= 2:
+            step = list(lens)
+            step[i] += 1
+            step[i + 1] -= 2
+            yield step
+    for i, sz in enumerate(block_sizes):
+        if sz <= gap:
+            step = list(lens)
+            step[i] += 1
+            yield step
+
+def tune_lens(ops, pool_size, block_sizes, intermediate, max_evals):
+    peak = peak_demand(ops, block_sizes, intermediate)
+    best = seed_lens(pool_size, block_sizes, peak)
+    best_model = replay(ops, pool_size, block_sizes, best, intermediate)
+    evals = 1
+    improved = True
+    while improved and (evals < max_evals):
+        improved = False
+        for step in neighbours(best, block_sizes, pool_size):
+            if evals >= max_evals:
+                break
+            model = replay(ops, pool_size, block_sizes, step, intermediate)
+            evals += 1
+            if model.cost() < best_model.cost():
+                best, best_model = step, model
+                improved = True
+                break
+    return best, best_model
+
+def candidate_size_sets(ops, pool_size, smallest_min):
+    # Each size must be half the one before, fit in a uint16_t, and the smallest
+    # (the granule) must be a multiple of sizeof(size_t). Runs are for the odd
+    # large request, so most requests have to fit in a single block: a run is a
+    # search of the largest-block bitmap, and no block of a run is ever split.
+    req_sizes = sorted(arg for op, _, arg in ops if op == "alloc")
+    largest_min = req_sizes[int(SINGLE_BLOCK_SHARE * (len(req_sizes) - 1))] if req_sizes else 0
+    smallest = smallest_min
+    while smallest <= 128:
+        largest = smallest
+        while (largest * 2) <= min(pool_size, 32768):
+            largest *= 2
+            if largest < largest_min:
+                continue
+            sizes = []
+            sz = largest
+            while sz >= smallest:
+                sizes.append(sz)
+                sz //= 2
+            if len(sizes) >= 2:
+                yield sizes
+        smallest *= 2
+
+def print_result(label, block_sizes, lens, model):
+    print(f"{CYAN}{label}{RESET}: sizes {block_sizes}, lens {lens}")
+    print(f"   fails {RED}{model.fails}{RESET}, splits {MAGENTA}{model.splits}{RESET}, "
+          f"coalesces {MAGENTA}{model.coalesces}{RESET}, run blocks {MAGENTA}{model.run_blocks}{RESET} "
+          f"(over {model.allocs} allocs)")
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Tune cfg/array_arena_cfg.h to a recorded allocation trace.")
+    parser.add_argument("trace", help="saved telemetry stream, or a text capture (see --text)")
+    parser.add_argument("--text", action="store_true", help="the trace is a host-side text capture")
+    parser.add_argument("--arena-size", type=int, help="pool size in bytes (default: from the trace)")
+    parser.add_argument("--sizes", help="block sizes to keep, largest first, e.g. 1024,512,256,128,64,32 "
+                                        "(default: from the trace, or searched for /w --search-sizes)")
+    parser.add_argument("--search-sizes", action="store_true", help="also pick the block sizes")
+    parser.add_argument("--intermediate", action="store_true",
+                        help="model ARRAY_ARENA_INTERMEDIATE_SIZES")
+    parser.add_argument("--max-evals", type=int, default=200, help="replays per set of block sizes")
+    parser.add_argument("--out", default="./cfg/array_arena_cfg.h", help="header to write")
+    parser.add_argument("--dry-run", action="store_true", help="do not write the header")
+    args = parser.parse_args()
+
+    trace_sizes = None
+    if args.text:
+        ops, pool_size = ops_from_text(args.trace), None
+    else:
+        ops, pool_size, trace_sizes = ops_from_telemetry(args.trace)
+    pool_size = args.arena_size or pool_size
+    if not pool_size:
+        sys.exit("The pool size is not in the trace. Pass --arena-size.")
+    if args.sizes:
+        trace_sizes = [int(sz) for sz in args.sizes.split(",")]
+    if not trace_sizes:
+        trace_sizes = [1024, 512, 256, 128, 64, 32]
+    print(f"{len(ops)} ops over a {GREEN}{pool_size}{RESET} byte pool")
+
+    # What the arena does today: the alternating walk of discretize_arena.py
+    # for the default sizes, and the largest-first default otherwise
+    if trace_sizes == [1024, 512, 256, 128, 64, 32]:
+        walk, _ = split_arena(pool_size)
+        base_lens = [walk[sz] for sz in trace_sizes]
+    else:
+        base_lens = seed_lens(pool_size, trace_sizes, [0] * len(trace_sizes))
+    base = replay(ops, pool_size, trace_sizes, base_lens, args.intermediate)
+    print_result("Baseline", trace_sizes, base_lens, base)
+
+    size_sets = [trace_sizes]
+    if args.search_sizes:
+        # Only the sets that do best as seeded are worth the full search
+        def seeded_cost(sizes):
+            lens = seed_lens(pool_size, sizes, peak_demand(ops, sizes, args.intermediate))
+            return replay(ops, pool_size, sizes, lens, args.intermediate).cost()
+        size_sets = sorted(candidate_size_sets(ops, pool_size, 8), key=seeded_cost)[:SIZE_SETS_TUNED]
+        if trace_sizes not in size_sets:
+            size_sets.append(trace_sizes)
+    best = None
+    for sizes in size_sets:
+        lens, model = tune_lens(ops, pool_size, sizes, args.intermediate, args.max_evals)
+        if (best is None) or (model.cost() < best[2].cost()):
+            best = (sizes, lens, model)
+    sizes, lens, model = best
+    print_result("Tuned", sizes, lens, model)
+
+    blocks = {sz: n for sz, n in zip(sizes, lens)}
+    gap = pool_size - sum(sz * n for sz, n in blocks.items())
+    print_split(pool_size, blocks, gap)
+    if args.dry_run:
+        sys.exit(0)
+    with open(args.out, "w") as f:
+        f.write(file_hdr_content(pool_size, blocks, gap, "array_arena_cfg.h", "tune_arena.py"))
+    print(f"File: {CYAN}{args.out}{RESET} has been generated.")
+    if sizes != trace_sizes:
+        print(f"{RED}The block sizes have changed: rebuild everything that includes sara.c.{RESET}")
@@ -2,385 +2,5086 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include <assert.h>
 
-STATIC void StaticArrayPoolInit(void);
-STATIC bool StaticArrayPoolIsInitialized(void);
+#include "sara.h"
 
-STATIC struct Vector_S * StaticVectorArenaAlloc(void);
-STATIC void   StaticVectorArenaFree(const struct Vector_S *);
-STATIC bool   StaticVectorIsAlloc(const struct Vector_S *);
+/********************* Fixed-Object Size Pool Allocation *********************/
 
-STATIC void * StaticArrayAlloc(size_t);
-STATIC void * StaticArrayRealloc(void *, size_t);
-STATIC void   StaticArrayFree(const void *);
-STATIC bool   StaticArrayIsAlloc(const void *);
+// A fixed-object size pool hands out equally sized slots. While a slot is free,
+// its own bytes hold the link to the next free slot, so the pool needs no
+// metadata beyond the list head, and both alloc and free are a single list
+// push/pop. Slots that have never been handed out are taken in order off the
+// end of the pool, which lets the pool start out (statically) all-zero
+// without linking every slot up at boot.
+struct ObjPool_S
+{
+   uint8_t * slots; // Storage for the slots
+   size_t slot_size; // Size of each slot in bytes (≥ sizeof(void *))
+   size_t num_of_slots; // How many slots are in the pool
+   void * free_head; // Most recently freed slot, or NULL
+   size_t num_untouched; // Idx of the first slot that has never been handed out
+};
+
+#define OBJ_POOL(storage) \
+   { .slots = (uint8_t *)(storage), .slot_size = sizeof((storage)[0]), \
+     .num_of_slots = sizeof(storage) / sizeof((storage)[0]), \
+     .free_head = NULL, .num_untouched = 0 }
+
+/**
+ * @brief Local helper functions for a fixed-object size pool.
+ * @note Helper_ObjPoolIsAlloc() has to walk the free list (there is no per-slot
+ *       metadata to check instead), so unlike alloc and free, it is O(n).
+ */
+static void * Helper_ObjPoolAlloc( struct ObjPool_S * pool );
+static void   Helper_ObjPoolFree( struct ObjPool_S * pool, const void * ptr );
+static bool   Helper_ObjPoolIsAlloc( const struct ObjPool_S * pool, const void * ptr );
+static bool   Helper_ObjPoolIsSlot( const struct ObjPool_S * pool, const void * ptr );
+
+// Vector headers are the first user of the fixed-object size pool.
+#ifndef VEC_VECTOR_ARENA_CAPACITY
+#define VEC_VECTOR_ARENA_CAPACITY 16
+#endif
+
+union VectorArenaSlot_U
+{
+   struct Vector_S vec;
+   union VectorArenaSlot_U * next_free; // Only meaningful while the slot is free
+};
+
+//! The arena of vector headers
+STATIC union VectorArenaSlot_U VectorArenaPool[VEC_VECTOR_ARENA_CAPACITY];
+
+STATIC struct ObjPool_S VectorArena = OBJ_POOL( VectorArenaPool );
+
+/**
+ * @brief Allocates a vector header from the static vector arena.
+ * @return Pointer to the header if successful, NULL otherwise.
+ */
+STATIC struct Vector_S * StaticVectorArenaAlloc(void)
+{
+   union VectorArenaSlot_U * slot = Helper_ObjPoolAlloc( &VectorArena );
+   return ( slot != NULL ) ? &slot->vec : NULL;
+}
+
+/**
+ * @brief Return a vector header to the static vector arena.
+ * @note If the address passed in is not one that a header lives at, the fcn simply returns.
+ */
+STATIC void StaticVectorArenaFree(const struct Vector_S * vec)
+{
+   Helper_ObjPoolFree( &VectorArena, vec );
+}
+
+/**
+ * @brief Determine whether an address is associated /w a vector header that is allocated.
+ */
+STATIC bool StaticVectorIsAlloc(const struct Vector_S * vec)
+{
+   return Helper_ObjPoolIsAlloc( &VectorArena, vec );
+}
+
+static void * Helper_ObjPoolAlloc( struct ObjPool_S * pool )
+{
+   void * slot = pool->free_head;
+
+   if ( slot != NULL )
+   {
+      memcpy( &pool->free_head, slot, sizeof(void *) );
+   }
+   else if ( pool->num_untouched < pool->num_of_slots )
+   {
+      slot = &pool->slots[ pool->num_untouched * pool->slot_size ];
+      pool->num_untouched++;
+   }
+
+   return slot;
+}
+
+static void Helper_ObjPoolFree( struct ObjPool_S * pool, const void * ptr )
+{
+   if ( !Helper_ObjPoolIsSlot( pool, ptr ) )   return;
+
+   void * slot = &pool->slots[ (size_t)((const uint8_t *)ptr - pool->slots) ];
+   memcpy( slot, &pool->free_head, sizeof(void *) );
+   pool->free_head = slot;
+}
+
+static bool Helper_ObjPoolIsAlloc( const struct ObjPool_S * pool, const void * ptr )
+{
+   if ( !Helper_ObjPoolIsSlot( pool, ptr ) )   return false;
+
+   for ( const void * slot = pool->free_head; slot != NULL; )
+   {
+      if ( slot == ptr )   return false;
+      memcpy( &slot, slot, sizeof(void *) );
+   }
+   return true;
+}
+
+static bool Helper_ObjPoolIsSlot( const struct ObjPool_S * pool, const void * ptr )
+{
+   if ( NULL == ptr )   return false;
+
+   uintptr_t addr = (uintptr_t)ptr;
+   uintptr_t base = (uintptr_t)pool->slots;
+   if ( (addr < base) || (addr >= (base + (pool->num_untouched * pool->slot_size))) )   return false;
+
+   return ( (size_t)(addr - base) % pool->slot_size ) == 0;
+}
+
+/************************** Static Array Allocation ***************************/
+
+#ifdef ARRAY_ARENA_CACHE_LINE_ISOLATION
+#ifndef ARRAY_ARENA_CACHE_LINE_SIZE
+#define ARRAY_ARENA_CACHE_LINE_SIZE 64
+#endif
+#if ( (ARRAY_ARENA_CACHE_LINE_SIZE == 0) || ((ARRAY_ARENA_CACHE_LINE_SIZE & (ARRAY_ARENA_CACHE_LINE_SIZE - 1)) != 0) )
+#error "ARRAY_ARENA_CACHE_LINE_SIZE must be a power of 2"
+#endif
+#ifndef ARRAY_ARENA_POOL_ALIGNMENT
+#define ARRAY_ARENA_POOL_ALIGNMENT ARRAY_ARENA_CACHE_LINE_SIZE
+#endif
+#if ( ARRAY_ARENA_POOL_ALIGNMENT < ARRAY_ARENA_CACHE_LINE_SIZE )
+#error "ARRAY_ARENA_CACHE_LINE_ISOLATION needs an ARRAY_ARENA_POOL_ALIGNMENT of at least a cache line"
+#endif
+#endif // ARRAY_ARENA_CACHE_LINE_ISOLATION
+
+// Pools are never aligned to less than a pointer, which is what the default
+// pool gets by itself.
+#ifdef ARRAY_ARENA_POOL_ALIGNMENT
+#if ( (ARRAY_ARENA_POOL_ALIGNMENT == 0) || ((ARRAY_ARENA_POOL_ALIGNMENT & (ARRAY_ARENA_POOL_ALIGNMENT - 1)) != 0) )
+#error "ARRAY_ARENA_POOL_ALIGNMENT must be a power of 2"
+#endif
+#ifndef ARRAY_ARENA_POOL_ALIGN_ATTR
+#if defined(__GNUC__)
+#define ARRAY_ARENA_POOL_ALIGN_ATTR __attribute__(( aligned(ARRAY_ARENA_POOL_ALIGNMENT) ))
+#else
+#error "Define ARRAY_ARENA_POOL_ALIGN_ATTR (to align the default pool) for this compiler."
+#endif
+#endif
+#define ARENA_POOL_ALIGNMENT \
+   ( ((size_t)ARRAY_ARENA_POOL_ALIGNMENT > sizeof(void *)) ? (size_t)ARRAY_ARENA_POOL_ALIGNMENT : sizeof(void *) )
+#else
+#define ARRAY_ARENA_POOL_ALIGN_ATTR
+#define ARENA_POOL_ALIGNMENT sizeof(void *)
+#endif // ARRAY_ARENA_POOL_ALIGNMENT
+
+// How far buffer is from the next address aligned to align (a power of 2)
+#define ALIGN_UP_GAP(buffer, align) ( (size_t)( (0u - (uintptr_t)(buffer)) & ((uintptr_t)(align) - 1u) ) )
+
+#if defined(ARRAY_ARENA_SCHEME_BUMP)
+
+#ifdef ARRAY_ARENA_DEFRAG
+#error "ARRAY_ARENA_DEFRAG is not supported by ARRAY_ARENA_SCHEME_BUMP (a rewind already leaves no gaps)."
+#endif
+#ifdef ARRAY_ARENA_HANDLES
+#error "ARRAY_ARENA_HANDLES is not supported by ARRAY_ARENA_SCHEME_BUMP."
+#endif
+#ifdef ARRAY_ARENA_THREAD_SAFE
+#error "ARRAY_ARENA_THREAD_SAFE is not supported by ARRAY_ARENA_SCHEME_BUMP."
+#endif
+#ifdef ARRAY_ARENA_STATS
+#error "ARRAY_ARENA_STATS is not supported by ARRAY_ARENA_SCHEME_BUMP (the top of the arena is all there is to it)."
+#endif
+#ifdef ARRAY_ARENA_TELEMETRY
+#error "ARRAY_ARENA_TELEMETRY is not supported by ARRAY_ARENA_SCHEME_BUMP."
+#endif
+#ifdef ARRAY_ARENA_TAGS
+#error "ARRAY_ARENA_TAGS is not supported by ARRAY_ARENA_SCHEME_BUMP (blocks are handed back by the mark, not by owner)."
+#endif
+#ifdef ARRAY_ARENA_HARDENED
+#error "ARRAY_ARENA_HARDENED is not supported by ARRAY_ARENA_SCHEME_BUMP (blocks are only handed back by a rewind)."
+#endif
+#ifdef ARRAY_ARENA_PERSISTENT
+#error "ARRAY_ARENA_PERSISTENT is not supported by ARRAY_ARENA_SCHEME_BUMP."
+#endif
+#ifdef ARRAY_ARENA_SHARED
+#error "ARRAY_ARENA_SHARED is not supported by ARRAY_ARENA_SCHEME_BUMP."
+#endif
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+#error "ARRAY_ARENA_LAZY_COALESCE is not supported by ARRAY_ARENA_SCHEME_BUMP (there is nothing to coalesce)."
+#endif
+
+// Alignment of every block handed out by the bump allocator, relative to the
+// start of the arena. Must be a power of 2.
+#ifndef ARRAY_ARENA_BUMP_ALIGNMENT
+#define ARRAY_ARENA_BUMP_ALIGNMENT 8
+#endif
+#if ( (ARRAY_ARENA_BUMP_ALIGNMENT == 0) || ((ARRAY_ARENA_BUMP_ALIGNMENT & (ARRAY_ARENA_BUMP_ALIGNMENT - 1)) != 0) )
+#error "ARRAY_ARENA_BUMP_ALIGNMENT must be a power of 2"
+#endif
+
+// /w ARRAY_ARENA_CACHE_LINE_ISOLATION, every block starts on a line of its own
+#if defined(ARRAY_ARENA_CACHE_LINE_ISOLATION) && ( ARRAY_ARENA_BUMP_ALIGNMENT < ARRAY_ARENA_CACHE_LINE_SIZE )
+#define BUMP_BLOCK_ALIGNMENT ARRAY_ARENA_CACHE_LINE_SIZE
+#else
+#define BUMP_BLOCK_ALIGNMENT ARRAY_ARENA_BUMP_ALIGNMENT
+#endif
+
+#define BUMP_ALIGN_UP(offset) \
+   ( ((offset) + (BUMP_BLOCK_ALIGNMENT - 1)) & ~((size_t)BUMP_BLOCK_ALIGNMENT - 1) )
+#define BUMP_NO_LAST_ALLOC SIZE_MAX
+// A request that cannot be had is either one no pool of this size could ever
+// hold, or one there is no room left for above the top
+#define BUMP_FAIL_STATUS(arena, req_bytes) \
+   ( ((0 == (req_bytes)) || ((req_bytes) > (arena)->pool_size)) ? ARRAY_ARENA_TOO_LARGE : ARRAY_ARENA_OUT_OF_SPACE )
+
+struct ArrayArena_S
+{
+   uint8_t * pool; // The bytes blocks are allocated from
+   size_t pool_size;
+   size_t top; // Offset of the first byte that is not allocated
+   size_t last_alloc; // Offset of the most recent allocation, or BUMP_NO_LAST_ALLOC
+   bool arena_initialized;
+#ifdef ARRAY_ARENA_VIZ
+   size_t viz_top; // Top of the arena as of the last layout export
+   size_t viz_dirty_lo; // Bytes [lo, hi) may have changed since the last layout export
+   size_t viz_dirty_hi;
+#endif
+};
+
+//! The arena of contiguous bytes from which we allocate from.
+STATIC uint8_t ArrayArenaPool[VEC_ARRAY_ARENA_SIZE] ARRAY_ARENA_POOL_ALIGN_ATTR;
+
+// Nothing to set up at run-time for a bump allocator.
+STATIC struct ArrayArena_S ArrayArena =
+{
+   .pool = ArrayArenaPool,
+   .pool_size = VEC_ARRAY_ARENA_SIZE,
+   .top = 0,
+   .last_alloc = BUMP_NO_LAST_ALLOC,
+   .arena_initialized = true,
+#ifdef ARRAY_ARENA_VIZ
+   .viz_top = 0,
+   .viz_dirty_lo = 0,
+   .viz_dirty_hi = VEC_ARRAY_ARENA_SIZE
+#endif
+};
+
+/**
+ * @brief Initializes the static array pool arena structures.
+ * @note The bump arena is initialized at compile-time, so this is equivalent
+ *       to StaticArrayArenaReset().
+ */
+STATIC void StaticArrayPoolInit(void)
+{
+   StaticArrayArenaReset();
+}
+
+/**
+ * Check that the static array pool is initialized.
+ */
+STATIC bool StaticArrayPoolIsInitialized(void)
+{
+   return ArrayArenaIsInitialized( &ArrayArena );
+}
+
+STATIC void * StaticArrayAlloc(size_t req_bytes)
+{
+   return ArrayArenaAlloc( &ArrayArena, req_bytes );
+}
+
+STATIC void * StaticArrayAllocAligned(size_t req_bytes, size_t alignment)
+{
+   return ArrayArenaAllocAligned( &ArrayArena, req_bytes, alignment );
+}
+
+STATIC void * StaticArrayRealloc(void * ptr, size_t req_bytes)
+{
+   return ArrayArenaRealloc( &ArrayArena, ptr, req_bytes );
+}
+
+STATIC void StaticArrayFree(const void * ptr)
+{
+   ArrayArenaFree( &ArrayArena, ptr );
+}
+
+STATIC bool StaticArrayIsAlloc(const void * ptr)
+{
+   return ArrayArenaIsAlloc( &ArrayArena, ptr );
+}
+
+STATIC enum ArrayArenaStatus StaticArrayTryAlloc(size_t req_bytes, void ** ptr, size_t * granted)
+{
+   return ArrayArenaTryAlloc( &ArrayArena, req_bytes, ptr, granted );
+}
+
+STATIC enum ArrayArenaStatus StaticArrayTryRealloc(void ** ptr, size_t req_bytes, size_t * granted)
+{
+   return ArrayArenaTryRealloc( &ArrayArena, ptr, req_bytes, granted );
+}
+
+STATIC enum ArrayArenaStatus StaticArrayTryFree(const void * ptr)
+{
+   return ArrayArenaTryFree( &ArrayArena, ptr );
+}
+
+STATIC size_t StaticArrayAllocBatch(size_t req_bytes, size_t n, void * out[])
+{
+   return ArrayArenaAllocBatch( &ArrayArena, req_bytes, n, out );
+}
+
+STATIC void StaticArrayFreeBatch(void * const ptrs[], size_t n)
+{
+   ArrayArenaFreeBatch( &ArrayArena, ptrs, n );
+}
+
+STATIC ArrayArenaMark_T StaticArrayArenaMark(void)
+{
+   return ArrayArenaMark( &ArrayArena );
+}
+
+STATIC void StaticArrayArenaRewind(ArrayArenaMark_T mark)
+{
+   ArrayArenaRewind( &ArrayArena, mark );
+}
+
+STATIC void StaticArrayArenaReset(void)
+{
+   ArrayArenaReset( &ArrayArena );
+}
+
+/**
+ * @brief Set up an arena over the len bytes at buffer, all of which are
+ *        handed out as blocks (the bump allocator keeps no metadata in it),
+ *        save for any it takes to align the start of the pool.
+ * @return true if successful; false if there is no buffer to speak of
+ */
+STATIC bool ArrayArenaInit(struct ArrayArena_S * arena, void * buffer, size_t len)
+{
+   if ( (NULL == arena) || (NULL == buffer) )   return false;
+
+   size_t align_gap = ALIGN_UP_GAP( buffer, ARENA_POOL_ALIGNMENT );
+   if ( align_gap >= len )   return false;
+
+   arena->pool = (uint8_t *)buffer + align_gap;
+   arena->pool_size = len - align_gap;
+   arena->top = 0;
+   arena->last_alloc = BUMP_NO_LAST_ALLOC;
+   arena->arena_initialized = true;
+#ifdef ARRAY_ARENA_VIZ
+   arena->viz_top = 0;
+   ArrayArenaVizRefresh( arena );
+#endif
+   return true;
+}
+
+/**
+ * Check that an arena is initialized.
+ */
+STATIC bool ArrayArenaIsInitialized(const struct ArrayArena_S * arena)
+{
+   return arena->arena_initialized;
+}
+
+/**
+ * @brief Allocates a contiguous block of req_bytes from the top of the arena.
+ * @return Pointer to the allocated block if successful, NULL otherwise.
+ */
+STATIC void * ArrayArenaAlloc(struct ArrayArena_S * arena, size_t req_bytes)
+{
+   return ArrayArenaAllocAligned( arena, req_bytes, 1 );
+}
+
+/**
+ * @brief Allocates a contiguous block of req_bytes from the top of the arena,
+ *        at an address that is a multiple of alignment (a power of 2).
+ * @note Any bytes skipped over to get to that address are lost until the
+ *       arena is rewound past them.
+ * @return Pointer to the allocated block if successful, NULL otherwise.
+ */
+STATIC void * ArrayArenaAllocAligned(struct ArrayArena_S * arena, size_t req_bytes, size_t alignment)
+{
+   if ( (0 == alignment) || ((alignment & (alignment - 1)) != 0) )   return NULL;
+
+   size_t offset = BUMP_ALIGN_UP( arena->top );
+   if ( offset > arena->pool_size )   return NULL;
+   offset += ALIGN_UP_GAP( (uintptr_t)arena->pool + offset, alignment );
+
+   if ( (0 == req_bytes) ||
+        (offset > arena->pool_size) ||
+        (req_bytes > (arena->pool_size - offset)) )
+   {
+      return NULL;
+   }
+
+   arena->last_alloc = offset;
+   arena->top = offset + req_bytes;
+   return &arena->pool[offset];
+}
+
+/**
+ * @brief Resizes a block. The most recent allocation is resized in place;
+ *        any other block is moved to the top of the arena.
+ * @note The bump allocator does not track the size of older blocks, so when
+ *       one is moved, up to req_bytes are copied (never past the top of the
+ *       arena). The bytes past the old block's end are unspecified, as /w an
+ *       ordinary realloc that grows.
+ */
+STATIC void * ArrayArenaRealloc(struct ArrayArena_S * arena, void * ptr, size_t req_bytes)
+{
+   void * new_ptr = ptr;
+   enum ArrayArenaStatus status = ArrayArenaTryRealloc( arena, &new_ptr, req_bytes, NULL );
+
+   return (ARRAY_ARENA_INVALID_PTR == status) ? NULL : new_ptr;
+}
+
+/**
+ * @brief Allocates a contiguous block of req_bytes from the top of the arena.
+ * @return ARRAY_ARENA_OK if successful; ARRAY_ARENA_TOO_LARGE for more bytes
+ *         than the pool (or none at all); ARRAY_ARENA_OUT_OF_SPACE otherwise
+ */
+STATIC enum ArrayArenaStatus ArrayArenaTryAlloc(struct ArrayArena_S * arena, size_t req_bytes,
+                                                void ** ptr, size_t * granted)
+{
+   *ptr = ArrayArenaAlloc( arena, req_bytes );
+   if ( granted != NULL )   *granted = (*ptr != NULL) ? req_bytes : 0;
+
+   if ( *ptr != NULL )   return ARRAY_ARENA_OK;
+   return BUMP_FAIL_STATUS( arena, req_bytes );
+}
+
+/**
+ * @brief Resizes the block at *ptr as ArrayArenaRealloc() does, updating *ptr
+ *        if the block is moved.
+ */
+STATIC enum ArrayArenaStatus ArrayArenaTryRealloc(struct ArrayArena_S * arena, void ** ptr,
+                                                  size_t req_bytes, size_t * granted)
+{
+   if ( granted != NULL )   *granted = 0;
+
+   if ( !ArrayArenaIsAlloc( arena, *ptr ) )
+   {
+      return ARRAY_ARENA_INVALID_PTR;
+   }
+   else if ( 0 == req_bytes )
+   {
+      ArrayArenaFree( arena, *ptr );
+      *ptr = NULL;
+      return ARRAY_ARENA_OK;
+   }
+
+   size_t offset = (size_t)((uint8_t *)*ptr - arena->pool);
+
+   if ( offset == arena->last_alloc )
+   {
+      if ( req_bytes > (arena->pool_size - offset) )   return BUMP_FAIL_STATUS( arena, req_bytes );
+      arena->top = offset + req_bytes;
+      if ( granted != NULL )   *granted = req_bytes;
+      return ARRAY_ARENA_OK;
+   }
+
+   size_t old_top = arena->top;
+   void * tmp = ArrayArenaAlloc( arena, req_bytes );
+   if ( NULL == tmp )   return BUMP_FAIL_STATUS( arena, req_bytes );
+
+   size_t num_of_bytes = old_top - offset;
+   if ( req_bytes < num_of_bytes )   num_of_bytes = req_bytes;
+   memmove( tmp, *ptr, num_of_bytes );
+   *ptr = tmp;
+   if ( granted != NULL )   *granted = req_bytes;
+   return ARRAY_ARENA_OK;
+}
+
+/**
+ * @brief Free the block at the address passed in, if applicable.
+ * @note Only the most recent allocation is actually released (LIFO). Freeing
+ *       any other block is a no-op; release those /w ArrayArenaRewind() or
+ *       ArrayArenaReset().
+ * @param[in] Address of block to free
+ */
+STATIC void ArrayArenaFree(struct ArrayArena_S * arena, const void * ptr)
+{
+   (void)ArrayArenaTryFree( arena, ptr );
+}
+
+/**
+ * @brief Free the block at ptr as ArrayArenaFree() does.
+ * @return ARRAY_ARENA_OK, or ARRAY_ARENA_INVALID_PTR if ptr is not below the
+ *         top of the arena (or not in it at all)
+ */
+STATIC enum ArrayArenaStatus ArrayArenaTryFree(struct ArrayArena_S * arena, const void * ptr)
+{
+   if ( NULL == ptr )   return ARRAY_ARENA_OK;
+   if ( !ArrayArenaIsAlloc( arena, ptr ) )   return ARRAY_ARENA_INVALID_PTR;
+
+   size_t offset = (size_t)((const uint8_t *)ptr - arena->pool);
+   if ( offset == arena->last_alloc )
+   {
+      arena->top = offset;
+      // The allocation before this one is not tracked
+      arena->last_alloc = BUMP_NO_LAST_ALLOC;
+   }
+   return ARRAY_ARENA_OK;
+}
+
+/**
+ * @brief Determine whether an address is inside the allocated part of the arena.
+ */
+STATIC bool ArrayArenaIsAlloc(struct ArrayArena_S * arena, const void * ptr)
+{
+   if ( NULL == ptr )   return false;
+
+   uintptr_t addr = (uintptr_t)ptr;
+   uintptr_t base = (uintptr_t)arena->pool;
+   return (addr >= base) && (addr < (base + arena->top));
+}
+
+/**
+ * @brief Allocate n blocks of req_bytes each, back-to-back from the top of the arena.
+ * @return How many blocks were allocated (into out[0], out[1], ...)
+ */
+STATIC size_t ArrayArenaAllocBatch(struct ArrayArena_S * arena, size_t req_bytes, size_t n, void * out[])
+{
+   size_t num_of_blks = 0;
+   while ( num_of_blks < n )
+   {
+      out[num_of_blks] = ArrayArenaAlloc( arena, req_bytes );
+      if ( NULL == out[num_of_blks] )   break;
+      num_of_blks++;
+   }
+
+   for ( size_t i = num_of_blks; i < n; i++ )   out[i] = NULL;
+   return num_of_blks;
+}
+
+/**
+ * @brief Free the blocks at the addresses passed in, if applicable.
+ * @note As /w ArrayArenaFree(), only the most recent allocation is actually
+ *       released. To release a whole batch, rewind to a mark taken before it.
+ */
+STATIC void ArrayArenaFreeBatch(struct ArrayArena_S * arena, void * const ptrs[], size_t n)
+{
+   // Most recent first, in case the batch was allocated in order
+   while ( n-- > 0 )   ArrayArenaFree( arena, ptrs[n] );
+}
+
+/**
+ * @brief Snapshot of the top of the arena, to later release everything
+ *        allocated after this point /w ArrayArenaRewind().
+ */
+STATIC ArrayArenaMark_T ArrayArenaMark(const struct ArrayArena_S * arena)
+{
+   return arena->top;
+}
+
+/**
+ * @brief Release every block allocated since mark was taken.
+ */
+STATIC void ArrayArenaRewind(struct ArrayArena_S * arena, ArrayArenaMark_T mark)
+{
+   assert( mark <= arena->top );
+   if ( mark > arena->top )   return;
+
+   arena->top = mark;
+   arena->last_alloc = BUMP_NO_LAST_ALLOC;
+}
+
+/**
+ * @brief Release every block in the arena.
+ */
+STATIC void ArrayArenaReset(struct ArrayArena_S * arena)
+{
+   ArrayArenaRewind( arena, 0 );
+}
+
+#ifdef ARRAY_ARENA_VIZ
+// The layout is wholly determined by the top of the arena, so rather than
+// tracking every alloc and free, what has changed is worked out at export time
+// from how far the top has moved.
+static void Helper_VizSync( struct ArrayArena_S * arena )
+{
+   if ( arena->top == arena->viz_top )   return;
+
+   size_t lo = (arena->top < arena->viz_top) ? arena->top : arena->viz_top;
+   size_t hi = (arena->top < arena->viz_top) ? arena->viz_top : arena->top;
+   if ( arena->viz_dirty_lo >= arena->viz_dirty_hi )
+   {
+      arena->viz_dirty_lo = lo;
+      arena->viz_dirty_hi = hi;
+   }
+   else
+   {
+      if ( lo < arena->viz_dirty_lo )   arena->viz_dirty_lo = lo;
+      if ( hi > arena->viz_dirty_hi )   arena->viz_dirty_hi = hi;
+   }
+   arena->viz_top = arena->top;
+}
+
+// The allocated part of the arena (below the top) is one block as far as the
+// visualizer can tell, and the free part above it is another.
+static size_t Helper_VizBlockAt( const struct ArrayArena_S * arena, size_t offset, enum ArenaVizBlkState * state )
+{
+   if ( offset < arena->top )
+   {
+      *state = ARENA_VIZ_BLK_ALLOCATED;
+      return arena->top - offset;
+   }
+
+   *state = ARENA_VIZ_BLK_FREE;
+   return arena->pool_size - offset;
+}
+#endif // ARRAY_ARENA_VIZ
+
+#else // Segregated free-lists
+
+// Macro constants for the iniital length of each free list.
+// Ideally, the distribution of the initial lengths will match the distribution
+// of requests during runtime. This minimizes the amount of times splitting and
+// coalescing has to happen.
+// Since that's not really going to be possible up front, one can either go
+// through the discretize_arena.py Python script, write their own initial lens,
+// or use the default below which starts at the largest size and goes down.
+// Once there is a workload to go by, the tune_arena.py script picks the lens
+// (and the block sizes) that do best on a recorded trace of it.
+// The discretize_arena.py script also emits the resulting free bitmaps, which
+// lets the arena be set up entirely at compile-time (see
+// ARRAY_ARENA_CFG_HAS_INIT_TABLES below).
+// array_arena_cfg.h (if USE_EXTERNAL_INIT_LENS) is included by sara.h, since it
+// also sets the block sizes (ARRAY_ARENA_BLOCK_SIZES), which the size classes
+// there are worked out from.
+
+// If defined, requests that fit in 3/4 of a block are granted a block of half
+// that size plus the quarter-size block after it, and the last quarter is
+// returned to the free lists. E.g., a 300 byte request takes 384 bytes (a 256
+// block and the 128 block after it) rather than a 512 block, so the sizes in
+// between powers of 2 are 96, 192, 384, and 768 for the default sizes (and 48
+// if 16 is added). This bounds internal fragmentation to 1/3 rather than 1/2.
+// ARRAY_ARENA_INTERMEDIATE_SIZES
+
+#define X_BLOCK_SIZE_ENUM(sz)       BLKS_##sz,
+#define X_BLOCK_SIZE_INT(sz)        (sz),
+#define X_BLOCK_SIZE_SUM(sz)        + (sz)
+#define X_BLOCK_SIZE_WEIGHTED(sz)   + ((sz) * BLKS_##sz)
+#define X_BLOCK_SIZE_IS_POW2(sz)    && (((sz) & ((sz) - 1)) == 0)
+
+enum BlockSize
+{
+   ARRAY_ARENA_BLOCK_SIZES(X_BLOCK_SIZE_ENUM)
+   NUM_OF_BLOCK_SIZES,
+   BLKS_LARGEST_SIZE = 0
+};
+
+// N sizes that are each half of the one before sum to SMALLEST * (2^N - 1),
+// which gives us the smallest and largest sizes as constant expressions.
+enum
+{
+   BLOCK_SIZES_SUM = 0 ARRAY_ARENA_BLOCK_SIZES(X_BLOCK_SIZE_SUM),
+   SMALLEST_BLOCK_SIZE = BLOCK_SIZES_SUM / ((1 << NUM_OF_BLOCK_SIZES) - 1),
+   LARGEST_BLOCK_SIZE = SMALLEST_BLOCK_SIZE << (NUM_OF_BLOCK_SIZES - 1)
+};
+
+// Compile-time checks on ARRAY_ARENA_BLOCK_SIZES: all powers of 2 that add up
+// as described above (only possible if each is a distinct power of 2 from the
+// smallest to the largest), in descending order (weighting each size by its
+// enum gives SMALLEST * (2^N - N - 1) only for descending order).
+typedef char ArrayArena_BlockSizesArePow2[ (1 ARRAY_ARENA_BLOCK_SIZES(X_BLOCK_SIZE_IS_POW2)) ? 1 : -1 ];
+typedef char ArrayArena_BlockSizesAreHalvings[
+   ((BLOCK_SIZES_SUM % ((1 << NUM_OF_BLOCK_SIZES) - 1)) == 0) &&
+   ((SMALLEST_BLOCK_SIZE & (SMALLEST_BLOCK_SIZE - 1)) == 0) ? 1 : -1 ];
+typedef char ArrayArena_BlockSizesAreDescending[
+   ((0 ARRAY_ARENA_BLOCK_SIZES(X_BLOCK_SIZE_WEIGHTED)) ==
+    (SMALLEST_BLOCK_SIZE * ((1 << NUM_OF_BLOCK_SIZES) - NUM_OF_BLOCK_SIZES - 1))) ? 1 : -1 ];
+typedef char ArrayArena_BlockSizesFitInU16[ (LARGEST_BLOCK_SIZE <= UINT16_MAX) ? 1 : -1 ];
+// The size classes of sara.h are these block sizes, numbered as enum BlockSize
+typedef char ArrayArena_ClassesAreBlockSizes[
+   (((int)ARRAY_ARENA_NUM_OF_CLASSES == (int)NUM_OF_BLOCK_SIZES) &&
+    ((int)ARRAY_ARENA_LARGEST_CLASS_BYTES == (int)LARGEST_BLOCK_SIZE)) ? 1 : -1 ];
+#ifdef ARRAY_ARENA_CACHE_LINE_ISOLATION
+// A line has to be one of the block sizes for requests to be rounded up to it
+typedef char ArrayArena_CacheLineIsABlockSize[
+   ((ARRAY_ARENA_CACHE_LINE_SIZE >= SMALLEST_BLOCK_SIZE) && (ARRAY_ARENA_CACHE_LINE_SIZE <= LARGEST_BLOCK_SIZE)) ? 1 : -1 ];
+#endif
+
+static size_t BlockSize_E_to_Int[NUM_OF_BLOCK_SIZES] = { ARRAY_ARENA_BLOCK_SIZES(X_BLOCK_SIZE_INT) };
+
+// Macro constant for the capacity of each free list.
+// The lists are statically sized so that theoretically, the full static array
+// arena can be owned by any single list. This is done because we have to account
+// for the run-time dynamics of these lists shifting ownership of the arena in
+// all sorts of strange and mysterious ways in practice. We may start off with
+// the 1024 list owning the majority of the arena, and over time, each 1024
+// blocks may be split off, theoretically until all the blocks are 32-byte sized.
+// Of course, we cannot dynamically size the memory used by these lists because,
+// these lists are the handlers of dynamic memory, so their overhead must be set
+// up front!
+#define LIST_CAPACITY(pool_size, sz) (( (pool_size) / (sz) ) + 1)
+#define BLOCKS_LIST_CAPACITY(sz) LIST_CAPACITY( VEC_ARRAY_ARENA_SIZE, (sz) )
+
+// Each list keeps one bit per block it could ever own, packed into words.
+#define FREE_MAP_WORD_BITS 32
+#define FREE_MAP_WORDS(capacity) ( ((capacity) + FREE_MAP_WORD_BITS - 1) / FREE_MAP_WORD_BITS )
+
+#ifdef ARRAY_ARENA_REALTIME
+#ifdef ARRAY_ARENA_THREAD_SAFE
+#error "ARRAY_ARENA_REALTIME cannot be combined /w ARRAY_ARENA_THREAD_SAFE (the lock and the remote-free drains are unbounded)."
+#endif
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+#error "ARRAY_ARENA_REALTIME cannot be combined /w ARRAY_ARENA_LAZY_COALESCE (an alloc may have to merge the whole arena)."
+#endif
+// Bit w of a list's summary is set iff word w of its bitmap has a free block,
+// and bit s of its top word iff summary word s does, so that the lowest free
+// block is found by a ctz at each level. The one top word covers up to
+// FREE_MAP_WORD_BITS^3 blocks per list.
+#define FREE_SUMMARY_WORDS(map_words) FREE_MAP_WORDS(map_words)
+#define REALTIME_MAX_MAP_WORDS ( FREE_MAP_WORD_BITS * FREE_MAP_WORD_BITS )
+typedef char ArrayArena_RealtimeListsFitTopWord[
+   (FREE_MAP_WORDS(BLOCKS_LIST_CAPACITY(SMALLEST_BLOCK_SIZE)) <= REALTIME_MAX_MAP_WORDS) ? 1 : -1 ];
+#endif // ARRAY_ARENA_REALTIME
+
+// Largest size first, then whatever is left over goes to the smaller sizes
+#define DEFAULT_LIST_INIT_LEN(pool_size, sz) \
+   ( ((sz) == LARGEST_BLOCK_SIZE) ? ((pool_size) / (sz)) \
+                                  : (((pool_size) % (2 * (sz))) / (sz)) )
+
+#ifdef USE_EXTERNAL_INIT_LENS
+#define LIST_INIT_LEN(sz) BLOCKS_##sz##_LIST_INIT_LEN
+#else
+#define LIST_INIT_LEN(sz) DEFAULT_LIST_INIT_LEN( VEC_ARRAY_ARENA_SIZE, (sz) )
+#endif // USE_EXTERNAL_INIT_LENS
+
+#ifdef ARRAY_ARENA_CFG_HAS_INIT_TABLES
+#if ( ARRAY_ARENA_CFG_ARENA_SIZE != VEC_ARRAY_ARENA_SIZE )
+#error "array_arena_cfg.h was generated for a different VEC_ARRAY_ARENA_SIZE. Re-run scripts/discretize_arena.py."
+#endif
+#if defined(ARRAY_ARENA_REALTIME) && !defined(ARRAY_ARENA_CFG_HAS_SUMMARY_TABLES)
+#error "array_arena_cfg.h predates the ARRAY_ARENA_REALTIME summary bitmaps. Re-run scripts/discretize_arena.py."
+#endif
+#endif // ARRAY_ARENA_CFG_HAS_INIT_TABLES
+
+// Blocks are never moved, and every block of a given size sits at an offset
+// into the arena that is a multiple of that size (the lists are laid out in
+// descending order, and splitting a block in half preserves this). So rather
+// than storing a pointer per block, a block is identified by its list and its
+// offset / block_size, and the list tracks which of those are free in a bitmap.
+struct ArrayPoolBlockList_S
+{
+   uint32_t * free_map; // Bit i set <=> block at offset (i * block_size) is free
+   size_t map_words; // How many words are in free_map
+   uint16_t block_size; // Size of blocks in this list in bytes
+   size_t len; // How many free blocks are in this list
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+   size_t unmerged; // Blocks freed into this list since it was last merged
+#endif
+#ifdef ARRAY_ARENA_REALTIME
+   uint32_t * free_summary; // Bit w set <=> free_map[w] != 0
+   uint32_t free_top; // Bit s set <=> free_summary[s] != 0
+#endif
+};
+
+#ifdef ARRAY_ARENA_DEFRAG
+// Compaction walks the granule table from the end of the arena toward the
+// start, moving each movable block it comes across into the lowest free block
+// that fits it, if that is lower than where the block already is. The old
+// block is then freed, which lets the free space at the end merge back up into
+// large blocks. The walk picks up where it left off on the next call, so it
+// can be done a little at a time.
+struct ArrayArenaDefrag_S
+{
+   ArrayArenaRelocateCb_T relocate_cb;
+   void * relocate_ctx;
+   size_t cursor; // Granule to look at next is the one before this
+   bool moved_this_pass; // Whether any block has been moved since the walk last wrapped around
+};
+#endif // ARRAY_ARENA_DEFRAG
+
+#ifdef ARRAY_ARENA_HANDLES
+struct ArrayArenaHandle_S
+{
+   void * ptr; // Block the handle refers to (NULL while the handle is free)
+   uint16_t pins; // How many more times the handle has been locked than unlocked
+   ArrayArenaHandle_T next_free; // While the handle is free, the next free one (or the null handle)
+};
+
+// Handles are handed out the same way the fixed-object size pools hand out
+// slots: off a free list, or failing that, the next never-used one in order.
+struct ArrayArenaHandleTable_S
+{
+   struct ArrayArenaHandle_S entries[ARRAY_ARENA_MAX_HANDLES + 1]; // [ARRAY_ARENA_NULL_HANDLE] is unused
+   ArrayArenaHandle_T free_head;
+   size_t num_untouched; // First handle that has never been handed out
+};
+#endif // ARRAY_ARENA_HANDLES
+
+#ifdef ARRAY_ARENA_STATS
+struct ArrayArenaClassStats_S
+{
+   size_t allocs; // Blocks handed out
+   size_t frees; // Blocks handed back
+   size_t fails; // Requests that this was the best fit for, but could not be granted
+   size_t splits; // Blocks split in halves to make smaller ones
+   size_t coalesces; // Pairs of buddies merged into one of the next size up
+   size_t live_blocks; // Blocks presently allocated
+   size_t peak_live_blocks; // High-water mark of live_blocks
+};
+
+// Bucket i of a cycle histogram counts the calls that took from 2^i up to
+// 2^(i+1) cycles, and the last bucket counts everything slower than that.
+#ifndef ARRAY_ARENA_CYCLE_BUCKETS
+#define ARRAY_ARENA_CYCLE_BUCKETS 16
+#endif
+
+struct ArrayArenaStats_S
+{
+   struct ArrayArenaClassStats_S classes[NUM_OF_BLOCK_SIZES];
+   size_t bytes_in_use; // Bytes of the blocks presently allocated
+   size_t peak_bytes_in_use; // High-water mark of bytes_in_use
+   size_t bytes_requested; // Bytes asked for, over all allocs
+   size_t bytes_granted; // Bytes handed out, over all allocs (the excess over bytes_requested is internal fragmentation)
+#ifdef ARRAY_ARENA_STATS_CYCLES
+   size_t alloc_cycles[ARRAY_ARENA_CYCLE_BUCKETS];
+   size_t free_cycles[ARRAY_ARENA_CYCLE_BUCKETS];
+#endif
+};
+// ArrayArenaGetStats() copies the stats out one counter at a time
+typedef char ArrayArena_StatsAreAllCounters[ ((sizeof(struct ArrayArenaStats_S) % sizeof(size_t)) == 0) ? 1 : -1 ];
+#endif // ARRAY_ARENA_STATS
+
+#ifdef ARRAY_ARENA_TELEMETRY
+// Records per telemetry ring. A power of 2, and small enough for a record's
+// seq to tell the record that was last written to a slot from the one before.
+#ifndef ARRAY_ARENA_TELEMETRY_RING_LEN
+#define ARRAY_ARENA_TELEMETRY_RING_LEN 64
+#endif
+typedef char ArrayArena_TelemRingLenIsPow2[ ((ARRAY_ARENA_TELEMETRY_RING_LEN & (ARRAY_ARENA_TELEMETRY_RING_LEN - 1)) == 0) ? 1 : -1 ];
+typedef char ArrayArena_TelemRingLenFitsSeq[ ((ARRAY_ARENA_TELEMETRY_RING_LEN > 0) && (ARRAY_ARENA_TELEMETRY_RING_LEN <= 0x8000)) ? 1 : -1 ];
+typedef char ArrayArena_TelemRecIsPacked[ (sizeof(struct ArrayArenaTelemRec_S) == 16) ? 1 : -1 ];
+
+// Records are written at head and drained from tail, both of which only ever
+// count up (the slot is the position mod the ring length). A slot's record is
+// only there to be drained once its seq has been set to its position + 1,
+// which is the last thing written to it, so a record that is still being
+// written (or the stale one from a lap before) is never sent.
+struct ArrayArenaTelemRing_S
+{
+   struct ArrayArenaTelemRec_S * recs;
+   size_t head; // Next position to write to
+   size_t tail; // Next position to drain
+   size_t dropped; // Records that did not fit, since the last drain
+   bool info_pending; // Whether the next drain starts by describing the arena (INFO records)
+};
+#endif // ARRAY_ARENA_TELEMETRY
+
+#ifdef ARRAY_ARENA_TAGS
+// Tags fit the side table's bytes, and the mask of tags a drain is yet to send
+typedef char ArrayArena_MaxTagsFitMask[ ((ARRAY_ARENA_MAX_TAGS > 0) && (ARRAY_ARENA_MAX_TAGS <= 32)) ? 1 : -1 ];
+#endif
+
+#ifdef ARRAY_ARENA_PERSISTENT
+#ifdef ARRAY_ARENA_HANDLES
+#error "ARRAY_ARENA_PERSISTENT cannot yet be combined /w ARRAY_ARENA_HANDLES (the handle table is not in the buffer)."
+#endif
+
+// Header at the start of a persistent arena's buffer, right before the pool.
+// The fields are laid out so that there is no padding to leave uninitialized.
+#define ARRAY_ARENA_PERSIST_MAGIC    0x41524131u // "1ARA" in a little-endian dump
+#define ARRAY_ARENA_PERSIST_VERSION  2u
+struct ArrayArenaPersistHdr_S
+{
+   uint32_t magic; // ARRAY_ARENA_PERSIST_MAGIC (which also tells a buffer of the other byte order)
+   uint16_t version; // ARRAY_ARENA_PERSIST_VERSION of the layout below and of the metadata
+   uint16_t hdr_size;
+   uint32_t layout; // Fingerprint of the compile-time config that shapes the metadata
+   uint32_t checksum; // FNV-1a over the whole header, /w this field as 0
+   uint64_t len; // Bytes of the buffer the arena was set up over, from the header on
+   uint64_t pool_size;
+   uint64_t space; // Bytes of the pool laid out in blocks, which every free and allocated block adds up to
+};
+typedef char ArrayArena_PersistHdrIsPacked[ (sizeof(struct ArrayArenaPersistHdr_S) == 40) ? 1 : -1 ];
+
+#ifdef ARRAY_ARENA_SHARED
+// The queue of blocks freed by peers is a Treiber stack of block offsets, its
+// links in the blocks themselves. Peers push onto it /w a compare-and-swap,
+// and the owner takes the whole of it in one exchange, so that there is no
+// ABA to worry about for pops, and no lock that would have to be shared.
+#if !defined(__GNUC__) || !defined(__GCC_ATOMIC_INT_LOCK_FREE) || (__GCC_ATOMIC_INT_LOCK_FREE != 2)
+#error "ARRAY_ARENA_SHARED needs lock-free 32-bit GCC-style __atomic builtins for this target (a libatomic lock is not shared between processes)."
+#endif
+#ifdef ARRAY_ARENA_REALTIME
+#error "ARRAY_ARENA_SHARED cannot be combined /w ARRAY_ARENA_REALTIME (taking back what peers freed has no bound)."
+#endif
+#define ARRAY_ARENA_NO_REMOTE_FREE UINT32_MAX
+struct ArrayArenaSharedHdr_S
+{
+   uint32_t remote_free_head; // Offset of the block last freed by a peer (or ARRAY_ARENA_NO_REMOTE_FREE)
+   uint32_t reserved;
+};
+#define SHARED_HDR_BYTES sizeof(struct ArrayArenaSharedHdr_S)
+#else
+#define SHARED_HDR_BYTES 0
+#endif // ARRAY_ARENA_SHARED
+
+// The pool starts on the next pool alignment after the header(s)
+#define PERSIST_HDR_BYTES \
+   ( ((sizeof(struct ArrayArenaPersistHdr_S) + SHARED_HDR_BYTES + ARENA_POOL_ALIGNMENT - 1) / ARENA_POOL_ALIGNMENT) * \
+     ARENA_POOL_ALIGNMENT )
+// The header is only ever copied in or out, as the pool need not be aligned for a uint64_t
+#define PERSIST_HDR_AT(arena) ( (arena)->pool - PERSIST_HDR_BYTES )
+#define FNV1A_OFFSET_BASIS 2166136261u
+#define FNV1A_PRIME        16777619u
+#elif defined(ARRAY_ARENA_SHARED)
+#error "ARRAY_ARENA_SHARED needs ARRAY_ARENA_PERSISTENT."
+#endif // ARRAY_ARENA_PERSISTENT
+
+// Everything an arena needs lives in (or is pointed to by) one of these, so
+// that arenas are independent of one another. The default arena's tables are
+// statically allocated; any other arena's are carved out of the end of the
+// buffer it is set up over (see ArrayArenaInit()).
+struct ArrayArena_S
+{
+   struct ArrayPoolBlockList_S lists[NUM_OF_BLOCK_SIZES];
+   bool arena_initialized;
+   size_t space_available;
+   uint8_t * pool; // The bytes blocks are allocated from
+   size_t pool_size;
+   uint8_t * granules; // Granule -> entry for the allocated block starting there (or BLOCK_SZ_NONE)
+   size_t * run_lens; // Largest-block idx -> length of the large allocation run starting there (or 0)
+#ifdef ARRAY_ARENA_DEFRAG
+   struct ArrayArenaDefrag_S defrag;
+#endif
+#ifdef ARRAY_ARENA_HANDLES
+   struct ArrayArenaHandleTable_S handles;
+#ifdef ARRAY_ARENA_DEFRAG
+   ArrayArenaHandle_T * granule_handles; // Granule -> handle of the block starting there (or the null handle)
+#endif
+#endif
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   bool lock_flag; // For the default ARRAY_ARENA_LOCK()
+#endif
+#ifdef ARRAY_ARENA_STATS
+   struct ArrayArenaStats_S stats;
+#endif
+#ifdef ARRAY_ARENA_VIZ
+   size_t viz_dirty_lo; // Bytes [lo, hi) may have changed since the last layout export
+   size_t viz_dirty_hi;
+#endif
+#ifdef ARRAY_ARENA_TELEMETRY
+   struct ArrayArenaTelemRing_S telem;
+#endif
+#ifdef ARRAY_ARENA_HARDENED
+   ArrayArenaFaultCb_T fault_cb;
+   void * fault_ctx;
+   size_t faults[NUM_OF_ARRAY_ARENA_FAULTS]; // How many of each kind of fault there have been
+#endif
+#ifdef ARRAY_ARENA_SHARED
+   uint32_t * remote_free_head; // The queue of blocks freed by peers, in the buffer's header (NULL for the default arena)
+#endif
+#ifdef ARRAY_ARENA_TAGS
+   ArrayArenaTag_T * granule_tags; // Granule -> tag of the allocated block starting there (or ARRAY_ARENA_UNTAGGED)
+   ArrayArenaTag_T alloc_tag; // Tag that blocks being indexed are given
+   struct ArrayArenaTagStats_S tag_stats[ARRAY_ARENA_MAX_TAGS];
+#ifdef ARRAY_ARENA_TELEMETRY
+   uint32_t tags_dirty; // Tags whose holdings changed since their last TAG record
+#endif
+#endif
+};
+
+// An allocated block, as resolved from the pointer handed out for it
+struct ArrayPoolBlock_S
+{
+   enum BlockSize sz; // List the (head) block belongs to
+   size_t idx; // Idx of the (head) block within its list
+   bool trimmed; // Whether the half-size block right after the head is part of it (ARRAY_ARENA_INTERMEDIATE_SIZES)
+   bool movable; // Whether the block may be relocated by compaction (ARRAY_ARENA_DEFRAG)
+   size_t run_len; // For a large allocation, how many largest blocks are in its run (0 otherwise)
+};
+
+// Every block offset is a multiple of the smallest block size, so the arena can
+// be viewed as an array of granules of that size. Each granule that is the
+// start of an allocated block records which list the block belongs to, which
+// lets us resolve a pointer to its block in constant time instead of scanning
+// all of the lists. Free blocks are already described by the free bitmaps, so
+// they need no entry, and the table starts out (statically) all-zero.
+#define ARRAY_ARENA_GRANULE_SIZE SMALLEST_BLOCK_SIZE
+#define ARRAY_ARENA_NUM_OF_GRANULES ( VEC_ARRAY_ARENA_SIZE / ARRAY_ARENA_GRANULE_SIZE )
+#define ARENA_NUM_OF_GRANULES(arena) ( (arena)->pool_size / ARRAY_ARENA_GRANULE_SIZE )
+#define BLOCK_SZ_NONE 0
+#define GRANULE_ENTRY_TRIMMED 0x80u
+#define GRANULE_ENTRY_MOVABLE 0x40u
+#define GRANULE_ENTRY_FLAGS   ( GRANULE_ENTRY_TRIMMED | GRANULE_ENTRY_MOVABLE )
+#define BLOCK_SZ_TO_GRANULE_ENTRY(blk_sz) ((uint8_t)((blk_sz) + 1))
+#define GRANULE_ENTRY_TO_BLOCK_SZ(entry)  ((enum BlockSize)(((entry) & ~GRANULE_ENTRY_FLAGS) - 1))
+// ArrayArenaInit() puts the metadata right after the pool, which must leave it aligned
+typedef char ArrayArena_GranulesAlignMetadata[ ((ARRAY_ARENA_GRANULE_SIZE % sizeof(size_t)) == 0) ? 1 : -1 ];
+typedef char ArrayArena_BlockSizesFitInGranuleEntry[ (BLOCK_SZ_TO_GRANULE_ENTRY(NUM_OF_BLOCK_SIZES) < GRANULE_ENTRY_MOVABLE) ? 1 : -1 ];
+
+//! The arena of contiguous bytes from which we allocate from. (The union is
+//! only there so that blocks are at least aligned for a pointer.)
+STATIC union
+{
+   uint8_t bytes[VEC_ARRAY_ARENA_SIZE];
+   void * ptr_alignment;
+} ArrayArenaPoolStorage ARRAY_ARENA_POOL_ALIGN_ATTR;
+#define ArrayArenaPool ( ArrayArenaPoolStorage.bytes )
+
+// These shall be the free bitmaps of allocatable blocks (the "free lists").
+#ifdef ARRAY_ARENA_CFG_HAS_INIT_TABLES
+// Initial contents come straight from the generated array_arena_cfg.h, so
+// there is nothing left for StaticArrayPoolInit() to do at boot.
+#define X_FREE_MAP(sz) \
+   static uint32_t free_map_##sz[FREE_MAP_WORDS(BLOCKS_LIST_CAPACITY(sz))] = BLOCKS_##sz##_FREE_MAP_INIT;
+#define X_FREE_SUMMARY(sz) \
+   static uint32_t free_summary_##sz[FREE_SUMMARY_WORDS(FREE_MAP_WORDS(BLOCKS_LIST_CAPACITY(sz)))] = \
+      BLOCKS_##sz##_FREE_SUMMARY_INIT;
+#define FREE_TOP_INIT(sz)        BLOCKS_##sz##_FREE_TOP_INIT
+#define FREE_MAP_INIT_LEN(len)   (len)
+#define ARENA_INIT_STATE         true
+#define ARENA_INIT_SPACE         ARRAY_ARENA_CFG_SPACE_AVAILABLE
+#else
+#define X_FREE_MAP(sz) \
+   static uint32_t free_map_##sz[FREE_MAP_WORDS(BLOCKS_LIST_CAPACITY(sz))];
+#define X_FREE_SUMMARY(sz) \
+   static uint32_t free_summary_##sz[FREE_SUMMARY_WORDS(FREE_MAP_WORDS(BLOCKS_LIST_CAPACITY(sz)))];
+#define FREE_TOP_INIT(sz)        0
+#define FREE_MAP_INIT_LEN(len)   0
+#define ARENA_INIT_STATE         false
+#define ARENA_INIT_SPACE         0
+#endif // ARRAY_ARENA_CFG_HAS_INIT_TABLES
+ARRAY_ARENA_BLOCK_SIZES(X_FREE_MAP)
+#ifdef ARRAY_ARENA_REALTIME
+ARRAY_ARENA_BLOCK_SIZES(X_FREE_SUMMARY)
+#endif
+
+//! Granule -> entry for the allocated block starting there (or BLOCK_SZ_NONE).
+static uint8_t ArrayArenaBlockSz[ARRAY_ARENA_NUM_OF_GRANULES];
+
+// Requests larger than the largest block size are granted a run of consecutive
+// largest blocks. The head of the run is indexed in the granule table like any
+// other largest block, and the length of the run is kept here, by head idx.
+//! Largest-block idx -> length of the large allocation run starting there (or 0).
+static size_t ArrayArenaRunLen[BLOCKS_LIST_CAPACITY(LARGEST_BLOCK_SIZE)];
+
+#if defined(ARRAY_ARENA_HANDLES) && defined(ARRAY_ARENA_DEFRAG)
+//! Granule -> handle of the block starting there (or the null handle), so that
+//! compaction can get from a block it moved to the table entry to update.
+static ArrayArenaHandle_T ArrayArenaGranuleHandle[ARRAY_ARENA_NUM_OF_GRANULES];
+#endif
+
+#ifdef ARRAY_ARENA_TELEMETRY
+//! The default arena's telemetry ring.
+static struct ArrayArenaTelemRec_S ArrayArenaTelemRecs[ARRAY_ARENA_TELEMETRY_RING_LEN];
+#endif
+
+#ifdef ARRAY_ARENA_TAGS
+//! Granule -> tag of the allocated block starting there (or ARRAY_ARENA_UNTAGGED).
+static ArrayArenaTag_T ArrayArenaGranuleTag[ARRAY_ARENA_NUM_OF_GRANULES];
+#endif
+
+#ifdef ARRAY_ARENA_REALTIME
+#define FREE_SUMMARY_LIST_INIT(sz) \
+   , .free_summary = free_summary_##sz, .free_top = FREE_TOP_INIT(sz)
+#else
+#define FREE_SUMMARY_LIST_INIT(sz)
+#endif
+#define X_FREE_MAP_LIST(sz) \
+   [ BLKS_##sz ] = { .free_map = free_map_##sz, .map_words = sizeof(free_map_##sz) / sizeof(free_map_##sz[0]), \
+                     .len = FREE_MAP_INIT_LEN(LIST_INIT_LEN(sz)), .block_size = (sz) \
+                     FREE_SUMMARY_LIST_INIT(sz) },
+
+STATIC struct ArrayArena_S ArrayArena =
+{
+   .lists =
+   {
+      ARRAY_ARENA_BLOCK_SIZES(X_FREE_MAP_LIST)
+   },
+   .arena_initialized = ARENA_INIT_STATE,
+   .space_available = ARENA_INIT_SPACE,
+   .pool = ArrayArenaPool,
+   .pool_size = VEC_ARRAY_ARENA_SIZE,
+   .granules = ArrayArenaBlockSz,
+   .run_lens = ArrayArenaRunLen,
+#ifdef ARRAY_ARENA_DEFRAG
+   .defrag = { .relocate_cb = NULL, .relocate_ctx = NULL,
+               .cursor = ARRAY_ARENA_NUM_OF_GRANULES, .moved_this_pass = false },
+#endif
+#ifdef ARRAY_ARENA_HANDLES
+   .handles = { .free_head = ARRAY_ARENA_NULL_HANDLE, .num_untouched = ARRAY_ARENA_NULL_HANDLE + 1 },
+#ifdef ARRAY_ARENA_DEFRAG
+   .granule_handles = ArrayArenaGranuleHandle,
+#endif
+#endif
+#ifdef ARRAY_ARENA_VIZ
+   .viz_dirty_lo = 0,
+   .viz_dirty_hi = VEC_ARRAY_ARENA_SIZE,
+#endif
+#ifdef ARRAY_ARENA_TELEMETRY
+   .telem = { .recs = ArrayArenaTelemRecs, .head = 0, .tail = 0, .dropped = 0, .info_pending = true },
+#endif
+#ifdef ARRAY_ARENA_HARDENED
+   .fault_cb = NULL,
+   .fault_ctx = NULL,
+#endif
+#ifdef ARRAY_ARENA_TAGS
+   .granule_tags = ArrayArenaGranuleTag,
+   .alloc_tag = ARRAY_ARENA_UNTAGGED,
+#endif
+};
+
+#ifdef ARRAY_ARENA_THREAD_SAFE
+
+#if defined(ARRAY_ARENA_DEFRAG) || defined(ARRAY_ARENA_HANDLES)
+#error "ARRAY_ARENA_THREAD_SAFE cannot yet be combined /w ARRAY_ARENA_DEFRAG or ARRAY_ARENA_HANDLES."
+#endif
+#ifdef ARRAY_ARENA_VIZ
+#error "ARRAY_ARENA_THREAD_SAFE cannot yet be combined /w ARRAY_ARENA_VIZ (the caches change the layout /wout the lock)."
+#endif
+#ifdef ARRAY_ARENA_TAGS
+#error "ARRAY_ARENA_THREAD_SAFE cannot yet be combined /w ARRAY_ARENA_TAGS (the caches hand blocks out /wout the lock)."
+#endif
+#ifdef ARRAY_ARENA_HARDENED
+#error "ARRAY_ARENA_THREAD_SAFE cannot yet be combined /w ARRAY_ARENA_HARDENED (the caches keep their links in the blocks)."
+#endif
+
+// Critical section around an arena's free lists. Define both to use a lock of
+// your own (e.g., an RTOS mutex, or masking interrupts on a single core); they
+// are given the arena being locked. Otherwise, a spinlock per arena is used,
+// which holds up well since the critical sections are short, and for the
+// default arena are only hit when a cache runs dry or overflows.
+#if !defined(ARRAY_ARENA_LOCK) || !defined(ARRAY_ARENA_UNLOCK)
+#if defined(__GNUC__)
+#define ARRAY_ARENA_LOCK(arena)    while ( __atomic_test_and_set( &(arena)->lock_flag, __ATOMIC_ACQUIRE ) ) {}
+#define ARRAY_ARENA_UNLOCK(arena)  __atomic_clear( &(arena)->lock_flag, __ATOMIC_RELEASE )
+#else
+#error "Define ARRAY_ARENA_LOCK(arena) and ARRAY_ARENA_UNLOCK(arena) for this compiler."
+#endif
+#endif
+
+// How many free blocks of each size a cache holds at most. Refills and drains
+// move half of that at a time.
+#ifndef ARRAY_ARENA_CACHE_SIZE
+#define ARRAY_ARENA_CACHE_SIZE 8
+#endif
+typedef char ArrayArena_CacheSizeIsEven[ ((ARRAY_ARENA_CACHE_SIZE >= 2) && ((ARRAY_ARENA_CACHE_SIZE % 2) == 0)) ? 1 : -1 ];
+
+// A block freed by a thread other than the one whose cache it came from is
+// handed back to that cache through the cache's remote-free queue, rather
+// than going into the freeing thread's cache. While queued, the block's own
+// bytes hold the queue link. The queue is an intrusive MPSC queue (after
+// Dmitry Vyukov's), so pushing is a single atomic exchange (wait-free), and
+// the owner pops everything that has been pushed in a batch on its next alloc.
+#if defined(__GNUC__)
+#define ATOMIC_LOAD_PTR(p)      __atomic_load_n( (p), __ATOMIC_ACQUIRE )
+#define ATOMIC_STORE_PTR(p, v)  __atomic_store_n( (p), (v), __ATOMIC_RELEASE )
+#define ATOMIC_XCHG_PTR(p, v)   __atomic_exchange_n( (p), (v), __ATOMIC_ACQ_REL )
+#define ATOMIC_TEST_AND_SET(p)  __atomic_test_and_set( (p), __ATOMIC_ACQUIRE )
+#define ATOMIC_CLEAR(p)         __atomic_clear( (p), __ATOMIC_RELEASE )
+#else
+#error "ARRAY_ARENA_THREAD_SAFE needs GCC-style __atomic builtins for this compiler."
+#endif
+
+struct ArrayArenaRemoteFree_S
+{
+   struct ArrayArenaRemoteFree_S * next;
+   enum BlockSize sz; // Which list the queued block belongs to
+};
+typedef char ArrayArena_RemoteFreeFitsInBlock[ (sizeof(struct ArrayArenaRemoteFree_S) <= SMALLEST_BLOCK_SIZE) ? 1 : -1 ];
+
+// Blocks in a cache are allocated as far as the free lists are concerned (and
+// are not counted in space_available), but have no granule table entry. Only
+// plain blocks are cached; trimmed blocks and large runs always go through the
+// shared free lists.
+struct ArrayArenaCache_S
+{
+   size_t blks[NUM_OF_BLOCK_SIZES][ARRAY_ARENA_CACHE_SIZE]; // Idx of each cached block within its list
+   uint8_t len[NUM_OF_BLOCK_SIZES];
+   struct ArrayArenaRemoteFree_S * remote_head; // Consumer end of the remote-free queue (owner only)
+   struct ArrayArenaRemoteFree_S * remote_tail; // Producer end of the remote-free queue
+   struct ArrayArenaRemoteFree_S remote_stub; // Keeps the queue from ever being truly empty
+   bool remote_ready; // Whether the remote-free queue has been set up
+   bool claimed; // Whether a thread has this cache (when there is a cache per thread)
+};
+
+// Caches are handed out to threads on first use, up to ARRAY_ARENA_NUM_OF_CACHES
+// at a time (threads beyond that go straight to the shared free lists), and
+// handed back by StaticArrayCacheFlush().
+// Targets /wout thread-local storage (or where a cache per core is wanted
+// instead) may define ARRAY_ARENA_CACHE_ID() to give the index of the caller's
+// cache. No two callers may use the same cache at the same time (e.g., for a
+// cache per core, the caller must not be migrated or preempted by another user
+// of the arena).
+#ifndef ARRAY_ARENA_NUM_OF_CACHES
+#define ARRAY_ARENA_NUM_OF_CACHES 8
+#endif
+typedef char ArrayArena_CacheIdFitsInU8[ (ARRAY_ARENA_NUM_OF_CACHES < UINT8_MAX) ? 1 : -1 ];
+static struct ArrayArenaCache_S ArrayArenaCaches[ARRAY_ARENA_NUM_OF_CACHES];
+
+#ifndef ARRAY_ARENA_CACHE_ID
+#ifndef ARRAY_ARENA_THREAD_LOCAL
+#if defined(__GNUC__)
+#define ARRAY_ARENA_THREAD_LOCAL __thread
+#else
+#error "Define ARRAY_ARENA_THREAD_LOCAL (or ARRAY_ARENA_CACHE_ID()) for this compiler."
+#endif
+#endif
+static ARRAY_ARENA_THREAD_LOCAL struct ArrayArenaCache_S * ArrayArenaMyCache;
+#endif // ARRAY_ARENA_CACHE_ID
+
+//! Granule -> 1 + idx of the cache the block starting there came from (or 0).
+static uint8_t ArrayArenaBlockOwner[ARRAY_ARENA_NUM_OF_GRANULES];
+
+/**
+ * @brief Local helper function to get the caller's cache, setting it up if
+ *        need be.
+ * @return Ptr to the cache, or NULL if there is none to be had
+ */
+static struct ArrayArenaCache_S * Helper_MyCache( void );
+
+/**
+ * @brief Local helper functions for a cache's remote-free queue. Only the
+ *        owner of the cache may pop.
+ * @return Helper_RemotePop(): the block popped, or NULL if there is none yet
+ */
+static void Helper_RemotePush( struct ArrayArenaCache_S * cache, struct ArrayArenaRemoteFree_S * node );
+static struct ArrayArenaRemoteFree_S * Helper_RemotePop( struct ArrayArenaCache_S * cache );
+
+/**
+ * @brief Local helper function to take back all of the blocks that have been
+ *        freed into the caller's cache by other threads.
+ */
+static void Helper_CacheReclaim( struct ArrayArena_S * arena, struct ArrayArenaCache_S * cache );
+
+/**
+ * @brief Local helper function to take back a cache's remote frees, and then
+ *        move everything in it back to the shared free lists.
+ * @note The caller must have the cache.
+ */
+static void Helper_CacheFlush( struct ArrayArena_S * arena, struct ArrayArenaCache_S * cache );
+
+/**
+ * @brief Local helper function to flush the caller's cache, if the arena is
+ *        the default one (and the caller has a cache), before a request that
+ *        went through the shared free lists is retried: the blocks sitting in
+ *        the cache may be what is needed to merge into the block wanted.
+ */
+static void Helper_CacheFlushMine( struct ArrayArena_S * arena );
+
+/**
+ * @brief Local helper function to allocate from the caller's cache (of the default arena).
+ * @param[out] ptr (Ptr) Allocated block, or NULL if there is no block to be had
+ * @return true if the request was dealt /w; false if it has to go through the
+ *         shared free lists instead
+ */
+static bool Helper_CacheAlloc( struct ArrayArena_S * arena, size_t req_bytes, void ** ptr );
+static bool Helper_CacheAllocAs( struct ArrayArena_S * arena, struct ArrayPoolBlock_S * blk, size_t req_bytes, void ** ptr );
+
+/**
+ * @brief Local helper function to free into the caller's cache (of the default arena).
+ * @return true if the free was dealt /w; false if it has to go through the
+ *         shared free lists instead
+ */
+static bool Helper_CacheFree( struct ArrayArena_S * arena, const void * ptr );
+
+/**
+ * @brief Local helper function to move cached blocks of a size back to the
+ *        shared free lists. Must be called /w the lock held.
+ */
+static void Helper_CacheDrain( struct ArrayArena_S * arena, struct ArrayArenaCache_S * cache,
+                               enum BlockSize blk_sz, uint8_t num_of_blks );
+
+#endif // ARRAY_ARENA_THREAD_SAFE
+
+// Telemetry records are stamped /w the cycle counter, unless told otherwise
+#if defined(ARRAY_ARENA_TELEMETRY) && !defined(ARRAY_ARENA_TELEMETRY_TIMESTAMP)
+#define ARRAY_ARENA_TELEMETRY_TIMESTAMP() ARRAY_ARENA_CYCLE_COUNT()
+#define ARRAY_ARENA_TELEMETRY_CYCLE_STAMPS
+#endif
+
+#if defined(ARRAY_ARENA_STATS_CYCLES) || defined(ARRAY_ARENA_TELEMETRY_CYCLE_STAMPS)
+#ifndef ARRAY_ARENA_CYCLE_COUNT
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define ARRAY_ARENA_CYCLE_COUNT() __builtin_ia32_rdtsc()
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+// DWT->CYCCNT, which the application has to have turned on (DEMCR.TRCENA, then DWT_CTRL.CYCCNTENA)
+#define ARRAY_ARENA_CYCLE_COUNT() ( *(const volatile uint32_t *)0xE0001004u )
+#else
+#error "Define ARRAY_ARENA_CYCLE_COUNT() (a free-running cycle counter) for this target."
+#endif
+#endif // ARRAY_ARENA_CYCLE_COUNT
+#endif
+
+#ifdef ARRAY_ARENA_STATS
+// The caches count their allocs and frees /wout the lock, so in thread-safe
+// mode every counter is updated atomically. Nothing is ordered by them, so
+// relaxed is enough (and is a plain load/store on most targets).
+#ifdef ARRAY_ARENA_THREAD_SAFE
+#define STATS_ADD(counter, n)   __atomic_add_fetch( &(counter), (n), __ATOMIC_RELAXED )
+#define STATS_SUB(counter, n)   __atomic_sub_fetch( &(counter), (n), __ATOMIC_RELAXED )
+#define STATS_LOAD(counter)     __atomic_load_n( &(counter), __ATOMIC_RELAXED )
+#else
+#define STATS_ADD(counter, n)   ( (counter) += (n) )
+#define STATS_SUB(counter, n)   ( (counter) -= (n) )
+#define STATS_LOAD(counter)     (counter)
+#endif
+
+#define STATS_COUNT(arena, blk_sz, counter)         STATS_ADD( (arena)->stats.classes[blk_sz].counter, 1u )
+#define STATS_ALLOC(arena, blk, req_bytes, n)       Helper_StatsAlloc( (arena), (blk), (req_bytes), (n) )
+#define STATS_FREE(arena, blk)                      Helper_StatsFree( (arena), (blk) )
+#define STATS_FAIL(arena, req_bytes, n)             Helper_StatsFail( (arena), (req_bytes), (n) )
+
+#ifdef ARRAY_ARENA_STATS_CYCLES
+// Only the low 32 bits are kept, which is plenty for a single call, and the
+// difference comes out right across a wrap of the counter.
+#define STATS_CYCLES_START(start)             uint32_t start = (uint32_t)ARRAY_ARENA_CYCLE_COUNT()
+#define STATS_CYCLES_END(arena, hist, start)  Helper_StatsCycles( (arena)->stats.hist, (uint32_t)ARRAY_ARENA_CYCLE_COUNT() - (start) )
+#endif // ARRAY_ARENA_STATS_CYCLES
+
+/**
+ * @brief Local helper functions to count blocks being handed out or back, and
+ *        requests that could not be granted.
+ * @param[in] n How many blocks of the kind blk describes (for a batch)
+ */
+static void Helper_StatsAlloc( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk,
+                               size_t req_bytes, size_t n );
+static void Helper_StatsFree( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk );
+static void Helper_StatsFail( struct ArrayArena_S * arena, size_t req_bytes, size_t n );
+
+/**
+ * @brief Local helper function to raise a high-water mark to val, if it is below.
+ */
+static void Helper_StatsPeak( size_t * peak, size_t val );
+
+#ifdef ARRAY_ARENA_STATS_CYCLES
+/**
+ * @brief Local helper function to bin how many cycles a call took into a histogram.
+ */
+static void Helper_StatsCycles( size_t hist[], uint32_t cycles );
+static uint8_t Helper_Log2_32( uint32_t word );
+#endif
+#endif // ARRAY_ARENA_STATS
+
+#if defined(ARRAY_ARENA_STATS_CYCLES) && !defined(ARRAY_ARENA_STATS)
+#error "ARRAY_ARENA_STATS_CYCLES needs ARRAY_ARENA_STATS"
+#endif
+#ifndef ARRAY_ARENA_STATS
+#define STATS_COUNT(arena, blk_sz, counter)         ((void)0)
+#define STATS_ALLOC(arena, blk, req_bytes, n)       ((void)0)
+#define STATS_FREE(arena, blk)                      ((void)0)
+#define STATS_FAIL(arena, req_bytes, n)             ((void)0)
+#endif
+#ifndef ARRAY_ARENA_STATS_CYCLES
+#define STATS_CYCLES_START(start)                   ((void)0)
+#define STATS_CYCLES_END(arena, hist, start)        ((void)0)
+#endif
+
+#ifdef ARRAY_ARENA_TELEMETRY
+#if !defined(__GNUC__)
+#error "ARRAY_ARENA_TELEMETRY needs GCC-style __atomic builtins for this compiler."
+#endif
+
+#define TELEM_ALLOC(arena, blk_sz, ptr, req_bytes) \
+   Helper_TelemEmit( (arena), ARRAY_ARENA_TELEM_ALLOC, (uint8_t)(blk_sz), \
+                     (size_t)((const uint8_t *)(ptr) - (arena)->pool), (req_bytes) )
+#define TELEM_FREE(arena, blk) \
+   Helper_TelemEmit( (arena), ARRAY_ARENA_TELEM_FREE, (uint8_t)(blk)->sz, \
+                     (blk)->idx * (arena)->lists[(blk)->sz].block_size, Helper_BlockBytes( blk ) )
+#define TELEM_FAIL(arena, req_bytes, n) \
+   Helper_TelemEmit( (arena), ARRAY_ARENA_TELEM_FAIL, ARRAY_ARENA_TELEM_NO_SIZE, (n), (req_bytes) )
+#define TELEM_BLOCK(arena, type, blk_sz, blk_idx) \
+   Helper_TelemEmit( (arena), (type), (uint8_t)(blk_sz), \
+                     (blk_idx) * (arena)->lists[blk_sz].block_size, (arena)->lists[blk_sz].block_size )
+#define TELEM_MOVE(arena, blk_sz, old_offset, new_offset) \
+   Helper_TelemEmit( (arena), ARRAY_ARENA_TELEM_MOVE, (uint8_t)(blk_sz), (new_offset), (old_offset) )
+
+/**
+ * @brief Local helper function to write a record into an arena's telemetry
+ *        ring, or to count it as dropped if the ring is full.
+ * @note Never waits on the drain. In thread-safe mode, the caches write /wout
+ *       the lock, so the slot is claimed /w a CAS on the head.
+ */
+static void Helper_TelemEmit( struct ArrayArena_S * arena, enum ArrayArenaTelemType type,
+                              uint8_t blk_sz, size_t offset, size_t arg );
+
+/**
+ * @brief Local helper function to hand a record that is not from the ring
+ *        (INFO, LOST, or TAG) to a sink.
+ * @return Whether the sink took it
+ */
+static bool Helper_TelemSendOne( ArrayArenaTelemSink_T sink, void * ctx, enum ArrayArenaTelemType type,
+                                 uint8_t blk_sz, size_t offset, size_t arg );
+#else
+#define TELEM_ALLOC(arena, blk_sz, ptr, req_bytes)          ((void)0)
+#define TELEM_FREE(arena, blk)                              ((void)0)
+#define TELEM_FAIL(arena, req_bytes, n)                     ((void)0)
+#define TELEM_BLOCK(arena, type, blk_sz, blk_idx)           ((void)0)
+#define TELEM_MOVE(arena, blk_sz, old_offset, new_offset)   ((void)0)
+#endif // ARRAY_ARENA_TELEMETRY
+
+#ifdef ARRAY_ARENA_TAGS
+#define TAGS_INDEX(arena, granule, bytes)     Helper_TagsIndex( (arena), (granule), (bytes) )
+#define TAGS_UNINDEX(arena, granule, bytes)   Helper_TagsUnindex( (arena), (granule), (bytes) )
+#define TAGS_ALLOC_AS(arena, tag)             ( (arena)->alloc_tag = (tag) )
+#define TAG_AT(arena, offset)                 ( (arena)->granule_tags[(offset) / ARRAY_ARENA_GRANULE_SIZE] )
+
+/**
+ * @brief Local helper functions to charge the block indexed at a granule to
+ *        the arena's alloc_tag, and to take the block unindexed from there off
+ *        whichever tag it was charged to.
+ */
+static void Helper_TagsIndex( struct ArrayArena_S * arena, size_t granule, size_t bytes );
+static void Helper_TagsUnindex( struct ArrayArena_S * arena, size_t granule, size_t bytes );
+
+/**
+ * @brief Local helper function for the tag of the allocated block at ptr.
+ * @return The tag, or ARRAY_ARENA_UNTAGGED if ptr is not an allocated block
+ */
+static ArrayArenaTag_T Helper_BlockTag( struct ArrayArena_S * arena, const void * ptr );
+#else
+#define TAGS_INDEX(arena, granule, bytes)     ((void)0)
+#define TAGS_UNINDEX(arena, granule, bytes)   ((void)0)
+#define TAGS_ALLOC_AS(arena, tag)             ((void)0)
+#endif // ARRAY_ARENA_TAGS
+
+#ifdef ARRAY_ARENA_HARDENED
+#ifndef ARRAY_ARENA_CANARY
+#define ARRAY_ARENA_CANARY 0xC0DEFACEu
+#endif
+#define CANARY_BYTES sizeof(uint32_t)
+
+#define HARDEN_SET_CANARY(arena, ptr, bytes)     Helper_CanarySet( (arena), (ptr), (bytes) )
+#define HARDEN_CHECK_CANARY(arena, ptr, bytes)   Helper_CanaryCheck( (arena), (ptr), (bytes) )
+#define HARDEN_BAD_FREE(arena, ptr)              Helper_BadFree( (arena), (ptr) )
+#define HARDEN_BAD_HANDLE(arena)                 Helper_Fault( (arena), ARRAY_ARENA_FAULT_BAD_HANDLE, NULL )
+
+/**
+ * @brief Local helper function to count a fault, and report it to the fault
+ *        callback, if there is one.
+ */
+static void Helper_Fault( struct ArrayArena_S * arena, enum ArrayArenaFault fault, const void * ptr );
+
+/**
+ * @brief Local helper functions to write the canary into the last word of the
+ *        blk_bytes bytes long block at ptr, and to check that it is still there.
+ */
+static void Helper_CanarySet( struct ArrayArena_S * arena, void * ptr, size_t blk_bytes );
+static void Helper_CanaryCheck( struct ArrayArena_S * arena, const void * ptr, size_t blk_bytes );
+
+/**
+ * @brief Local helper function to report a free (or realloc) of a pointer
+ *        that is not an allocated block, as whichever fault it is.
+ */
+static void Helper_BadFree( struct ArrayArena_S * arena, const void * ptr );
+
+#ifdef ARRAY_ARENA_HARDENED_POISON
+#ifndef ARRAY_ARENA_POISON_BYTE
+#define ARRAY_ARENA_POISON_BYTE 0xDBu
+#endif
+#define HARDEN_POISON(arena, ptr, bytes)         memset( (ptr), ARRAY_ARENA_POISON_BYTE, (bytes) )
+#define HARDEN_CHECK_POISON(arena, ptr, bytes)   Helper_PoisonCheck( (arena), (ptr), (bytes) )
+
+/**
+ * @brief Local helper function to check that the first and last word of the
+ *        blk_bytes bytes long free block at ptr are still poisoned.
+ * @note Memory that has never been handed out (e.g., of the default arena,
+ *       which has no run-time init /w the generated tables) is all-zero
+ *       instead, which passes as well.
+ */
+static void Helper_PoisonCheck( struct ArrayArena_S * arena, const void * ptr, size_t blk_bytes );
+#endif
+#else
+#define CANARY_BYTES 0u
+#define HARDEN_SET_CANARY(arena, ptr, bytes)     ((void)0)
+#define HARDEN_CHECK_CANARY(arena, ptr, bytes)   ((void)0)
+#define HARDEN_BAD_FREE(arena, ptr)              ((void)0)
+#define HARDEN_BAD_HANDLE(arena)                 ((void)0)
+#endif // ARRAY_ARENA_HARDENED
+#ifndef ARRAY_ARENA_HARDENED_POISON
+#define HARDEN_POISON(arena, ptr, bytes)         ((void)0)
+#define HARDEN_CHECK_POISON(arena, ptr, bytes)   ((void)0)
+#endif
+#if defined(ARRAY_ARENA_HARDENED_POISON) && !defined(ARRAY_ARENA_HARDENED)
+#error "ARRAY_ARENA_HARDENED_POISON needs ARRAY_ARENA_HARDENED"
+#endif
+
+/**
+ * @brief Local helper functions that do the work of ArrayArenaAlloc(),
+ *        ArrayArenaRealloc(), and ArrayArenaFree(), without any locking.
+ */
+static void * Helper_ArenaAlloc( struct ArrayArena_S * arena, size_t req_bytes );
+static void * Helper_ArenaAllocClass( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t req_bytes );
+static enum ArrayArenaStatus Helper_ArenaRealloc( struct ArrayArena_S * arena, void ** ptr_io, size_t req_bytes );
+static enum ArrayArenaStatus Helper_ArenaFree( struct ArrayArena_S * arena, const void * ptr );
+static size_t Helper_ArenaAllocBatch( struct ArrayArena_S * arena, size_t req_bytes, size_t n, void * out[] );
+static void   Helper_ArenaFreeBatch( struct ArrayArena_S * arena, void * const ptrs[], size_t n );
+
+/**
+ * @brief Local helper functions that do the same as Helper_ArenaAlloc() and
+ *        Helper_ArenaRealloc(), but leave a failure to the caller to count
+ *        (in stats and telemetry), e.g., for when it is going to retry.
+ */
+static void * Helper_ArenaAllocUncounted( struct ArrayArena_S * arena, size_t req_bytes );
+static enum ArrayArenaStatus Helper_ArenaReallocUncounted( struct ArrayArena_S * arena, void ** ptr_io, size_t req_bytes );
+
+/**
+ * @brief Local helper function for whether a status is that of a request
+ *        that could not be had (rather than of a bad pointer).
+ */
+static bool Helper_IsAllocFailure( enum ArrayArenaStatus status );
+
+/**
+ * @brief Local helper function to take the block picked for a request, and
+ *        hand it out.
+ * @note A failure is left to the caller to count.
+ * @return Pointer to the block; NULL if none could be had
+ */
+static void * Helper_ArenaAllocAs( struct ArrayArena_S * arena, struct ArrayPoolBlock_S * blk, size_t req_bytes );
+
+/**
+ * @brief Local helper function to pick the block that best fits a request.
+ * @param[out] blk (Ptr) List to allocate from, and whether to trim the block
+ * @return true if the request fits in a block; false otherwise
+ */
+static bool Helper_RequestToBlock( struct ArrayArena_S * arena, size_t req_bytes, struct ArrayPoolBlock_S * blk );
+
+/**
+ * @brief Local helper function for why a request of req_bytes could not be
+ *        had, given reusable_bytes more that could be freed up for it (i.e.,
+ *        those of the block being reallocated).
+ */
+static enum ArrayArenaStatus Helper_AllocFailure( struct ArrayArena_S * arena, size_t req_bytes, size_t reusable_bytes );
+
+/**
+ * @brief Local helper function for why ptr is not an allocated block: whether
+ *        it is in free memory of the arena (ARRAY_ARENA_DOUBLE_FREE), or not
+ *        (ARRAY_ARENA_INVALID_PTR).
+ */
+static enum ArrayArenaStatus Helper_BadPtrStatus( struct ArrayArena_S * arena, const void * ptr );
+
+/**
+ * @brief Local helper function for how many bytes of the block at ptr the
+ *        caller may use (0 if ptr is not an allocated block).
+ */
+static size_t Helper_GrantedBytes( struct ArrayArena_S * arena, const void * ptr );
+
+/**
+ * @brief Local helper function for the number of bytes granted to a block.
+ */
+static size_t Helper_BlockBytes( const struct ArrayPoolBlock_S * blk );
+
+/**
+ * @brief Local helper function to find the allocated block that corresponds to
+ *        the pointer passed in.
+ * 
+ * @note The struct ArrayPoolBlock_S * parameter is optional and may be set to
+ *       NULL if all the user cares about is if there exists an allocated block
+ *       that lives at the address passed in.
+ * @param[in]  ptr     Address to look for among the allocated blocks
+ * @param[out] blk     (Ptr) Which block the ptr belongs to (optional)
+ * @return true if successful in finding a block; false otherwise
+ */
+static bool Helper_FindBlock( struct ArrayArena_S * arena, const void *,
+     /* Return Parameters */  struct ArrayPoolBlock_S * );
+
+/**
+ * @brief Local helper functions to read/modify the free bit of block blk_idx
+ *        in the list for blk_sz.
+ */
+static bool Helper_IsBlockFree( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx );
+static void Helper_MarkBlockFree( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx );
+static void Helper_MarkBlockAllocated( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx );
+
+#ifdef ARRAY_ARENA_REALTIME
+/**
+ * @brief Local helper function to bring the summary bits over word w of a
+ *        list's bitmap up to date /w it, after the word was written to.
+ */
+static void Helper_SyncFreeSummary( struct ArrayPoolBlockList_S * list, size_t w );
+#define FREE_SUMMARY_SYNC(list, w)   Helper_SyncFreeSummary( (list), (w) )
+#else
+#define FREE_SUMMARY_SYNC(list, w)   ((void)0)
+#endif
+
+#ifdef ARRAY_ARENA_VIZ
+/**
+ * @brief Local helper function to note that the block of len bytes at offset
+ *        has changed state, for the next layout export.
+ * @note Every change of state goes through the free bitmaps or the granule
+ *       table, so marking there catches them all. Since every block that comes
+ *       to be is marked, the start of the dirty range is always the start of
+ *       a block, which is where the export walks the blocks from.
+ */
+static void Helper_VizMarkDirty( struct ArrayArena_S * arena, size_t offset, size_t len );
+#define VIZ_MARK_DIRTY(arena, offset, len)   Helper_VizMarkDirty( (arena), (offset), (len) )
+#else
+#define VIZ_MARK_DIRTY(arena, offset, len)   ((void)0)
+#endif
+
+/**
+ * @brief Local helper function to take the lowest-addressed free block of a list.
+ * @param[out] blk_idx (Ptr) Idx within the block list of the block taken
+ * @return true if the list had a free block; false otherwise
+ */
+static bool Helper_TakeFreeBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t * blk_idx );
+
+/**
+ * @brief Local helper function to take (and index) up to max free blocks of a
+ *        list, lowest-addressed first, in a single pass over its bitmap.
+ * @param[out] out Ptrs to the blocks taken
+ * @return How many blocks were taken
+ */
+static size_t Helper_TakeFreeBlocks( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t max,
+                                     void * out[] );
+
+/**
+ * @brief Local helper function to split an (already taken) block into all of
+ *        the blocks of a smaller size it spans, and take (and index) up to max
+ *        of them. The rest are handed back to the free lists.
+ * @param[out] out Ptrs to the blocks taken
+ * @return How many blocks were taken
+ */
+static size_t Helper_CarveBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx,
+                                 enum BlockSize target_sz, size_t max, void * out[] );
+
+/**
+ * @brief Local helper function to take a free block of a given size, splitting
+ *        a larger one if need be.
+ * @param[out] blk_idx (Ptr) Idx within the block list of the block taken
+ * @return true if successful; false if no block of that size or larger is free
+ */
+static bool Helper_AllocBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t * blk_idx );
+
+/**
+ * @brief Local helper function to take free block(s) fit for blk, wherever
+ *        they may be.
+ * @param[inout] blk Block to take; its idx is filled in if successful
+ * @return true if successful; false otherwise
+ */
+static bool Helper_TakeBlock( struct ArrayArena_S * arena, struct ArrayPoolBlock_S * blk );
+
+/**
+ * @brief Local helper function to take a run of consecutive free largest blocks.
+ * @param[out] blk_idx (Ptr) Idx within the largest block list of the first block of the run
+ * @return true if successful; false if there is no such run that is free
+ */
+static bool Helper_TakeFreeRun( struct ArrayArena_S * arena, size_t run_len, size_t * blk_idx );
+
+/**
+ * @brief Local helper function to split an (already taken) block down to a
+ *        smaller block size.
+ *
+ * The block is halved repeatedly. Each time, the lower half is kept and the
+ * upper half is handed to the free list one size down, until the lower half is
+ * of the size requested.
+ * @return Idx of the resulting block of the requested size (still taken)
+ */
+static size_t Helper_SplitBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx,
+                                 enum BlockSize target_sz );
+
+/**
+ * @brief Local helper function to free a block, merging it /w its buddy for
+ *        as long as the buddy is also free.
+ * @note /w ARRAY_ARENA_LAZY_COALESCE, the block is only freed, and the merging
+ *       is left to Helper_MergePending().
+ */
+static void Helper_CoalesceBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx );
+
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+/**
+ * @brief Local helper function to merge every pair of free buddies in the list
+ *        for blk_sz into a free block of the next size up.
+ * @return How many pairs were merged
+ */
+static size_t Helper_MergeList( struct ArrayArena_S * arena, enum BlockSize blk_sz );
+
+/**
+ * @brief Local helper function to merge the blocks freed since the last time,
+ *        from the smallest size up, so that merges cascade in the one pass.
+ * @return true if any blocks were merged
+ */
+static bool Helper_MergePending( struct ArrayArena_S * arena );
+
+/**
+ * @brief Local helper function to check whether any list has been freed into
+ *        since it was last merged.
+ */
+static bool Helper_HasUnmerged( const struct ArrayArena_S * arena );
+
+/**
+ * @brief Local helper function to merge the free blocks that the block at
+ *        blk_idx of blk_sz is made up of back into it, if all of it is free.
+ * @note Visits at most the blocks that it spans, and only when they are free.
+ * @return true if the block is now a free block of blk_sz
+ */
+static bool Helper_MergeInto( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx );
+
+/**
+ * @brief Local helper function to merge the free blocks that all of the
+ *        block(s) blk would occupy are made up of, so that it can be claimed.
+ * @return true if any of them is now a free block of its size
+ */
+static bool Helper_MergeCovered( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk );
+#define LAZY_MERGE(arena)   Helper_MergePending( arena )
+#else
+#define LAZY_MERGE(arena)   false
+#endif
+
+/**
+ * @brief Local helper function to return all of an allocated block to the free lists.
+ */
+static void Helper_ReleaseBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk );
+
+/**
+ * @brief Local helper function to take a specific block, splitting the free
+ *        block that contains it if need be.
+ * @return true if successful; false if the block is not (entirely) free
+ */
+static bool Helper_ClaimBlockAt( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx );
+
+/**
+ * @brief Local helper function to take all of the block(s) blk would occupy.
+ * @note On failure, nothing is taken. The inverse is Helper_ReleaseBlock().
+ * @return true if successful; false if any part of blk is not free
+ */
+static bool Helper_ClaimBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk );
+
+/**
+ * @brief Local helper function to resize an allocated block in place.
+ * @param[in]    old_blk The allocated block
+ * @param[inout] new_blk Best fit for the new size; its idx is filled in if successful
+ * @return true if successful; false if the block was left untouched
+ */
+static bool Helper_ResizeBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * old_blk,
+                                struct ArrayPoolBlock_S * new_blk );
+
+/**
+ * @brief Local helper functions to record in/remove from the granule lookup
+ *        table that an allocated block starts where blk says it does.
+ */
+static void Helper_IndexBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk );
+static void Helper_UnindexBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk );
+
+/**
+ * @brief Local helper function for the idx of the lowest set bit of a non-zero word.
+ */
+static uint8_t Helper_Ctz32( uint32_t word );
+
+/**
+ * @brief Local helper function to mark the initial blocks of each free list as
+ *        free, laying the lists out back-to-back from the start of the pool.
+ * @param[in] list_init_lens How many blocks each list starts out /w
+ */
+static void Helper_LayoutFreeLists( struct ArrayArena_S * arena, const size_t list_init_lens[] );
+
+/**
+ * @brief Local helper function for how many bytes of metadata ArrayArenaInit()
+ *        needs to carve out for a pool of pool_size bytes.
+ */
+static size_t Helper_MetadataBytes( size_t pool_size );
+
+/**
+ * @brief Local helper function to point an arena at the pool and metadata that
+ *        ArrayArenaInit() carves out of the len bytes at buffer, without
+ *        touching what is in the buffer.
+ * @return false if the buffer is too small (or too large) to carve an arena out of
+ */
+static bool Helper_CarveArena( struct ArrayArena_S * arena, void * buffer, size_t len );
+
+/**
+ * @brief Local helper function to reset what an arena keeps beside its buffer
+ *        (callbacks, stats, telemetry cursors, ...).
+ */
+static void Helper_ResetArenaState( struct ArrayArena_S * arena );
+
+#ifdef ARRAY_ARENA_PERSISTENT
+/**
+ * @brief Local helper function to fold len bytes into an FNV-1a hash.
+ */
+static uint32_t Helper_Fnv1a( uint32_t hash, const void * bytes, size_t len );
+
+/**
+ * @brief Local helper function for the checksum of a persistent header, i.e.
+ *        that of the header /w its checksum field as 0.
+ */
+static uint32_t Helper_PersistChecksum( const struct ArrayArenaPersistHdr_S * hdr );
+
+/**
+ * @brief Local helper function for a fingerprint of the compile-time config
+ *        that shapes an arena's metadata, which an attach must agree on.
+ */
+static uint32_t Helper_PersistLayout( void );
+
+/**
+ * @brief Local helper function to recount the free lists and live blocks of an
+ *        attached arena from its metadata, checking the metadata as it goes.
+ * @return false if the metadata does not describe a sound arena
+ */
+static bool Helper_PersistRebuild( struct ArrayArena_S * arena );
+
+/**
+ * @brief Local helper function to check the header of the buffer an arena has
+ *        been carved out of (of len bytes) against this config.
+ */
+static bool Helper_PersistHdrIsValid( const struct ArrayArena_S * arena, size_t len );
+#endif
+
+#ifdef ARRAY_ARENA_SHARED
+/**
+ * @brief Local helper function to push the block at offset onto a shared arena's
+ *        queue of blocks freed by peers.
+ */
+static void Helper_RemoteFreePush( uint8_t * pool, uint32_t * head, uint32_t offset );
+
+/**
+ * @brief Local helper function to take back (i.e., free) all of the blocks on
+ *        an arena's queue of blocks freed by peers.
+ * @return How many were taken back
+ */
+static size_t Helper_SharedReclaim( struct ArrayArena_S * arena );
+#define SHARED_RECLAIM(arena) \
+   do { \
+      if ( ((arena)->remote_free_head != NULL) && \
+           (__atomic_load_n( (arena)->remote_free_head, __ATOMIC_RELAXED ) != ARRAY_ARENA_NO_REMOTE_FREE) ) \
+      { \
+         (void)Helper_SharedReclaim( (arena) ); \
+      } \
+   } while (0)
+#else
+#define SHARED_RECLAIM(arena) ((void)0)
+#endif
+
+/**
+ * @brief Initializes the static array pool arena structures.
+ * @note When array_arena_cfg.h carries the generated free bitmaps, the arena
+ *       is already initialized at compile-time and this does nothing.
+ */
+STATIC void StaticArrayPoolInit(void)
+{
+#ifndef ARRAY_ARENA_CFG_HAS_INIT_TABLES
+#define X_LIST_INIT_LEN(sz) [ BLKS_##sz ] = LIST_INIT_LEN(sz),
+   static const size_t ListInitLens[NUM_OF_BLOCK_SIZES] =
+   {
+      ARRAY_ARENA_BLOCK_SIZES(X_LIST_INIT_LEN)
+   };
+
+   assert( !ArrayArena.arena_initialized );
+   Helper_LayoutFreeLists( &ArrayArena, ListInitLens );
+#endif // ARRAY_ARENA_CFG_HAS_INIT_TABLES
+}
+
+/**
+ * Check that the static array pool is initialized.
+ */
+STATIC bool StaticArrayPoolIsInitialized(void)
+{
+   return ArrayArenaIsInitialized( &ArrayArena );
+}
+
+STATIC void * StaticArrayAlloc(size_t req_bytes)
+{
+   return ArrayArenaAlloc( &ArrayArena, req_bytes );
+}
+
+STATIC void * StaticArrayAllocClass(uint8_t size_class, size_t req_bytes)
+{
+   return ArrayArenaAllocClass( &ArrayArena, size_class, req_bytes );
+}
+
+STATIC void * StaticArrayAllocAligned(size_t req_bytes, size_t alignment)
+{
+   return ArrayArenaAllocAligned( &ArrayArena, req_bytes, alignment );
+}
+
+STATIC void * StaticArrayRealloc(void * ptr, size_t req_bytes)
+{
+   return ArrayArenaRealloc( &ArrayArena, ptr, req_bytes );
+}
+
+STATIC void StaticArrayFree(const void * ptr)
+{
+   ArrayArenaFree( &ArrayArena, ptr );
+}
+
+STATIC bool StaticArrayIsAlloc(const void * ptr)
+{
+   return ArrayArenaIsAlloc( &ArrayArena, ptr );
+}
+
+STATIC enum ArrayArenaStatus StaticArrayTryAlloc(size_t req_bytes, void ** ptr, size_t * granted)
+{
+   return ArrayArenaTryAlloc( &ArrayArena, req_bytes, ptr, granted );
+}
+
+STATIC enum ArrayArenaStatus StaticArrayTryRealloc(void ** ptr, size_t req_bytes, size_t * granted)
+{
+   return ArrayArenaTryRealloc( &ArrayArena, ptr, req_bytes, granted );
+}
+
+STATIC enum ArrayArenaStatus StaticArrayTryFree(const void * ptr)
+{
+   return ArrayArenaTryFree( &ArrayArena, ptr );
+}
+
+STATIC size_t StaticArrayAllocBatch(size_t req_bytes, size_t n, void * out[])
+{
+   return ArrayArenaAllocBatch( &ArrayArena, req_bytes, n, out );
+}
+
+STATIC void StaticArrayFreeBatch(void * const ptrs[], size_t n)
+{
+   ArrayArenaFreeBatch( &ArrayArena, ptrs, n );
+}
+
+#ifdef ARRAY_ARENA_STATS
+STATIC void StaticArrayGetStats(struct ArrayArenaStats_S * stats)
+{
+   ArrayArenaGetStats( &ArrayArena, stats );
+}
+#endif
+
+#ifdef ARRAY_ARENA_HARDENED
+STATIC void StaticArraySetFaultCb(ArrayArenaFaultCb_T cb, void * ctx)
+{
+   ArrayArenaSetFaultCb( &ArrayArena, cb, ctx );
+}
+
+STATIC size_t StaticArrayFaultCount(enum ArrayArenaFault fault)
+{
+   return ArrayArenaFaultCount( &ArrayArena, fault );
+}
+#endif
+
+#ifdef ARRAY_ARENA_TAGS
+STATIC void * StaticArrayAllocTagged(size_t req_bytes, ArrayArenaTag_T tag)
+{
+   return ArrayArenaAllocTagged( &ArrayArena, req_bytes, tag );
+}
+
+STATIC bool StaticArraySetTag(const void * ptr, ArrayArenaTag_T tag)
+{
+   return ArrayArenaSetTag( &ArrayArena, ptr, tag );
+}
+
+STATIC bool StaticArrayGetTagStats(ArrayArenaTag_T tag, struct ArrayArenaTagStats_S * stats)
+{
+   return ArrayArenaGetTagStats( &ArrayArena, tag, stats );
+}
+#endif
+
+#ifdef ARRAY_ARENA_TELEMETRY
+STATIC size_t StaticArrayTelemetryDrain(ArrayArenaTelemSink_T sink, void * ctx)
+{
+   return ArrayArenaTelemetryDrain( &ArrayArena, sink, ctx );
+}
+#endif
+
+/**
+ * @brief Set up an arena over the len bytes at buffer.
+ * @note The arena's free bitmaps and lookup tables are carved out of the end
+ *       of the buffer, and blocks are handed out from the rest of it (rounded
+ *       down to a multiple of the granule size). The free lists start out
+ *       /w the default lengths (largest size first) for that many bytes. Any
+ *       bytes at the start of the buffer before the pool alignment are left
+ *       unused. The buffer is the arena's for as long as the arena is in use.
+ *       /w ARRAY_ARENA_PERSISTENT, the pool starts after a header that lets
+ *       ArrayArenaAttach() set an arena back up over the buffer later.
+ * @return true if successful; false if the buffer is too small to hold a block
+ *         along /w the metadata (or /w ARRAY_ARENA_REALTIME, too large for the
+ *         summary bitmaps to cover)
+ */
+STATIC bool ArrayArenaInit(struct ArrayArena_S * arena, void * buffer, size_t len)
+{
+   if ( (NULL == arena) || (NULL == buffer) )   return false;
+   if ( !Helper_CarveArena( arena, buffer, len ) )   return false;
+
+   memset( &arena->pool[arena->pool_size], 0, Helper_MetadataBytes( arena->pool_size ) );
+   HARDEN_POISON( arena, arena->pool, arena->pool_size ); // The buffer holds whatever it held before
+   Helper_ResetArenaState( arena );
+#ifdef ARRAY_ARENA_SHARED
+   __atomic_store_n( arena->remote_free_head, ARRAY_ARENA_NO_REMOTE_FREE, __ATOMIC_RELEASE );
+#endif
+
+   size_t list_init_lens[NUM_OF_BLOCK_SIZES];
+   for ( uint8_t i = 0; i < (uint8_t)NUM_OF_BLOCK_SIZES; i++ )
+   {
+      list_init_lens[i] = DEFAULT_LIST_INIT_LEN( arena->pool_size, BlockSize_E_to_Int[i] );
+   }
+   arena->arena_initialized = false;
+   Helper_LayoutFreeLists( arena, list_init_lens );
+#ifdef ARRAY_ARENA_PERSISTENT
+   struct ArrayArenaPersistHdr_S hdr =
+   {
+      .magic = ARRAY_ARENA_PERSIST_MAGIC,
+      .version = ARRAY_ARENA_PERSIST_VERSION,
+      .hdr_size = (uint16_t)sizeof(struct ArrayArenaPersistHdr_S),
+      .layout = Helper_PersistLayout(),
+      .checksum = 0,
+      .len = (uint64_t)len,
+      .pool_size = (uint64_t)arena->pool_size,
+      .space = (uint64_t)arena->space_available
+   };
+   hdr.checksum = Helper_PersistChecksum( &hdr );
+   memcpy( PERSIST_HDR_AT(arena), &hdr, sizeof(hdr) );
+#endif
+   return true;
+}
+
+#ifdef ARRAY_ARENA_PERSISTENT
+/**
+ * @brief Set an arena back up over the len bytes at buffer, which an arena was
+ *        set up over by ArrayArenaInit() before (in this run or a previous
+ *        one), picking up the blocks that were allocated as they were left.
+ * @note The buffer must be at the same pool alignment as it was then, and of
+ *       the same len. Nothing in the pool is touched.
+ * @return true if successful; false if the buffer does not hold an arena of
+ *         this config, or its metadata does not check out (e.g., the arena was
+ *         left in the middle of an alloc or free)
+ */
+STATIC bool ArrayArenaAttach(struct ArrayArena_S * arena, void * buffer, size_t len)
+{
+   if ( (NULL == arena) || (NULL == buffer) )   return false;
+   arena->arena_initialized = false;
+   if ( !Helper_CarveArena( arena, buffer, len ) )   return false;
+
+   if ( !Helper_PersistHdrIsValid( arena, len ) )   return false;
+
+   // Blocks that peers freed while the arena had no owner stay queued
+   Helper_ResetArenaState( arena );
+#ifdef ARRAY_ARENA_TELEMETRY
+   // Whatever the last run left in the ring was either drained or is lost now
+   memset( arena->telem.recs, 0, ARRAY_ARENA_TELEMETRY_RING_LEN * sizeof(struct ArrayArenaTelemRec_S) );
+#endif
+   arena->arena_initialized = true;
+   if ( !Helper_PersistRebuild( arena ) )
+   {
+      arena->arena_initialized = false;
+      return false;
+   }
+   return true;
+}
+#endif // ARRAY_ARENA_PERSISTENT
+
+#ifdef ARRAY_ARENA_SHARED
+/**
+ * @brief Open the len bytes at buffer (as mapped by this process) as a peer of
+ *        the shared arena that was set up over them by its owner.
+ * @note The same pool alignment and len as the owner's mapping apply.
+ * @return true if successful; false if the buffer does not hold an arena of this config
+ */
+STATIC bool ArrayArenaPeerOpen(struct ArrayArenaPeer_S * peer, void * buffer, size_t len)
+{
+   if ( (NULL == peer) || (NULL == buffer) )   return false;
+
+   // The owner's metadata is looked at for where it is, not for what is in it
+   struct ArrayArena_S layout;
+   if ( !Helper_CarveArena( &layout, buffer, len ) || !Helper_PersistHdrIsValid( &layout, len ) )   return false;
+
+   peer->pool = layout.pool;
+   peer->pool_size = layout.pool_size;
+   peer->remote_free_head = layout.remote_free_head;
+   return true;
+}
+
+/**
+ * @brief The address of the block at offset within a shared arena's pool, as
+ *        mapped by this peer.
+ * @return The address; NULL if offset is not within the pool
+ */
+STATIC void * ArrayArenaPeerAt(const struct ArrayArenaPeer_S * peer, size_t offset)
+{
+   if ( offset >= peer->pool_size )   return NULL;
+
+   return &peer->pool[offset];
+}
+
+/**
+ * @brief Hand the block at offset back to the owner of a shared arena.
+ * @note Lock-free, and the owner need not be running. The first word of the
+ *       block is overwritten. The owner checks the block as for any other
+ *       free when it takes it back.
+ * @return true if queued; false if offset cannot be that of a block
+ */
+STATIC bool ArrayArenaPeerFree(const struct ArrayArenaPeer_S * peer, size_t offset)
+{
+   if ( (offset >= peer->pool_size) || ((offset % ARRAY_ARENA_GRANULE_SIZE) != 0) )   return false;
+
+   Helper_RemoteFreePush( peer->pool, peer->remote_free_head, (uint32_t)offset );
+   return true;
+}
+
+/**
+ * @brief Take back the blocks that peers have freed, /wout waiting for the
+ *        next alloc to do so (e.g., before ArrayArenaGetStats(), or when idle).
+ * @return How many blocks were taken back
+ */
+STATIC size_t ArrayArenaReclaim(struct ArrayArena_S * arena)
+{
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   ARRAY_ARENA_LOCK( arena );
+   size_t num_of_blks = Helper_SharedReclaim( arena );
+   ARRAY_ARENA_UNLOCK( arena );
+   return num_of_blks;
+#else
+   return Helper_SharedReclaim( arena );
+#endif
+}
+#endif // ARRAY_ARENA_SHARED
+
+/**
+ * Check that an arena is initialized.
+ */
+STATIC bool ArrayArenaIsInitialized(const struct ArrayArena_S * arena)
+{
+   return arena->arena_initialized;
+}
+
+/**
+ * @brief Allocates a contiguous block that can accomodate req_bytes from
+ *        an arena. Block size guaranteed to be ≥req_bytes.
+ * @note Presently uses the "Buddy System" as described in:
+ *          memorymanagement.org/mmref/alloc.html
+ *       If no block of the best-fit size is free, the nearest larger free
+ *       block is split in halves down to that size. Freed blocks are merged
+ *       back /w their buddies (see Helper_CoalesceBlock()), or only once
+ *       nothing free is large enough, /w ARRAY_ARENA_LAZY_COALESCE.
+ *       Requests larger than the largest block size are granted a run of
+ *       consecutive free largest blocks.
+ * @return Pointer to the allocated block if successful, NULL otherwise.
+ */
+STATIC void * ArrayArenaAlloc(struct ArrayArena_S * arena, size_t req_bytes)
+{
+   STATS_CYCLES_START( start );
+   void * ptr;
+
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   if ( !Helper_CacheAlloc( arena, req_bytes, &ptr ) )
+   {
+      ARRAY_ARENA_LOCK( arena );
+      ptr = Helper_ArenaAllocUncounted( arena, req_bytes );
+      ARRAY_ARENA_UNLOCK( arena );
+      if ( NULL == ptr )
+      {
+         // As Helper_CacheAllocAs() does, don't fail while the caller's cache
+         // sits on free blocks (runs and trimmed blocks never come from it)
+         Helper_CacheFlushMine( arena );
+         ARRAY_ARENA_LOCK( arena );
+         ptr = Helper_ArenaAlloc( arena, req_bytes );
+         ARRAY_ARENA_UNLOCK( arena );
+      }
+   }
+#else
+   ptr = Helper_ArenaAlloc( arena, req_bytes );
+#endif
+
+   STATS_CYCLES_END( arena, alloc_cycles, start );
+   return ptr;
+}
+
+/**
+ * @brief Allocates a block of a size class (see sara.h) for req_bytes, as
+ *        ArrayArenaAlloc() does, but /wout working out which block fits.
+ * @note A class too small for req_bytes (e.g., of ARRAY_ARENA_SIZE_CLASS() for
+ *       more than the largest block size) goes through ArrayArenaAlloc().
+ * @return Pointer to the allocated block if successful, NULL otherwise.
+ */
+STATIC void * ArrayArenaAllocClass(struct ArrayArena_S * arena, uint8_t size_class, size_t req_bytes)
+{
+#ifdef ARRAY_ARENA_CACHE_LINE_ISOLATION
+   // In a pool aligned to a line, a block of at least a line shares it /w no other
+   if ( size_class > ARRAY_ARENA_BYTES_CLASS(ARRAY_ARENA_CACHE_LINE_SIZE) )
+   {
+      size_class = ARRAY_ARENA_BYTES_CLASS(ARRAY_ARENA_CACHE_LINE_SIZE);
+   }
+#endif
+   if ( (size_class >= (uint8_t)NUM_OF_BLOCK_SIZES) ||
+        ((BlockSize_E_to_Int[size_class] - CANARY_BYTES) < req_bytes) )
+   {
+      return ArrayArenaAlloc( arena, req_bytes );
+   }
+
+   STATS_CYCLES_START( start );
+   void * ptr;
+
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   struct ArrayPoolBlock_S blk = { .sz = (enum BlockSize)size_class, .idx = 0, .trimmed = false,
+                                   .movable = false, .run_len = 0 };
+   if ( !Helper_CacheAllocAs( arena, &blk, req_bytes, &ptr ) )
+   {
+      ARRAY_ARENA_LOCK( arena );
+      ptr = Helper_ArenaAllocClass( arena, (enum BlockSize)size_class, req_bytes );
+      ARRAY_ARENA_UNLOCK( arena );
+   }
+#else
+   ptr = Helper_ArenaAllocClass( arena, (enum BlockSize)size_class, req_bytes );
+#endif
+
+   STATS_CYCLES_END( arena, alloc_cycles, start );
+   return ptr;
+}
+
+/**
+ * @brief Allocates a block that can accomodate req_bytes, at an address that
+ *        is a multiple of alignment (a power of 2).
+ * @note Blocks are aligned to their size relative to the start of the pool,
+ *       so this is an alloc of at least alignment bytes, and the pool itself
+ *       has to be aligned at least as well.
+ * @return Pointer to the allocated block if successful, NULL otherwise
+ *         (including for an alignment that cannot be had).
+ */
+STATIC void * ArrayArenaAllocAligned(struct ArrayArena_S * arena, size_t req_bytes, size_t alignment)
+{
+   if ( (0 == alignment) || ((alignment & (alignment - 1)) != 0) ||
+        (alignment > LARGEST_BLOCK_SIZE) || (ALIGN_UP_GAP( arena->pool, alignment ) != 0) )
+   {
+      return NULL;
+   }
+
+   return ArrayArenaAlloc( arena, (req_bytes < alignment) ? alignment : req_bytes );
+}
+
+/**
+ * @brief Resizes the block at ptr to accomodate req_bytes.
+ * @note The block is resized in place whenever the best fit for req_bytes can
+ *       start where the block already does: shrinking hands the excess back to
+ *       the free lists, and growing takes the free buddies that follow the
+ *       block. Only otherwise is a new block allocated and the contents copied.
+ * @return Pointer to the resized block. If a new block could not be allocated,
+ *         the original ptr is returned and the block is left as it was.
+ */
+STATIC void * ArrayArenaRealloc(struct ArrayArena_S * arena, void * ptr, size_t req_bytes)
+{
+   void * new_ptr = ptr;
+   enum ArrayArenaStatus status = ArrayArenaTryRealloc( arena, &new_ptr, req_bytes, NULL );
+
+   return ((ARRAY_ARENA_INVALID_PTR == status) || (ARRAY_ARENA_DOUBLE_FREE == status)) ? NULL : new_ptr;
+}
+
+/**
+ * @brief Allocates a block that can accomodate req_bytes, as ArrayArenaAlloc() does.
+ * @note Why a request failed is only worked out once it has, so this costs no
+ *       more than ArrayArenaAlloc() on success (/w granted, a lookup in the
+ *       granule table).
+ * @return ARRAY_ARENA_OK, ARRAY_ARENA_TOO_LARGE, ARRAY_ARENA_OUT_OF_SPACE, or
+ *         ARRAY_ARENA_FRAGMENTED
+ */
+STATIC enum ArrayArenaStatus ArrayArenaTryAlloc(struct ArrayArena_S * arena, size_t req_bytes,
+                                                void ** ptr, size_t * granted)
+{
+   *ptr = ArrayArenaAlloc( arena, req_bytes );
+   if ( granted != NULL )   *granted = Helper_GrantedBytes( arena, *ptr );
+   if ( *ptr != NULL )   return ARRAY_ARENA_OK;
+
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   ARRAY_ARENA_LOCK( arena );
+   enum ArrayArenaStatus status = Helper_AllocFailure( arena, req_bytes, 0 );
+   ARRAY_ARENA_UNLOCK( arena );
+   return status;
+#else
+   return Helper_AllocFailure( arena, req_bytes, 0 );
+#endif
+}
+
+/**
+ * @brief Resizes the block at *ptr as ArrayArenaRealloc() does, updating *ptr
+ *        if the block is moved (or set to NULL, if freed for a req_bytes of 0).
+ * @note On failure, granted is that of the block as it was left.
+ * @return ARRAY_ARENA_OK, or any of the failures of ArrayArenaTryAlloc() and
+ *         ArrayArenaTryFree()
+ */
+STATIC enum ArrayArenaStatus ArrayArenaTryRealloc(struct ArrayArena_S * arena, void ** ptr,
+                                                  size_t req_bytes, size_t * granted)
+{
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   ARRAY_ARENA_LOCK( arena );
+   enum ArrayArenaStatus status = Helper_ArenaReallocUncounted( arena, ptr, req_bytes );
+   ARRAY_ARENA_UNLOCK( arena );
+   if ( Helper_IsAllocFailure( status ) )
+   {
+      // The block was left as it was, so try again once the caller's cache is
+      // back in the shared free lists, as for ArrayArenaAlloc()
+      Helper_CacheFlushMine( arena );
+      ARRAY_ARENA_LOCK( arena );
+      status = Helper_ArenaRealloc( arena, ptr, req_bytes );
+      ARRAY_ARENA_UNLOCK( arena );
+   }
+#elif defined(ARRAY_ARENA_TAGS)
+   // Whichever way the block ends up resized, it stays /w its owner
+   TAGS_ALLOC_AS( arena, Helper_BlockTag( arena, *ptr ) );
+   enum ArrayArenaStatus status = Helper_ArenaRealloc( arena, ptr, req_bytes );
+   TAGS_ALLOC_AS( arena, ARRAY_ARENA_UNTAGGED );
+#else
+   enum ArrayArenaStatus status = Helper_ArenaRealloc( arena, ptr, req_bytes );
+#endif
+
+   if ( granted != NULL )   *granted = Helper_GrantedBytes( arena, *ptr );
+   return status;
+}
+
+/**
+ * @brief Free the block at the address passed in, if applicable.
+ * @note If the address passed in is not one that a block lives at, the fcn simply returns.
+ * @param[in] Address of block to free
+ */
+STATIC void ArrayArenaFree(struct ArrayArena_S * arena, const void * ptr)
+{
+   STATS_CYCLES_START( start );
+
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   if ( !Helper_CacheFree( arena, ptr ) )
+   {
+      ARRAY_ARENA_LOCK( arena );
+      Helper_ArenaFree( arena, ptr );
+      ARRAY_ARENA_UNLOCK( arena );
+   }
+#else
+   Helper_ArenaFree( arena, ptr );
+#endif
+
+   STATS_CYCLES_END( arena, free_cycles, start );
+}
+
+/**
+ * @brief Free the block at ptr as ArrayArenaFree() does.
+ * @note In thread-safe mode, a block sitting in a thread's cache is not in
+ *       free memory as far as the free lists are concerned, so a double free
+ *       of one is told as ARRAY_ARENA_INVALID_PTR.
+ * @return ARRAY_ARENA_OK, ARRAY_ARENA_INVALID_PTR, or ARRAY_ARENA_DOUBLE_FREE
+ */
+STATIC enum ArrayArenaStatus ArrayArenaTryFree(struct ArrayArena_S * arena, const void * ptr)
+{
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   // Whoever holds a block may look it up /wout the lock (see Helper_CacheFree())
+   if ( (NULL == ptr) || Helper_FindBlock( arena, ptr, NULL ) )
+   {
+      ArrayArenaFree( arena, ptr );
+      return ARRAY_ARENA_OK;
+   }
+
+   ARRAY_ARENA_LOCK( arena );
+   enum ArrayArenaStatus status = Helper_BadPtrStatus( arena, ptr );
+   ARRAY_ARENA_UNLOCK( arena );
+   return status;
+#else
+   STATS_CYCLES_START( start );
+   enum ArrayArenaStatus status = Helper_ArenaFree( arena, ptr );
+   STATS_CYCLES_END( arena, free_cycles, start );
+   return status;
+#endif
+}
+
+/**
+ * @brief Determine whether an address is associated with a block that is allocated.
+ */
+STATIC bool ArrayArenaIsAlloc(struct ArrayArena_S * arena, const void * ptr)
+{
+   struct ArrayPoolBlock_S blk;
+   bool blk_found = Helper_FindBlock( arena, ptr, &blk );
+
+   // Only allocated blocks are in the granule lookup table. (In thread-safe
+   // mode, the free lists can't be looked at /wout the lock.)
+#ifndef ARRAY_ARENA_THREAD_SAFE
+   assert( !blk_found || !Helper_IsBlockFree( arena, blk.sz, blk.idx ) );
+#endif
+   return blk_found;
+}
+
+/**
+ * @brief Allocate n blocks that can each accomodate req_bytes.
+ * @note The best fit is worked out once for the whole batch. Plain blocks are
+ *       taken straight off the free bitmap of their size in a single pass, and
+ *       if there are not enough, larger blocks are split up whole to make up
+ *       the rest, rather than being split once per block.
+ * @return How many blocks were allocated (into out[0], out[1], ...)
+ */
+STATIC size_t ArrayArenaAllocBatch(struct ArrayArena_S * arena, size_t req_bytes, size_t n, void * out[])
+{
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   ARRAY_ARENA_LOCK( arena );
+   size_t num_of_blks = Helper_ArenaAllocBatch( arena, req_bytes, n, out );
+   ARRAY_ARENA_UNLOCK( arena );
+   return num_of_blks;
+#else
+   return Helper_ArenaAllocBatch( arena, req_bytes, n, out );
+#endif
+}
+
+/**
+ * @brief Free the blocks at the addresses passed in, if applicable.
+ * @note Addresses that are not ones a block lives at (e.g., the NULLs at the
+ *       end of a partly allocated batch) are skipped.
+ */
+STATIC void ArrayArenaFreeBatch(struct ArrayArena_S * arena, void * const ptrs[], size_t n)
+{
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   ARRAY_ARENA_LOCK( arena );
+   Helper_ArenaFreeBatch( arena, ptrs, n );
+   ARRAY_ARENA_UNLOCK( arena );
+#else
+   Helper_ArenaFreeBatch( arena, ptrs, n );
+#endif
+}
+
+#ifdef ARRAY_ARENA_STATS
+/**
+ * @brief Take a snapshot of an arena's statistics.
+ * @note In thread-safe mode, each counter is read atomically, but the snapshot
+ *       as a whole may be torn by allocs and frees going on at the same time.
+ */
+STATIC void ArrayArenaGetStats(const struct ArrayArena_S * arena, struct ArrayArenaStats_S * stats)
+{
+   const size_t * src = (const size_t *)(const void *)&arena->stats;
+   size_t * dst = (size_t *)(void *)stats;
+
+   for ( size_t i = 0; i < (sizeof(*stats) / sizeof(size_t)); i++ )   dst[i] = STATS_LOAD( src[i] );
+}
+#endif // ARRAY_ARENA_STATS
+
+#ifdef ARRAY_ARENA_HARDENED
+/**
+ * @brief Set (or clear, /w NULL) the callback that faults are reported to.
+ * @note The callback is called from /win the alloc, free, or realloc that ran
+ *       into the fault, and must not call back into the arena.
+ */
+STATIC void ArrayArenaSetFaultCb(struct ArrayArena_S * arena, ArrayArenaFaultCb_T cb, void * ctx)
+{
+   arena->fault_cb = cb;
+   arena->fault_ctx = ctx;
+}
+
+/**
+ * @brief How many faults of a kind an arena has run into since it was set up.
+ */
+STATIC size_t ArrayArenaFaultCount(const struct ArrayArena_S * arena, enum ArrayArenaFault fault)
+{
+   return ( fault < NUM_OF_ARRAY_ARENA_FAULTS ) ? arena->faults[fault] : 0;
+}
+#endif // ARRAY_ARENA_HARDENED
+
+#ifdef ARRAY_ARENA_TAGS
+/**
+ * @brief Same as ArrayArenaAlloc(), /w the block charged to tag.
+ * @return NULL if tag is not below ARRAY_ARENA_MAX_TAGS, or if the alloc fails
+ */
+STATIC void * ArrayArenaAllocTagged(struct ArrayArena_S * arena, size_t req_bytes, ArrayArenaTag_T tag)
+{
+   if ( tag >= ARRAY_ARENA_MAX_TAGS )   return NULL;
+
+   TAGS_ALLOC_AS( arena, tag );
+   void * ptr = ArrayArenaAlloc( arena, req_bytes );
+   TAGS_ALLOC_AS( arena, ARRAY_ARENA_UNTAGGED );
+   return ptr;
+}
+
+/**
+ * @brief Hand the allocated block at ptr over to another owner.
+ * @return true if successful; false if ptr is not an allocated block, or if
+ *         tag is not below ARRAY_ARENA_MAX_TAGS
+ */
+STATIC bool ArrayArenaSetTag(struct ArrayArena_S * arena, const void * ptr, ArrayArenaTag_T tag)
+{
+   struct ArrayPoolBlock_S blk;
+   if ( (tag >= ARRAY_ARENA_MAX_TAGS) || !Helper_FindBlock( arena, ptr, &blk ) )   return false;
+
+   // The block stays where it is; it is only charged to the new tag
+   Helper_UnindexBlock( arena, &blk );
+   TAGS_ALLOC_AS( arena, tag );
+   Helper_IndexBlock( arena, &blk );
+   TAGS_ALLOC_AS( arena, ARRAY_ARENA_UNTAGGED );
+   return true;
+}
+
+/**
+ * @brief Take a snapshot of what a tag holds, and has held at most.
+ * @return true if successful; false if tag is not below ARRAY_ARENA_MAX_TAGS
+ */
+STATIC bool ArrayArenaGetTagStats(const struct ArrayArena_S * arena, ArrayArenaTag_T tag,
+                                  struct ArrayArenaTagStats_S * stats)
+{
+   if ( (tag >= ARRAY_ARENA_MAX_TAGS) || (NULL == stats) )   return false;
+
+   *stats = arena->tag_stats[tag];
+   return true;
+}
+#endif // ARRAY_ARENA_TAGS
+
+#ifdef ARRAY_ARENA_TELEMETRY
+/**
+ * @brief Hand the records in an arena's telemetry ring over to a sink, oldest
+ *        first, for as long as the sink takes them.
+ * @note Meant to be called from a background task. It only ever waits on the
+ *       sink, never the other way around. If records were dropped since the
+ *       last drain, a LOST record saying how many goes first; if the arena
+ *       has yet to be described (see ArrayArenaTelemetryRefresh()), INFO
+ *       records go before that. /w ARRAY_ARENA_TAGS, a TAG record for each
+ *       tag whose holdings changed (for each tag that has held anything, after
+ *       INFO records) goes right before the LOST record. At most a ring's
+ *       worth of records is drained
+ *       per call, so that a busy arena cannot keep the caller in here. Only
+ *       one drain may run on an arena at a time.
+ * @return How many records from the ring the sink took
+ */
+STATIC size_t ArrayArenaTelemetryDrain(struct ArrayArena_S * arena, ArrayArenaTelemSink_T sink, void * ctx)
+{
+   if ( NULL == sink )   return 0;
+
+   struct ArrayArenaTelemRing_S * ring = &arena->telem;
+
+   if ( ring->info_pending )
+   {
+      for ( uint8_t i = 0; i < (uint8_t)NUM_OF_BLOCK_SIZES; i++ )
+      {
+         // Whatever was taken before the sink gave up is simply sent again
+         if ( !Helper_TelemSendOne( sink, ctx, ARRAY_ARENA_TELEM_INFO, i,
+                                    arena->pool_size, arena->lists[i].block_size ) )
+         {
+            return 0;
+         }
+      }
+#ifdef ARRAY_ARENA_TAGS
+      __atomic_store_n( &arena->tags_dirty, UINT32_MAX >> (32 - ARRAY_ARENA_MAX_TAGS), __ATOMIC_RELAXED );
+#endif
+      ring->info_pending = false;
+   }
+
+#ifdef ARRAY_ARENA_TAGS
+   // What each tag holds is a snapshot of the moment it is sent, and may be
+   // behind whatever allocs and frees are in the ring
+   uint32_t tags_dirty = __atomic_exchange_n( &arena->tags_dirty, 0, __ATOMIC_RELAXED );
+   while ( tags_dirty != 0 )
+   {
+      uint8_t tag = Helper_Ctz32( tags_dirty );
+      const struct ArrayArenaTagStats_S * stats = &arena->tag_stats[tag];
+      if ( (stats->peak_bytes > 0) &&
+           !Helper_TelemSendOne( sink, ctx, ARRAY_ARENA_TELEM_TAG, tag, stats->live_bytes, stats->peak_bytes ) )
+      {
+         __atomic_or_fetch( &arena->tags_dirty, tags_dirty, __ATOMIC_RELAXED );
+         return 0;
+      }
+      tags_dirty &= tags_dirty - 1u;
+   }
+#endif
+
+   size_t dropped = __atomic_exchange_n( &ring->dropped, 0, __ATOMIC_RELAXED );
+   if ( (dropped > 0) &&
+        !Helper_TelemSendOne( sink, ctx, ARRAY_ARENA_TELEM_LOST, ARRAY_ARENA_TELEM_NO_SIZE, 0, dropped ) )
+   {
+      __atomic_add_fetch( &ring->dropped, dropped, __ATOMIC_RELAXED );
+      return 0;
+   }
+
+   size_t num_drained = 0;
+   size_t tail = ring->tail;
+   while ( num_drained < ARRAY_ARENA_TELEMETRY_RING_LEN )
+   {
+      // Hand over however many records are ready in a row, up to the end of
+      // the ring, straight out of the ring
+      size_t slot = tail & (ARRAY_ARENA_TELEMETRY_RING_LEN - 1);
+      size_t num_ready = 0;
+      while ( ((slot + num_ready) < ARRAY_ARENA_TELEMETRY_RING_LEN) &&
+              ((num_drained + num_ready) < ARRAY_ARENA_TELEMETRY_RING_LEN) &&
+              (__atomic_load_n( &ring->recs[slot + num_ready].seq, __ATOMIC_ACQUIRE ) ==
+               (uint16_t)(tail + num_ready + 1)) )
+      {
+         num_ready++;
+      }
+      if ( 0 == num_ready )   break;
+
+      size_t num_taken = sink( ctx, &ring->recs[slot], num_ready );
+      if ( num_taken > num_ready )   num_taken = num_ready;
+      tail += num_taken;
+      num_drained += num_taken;
+      __atomic_store_n( &ring->tail, tail, __ATOMIC_RELEASE ); // The slots are free to be written again
+      if ( num_taken < num_ready )   break;
+   }
+
+   return num_drained;
+}
+
+/**
+ * @brief Have the next drain start by describing the arena (e.g., for a
+ *        decoder that has just connected).
+ */
+STATIC void ArrayArenaTelemetryRefresh(struct ArrayArena_S * arena)
+{
+   arena->telem.info_pending = true;
+}
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+// ITM stimulus port the ITM sink writes to. The application has to have set
+// up the ITM and SWO, and enabled the port.
+#ifndef ARRAY_ARENA_TELEMETRY_ITM_PORT
+#define ARRAY_ARENA_TELEMETRY_ITM_PORT 1
+#endif
+#define ITM_STIM_PORT ( *(volatile uint32_t *)(0xE0000000u + (4u * ARRAY_ARENA_TELEMETRY_ITM_PORT)) )
+
+/**
+ * @brief Sink that writes records out over SWO, through an ITM stimulus port
+ *        (see ARRAY_ARENA_TELEMETRY_ITM_PORT). ctx is unused.
+ * @note Stops at the first record that the ITM FIFO has no room for, so it
+ *       only ever waits on the few words of a record already begun.
+ */
+STATIC size_t ArrayArenaTelemetryItmSink(void * ctx, const struct ArrayArenaTelemRec_S recs[], size_t n)
+{
+   (void)ctx;
+
+   for ( size_t i = 0; i < n; i++ )
+   {
+      // Reads as 1 while the FIFO can take a word
+      if ( 0 == (ITM_STIM_PORT & 1u) )   return i;
+
+      uint32_t words[sizeof(recs[i]) / sizeof(uint32_t)];
+      memcpy( words, &recs[i], sizeof(words) );
+      for ( uint8_t w = 0; w < (uint8_t)(sizeof(words) / sizeof(words[0])); w++ )
+      {
+         while ( 0 == (ITM_STIM_PORT & 1u) )
+         {
+            // The FIFO drains a word in a few SWO bit times
+         }
+         ITM_STIM_PORT = words[w];
+      }
+   }
+
+   return n;
+}
+#endif
+#endif // ARRAY_ARENA_TELEMETRY
+
+#ifdef ARRAY_ARENA_HANDLES
+
+/**
+ * @brief Local helper function to get the table entry of a handle that is in use.
+ * @return Ptr to the entry, or NULL if the handle is not one in use
+ */
+static struct ArrayArenaHandle_S * Helper_HandleEntry( struct ArrayArena_S * arena, ArrayArenaHandle_T handle );
+
+/**
+ * @brief Local helper function to point a handle at a(nother) block, or at
+ *        none (NULL).
+ */
+static void Helper_SetHandleBlock( struct ArrayArena_S * arena, ArrayArenaHandle_T handle, void * ptr );
+
+STATIC ArrayArenaHandle_T StaticArrayHandleAlloc(size_t req_bytes)
+{
+   return ArrayArenaHandleAlloc( &ArrayArena, req_bytes );
+}
+
+STATIC bool StaticArrayHandleRealloc(ArrayArenaHandle_T handle, size_t req_bytes)
+{
+   return ArrayArenaHandleRealloc( &ArrayArena, handle, req_bytes );
+}
+
+STATIC void StaticArrayHandleFree(ArrayArenaHandle_T handle)
+{
+   ArrayArenaHandleFree( &ArrayArena, handle );
+}
+
+STATIC void * StaticArrayHandleLock(ArrayArenaHandle_T handle)
+{
+   return ArrayArenaHandleLock( &ArrayArena, handle );
+}
+
+STATIC void StaticArrayHandleUnlock(ArrayArenaHandle_T handle)
+{
+   ArrayArenaHandleUnlock( &ArrayArena, handle );
+}
+
+/**
+ * @brief Allocate a block that can accomodate req_bytes, and get a handle to it.
+ * @return Handle to the block if successful, ARRAY_ARENA_NULL_HANDLE otherwise.
+ */
+STATIC ArrayArenaHandle_T ArrayArenaHandleAlloc(struct ArrayArena_S * arena, size_t req_bytes)
+{
+   ArrayArenaHandle_T handle = arena->handles.free_head;
+   bool from_free_list = (handle != ARRAY_ARENA_NULL_HANDLE);
+
+   if ( from_free_list )
+   {
+      arena->handles.free_head = arena->handles.entries[handle].next_free;
+   }
+   else if ( arena->handles.num_untouched <= ARRAY_ARENA_MAX_HANDLES )
+   {
+      handle = (ArrayArenaHandle_T)arena->handles.num_untouched++;
+   }
+   else
+   {
+      return ARRAY_ARENA_NULL_HANDLE;
+   }
+
+   void * ptr = ArrayArenaAlloc( arena, req_bytes );
+   if ( NULL == ptr )
+   {
+      arena->handles.entries[handle].next_free = arena->handles.free_head;
+      arena->handles.free_head = handle;
+      return ARRAY_ARENA_NULL_HANDLE;
+   }
+
+   arena->handles.entries[handle].pins = 0;
+   Helper_SetHandleBlock( arena, handle, ptr );
+#ifdef ARRAY_ARENA_DEFRAG
+   (void)ArrayArenaSetMovable( arena, ptr, true );
+#endif
+   return handle;
+}
+
+/**
+ * @brief Resize the block a handle refers to. The block may move.
+ * @note Fails if the handle is locked, since the block would have to stay put.
+ * @return true if the block now accomodates req_bytes; false if it was left as it was
+ */
+STATIC bool ArrayArenaHandleRealloc(struct ArrayArena_S * arena, ArrayArenaHandle_T handle, size_t req_bytes)
+{
+   struct ArrayArenaHandle_S * entry = Helper_HandleEntry( arena, handle );
+
+   // Freeing is left to ArrayArenaHandleFree() so that the handle is freed too
+   if ( (NULL == entry) || (entry->pins > 0) || (0 == req_bytes) )   return false;
+
+   void * ptr = ArrayArenaRealloc( arena, entry->ptr, req_bytes );
+
+   // ArrayArenaRealloc() hands back the old block if it fails, so check what we got
+   struct ArrayPoolBlock_S blk;
+   if ( !Helper_FindBlock( arena, ptr, &blk ) ||
+        ((Helper_BlockBytes( &blk ) - CANARY_BYTES) < req_bytes) )
+   {
+      return false;
+   }
+
+   Helper_SetHandleBlock( arena, handle, ptr );
+   return true;
+}
+
+/**
+ * @brief Free the block a handle refers to, along with the handle itself.
+ * @note A handle that is not in use (stale, or freed already) is ignored, and
+ *       /w ARRAY_ARENA_HARDENED, counted as an ARRAY_ARENA_FAULT_BAD_HANDLE.
+ *       Freeing the null handle does nothing.
+ */
+STATIC void ArrayArenaHandleFree(struct ArrayArena_S * arena, ArrayArenaHandle_T handle)
+{
+   struct ArrayArenaHandle_S * entry = Helper_HandleEntry( arena, handle );
+   if ( NULL == entry )
+   {
+      if ( handle != ARRAY_ARENA_NULL_HANDLE )   HARDEN_BAD_HANDLE( arena );
+      return;
+   }
+
+   ArrayArenaFree( arena, entry->ptr );
+   Helper_SetHandleBlock( arena, handle, NULL );
+   entry->pins = 0;
+   entry->next_free = arena->handles.free_head;
+   arena->handles.free_head = handle;
+}
+
+/**
+ * @brief Lock a handle in place and get a pointer to its block.
+ * @note The pointer is good until the matching ArrayArenaHandleUnlock(). Locks
+ *       nest, and the block may move again once all of them have been undone.
+ * @return Pointer to the block, or NULL if the handle is not one in use
+ */
+STATIC void * ArrayArenaHandleLock(struct ArrayArena_S * arena, ArrayArenaHandle_T handle)
+{
+   struct ArrayArenaHandle_S * entry = Helper_HandleEntry( arena, handle );
+   if ( NULL == entry )   return NULL;
+
+   assert( entry->pins < UINT16_MAX );
+   if ( 0 == entry->pins++ )
+   {
+#ifdef ARRAY_ARENA_DEFRAG
+      (void)ArrayArenaSetMovable( arena, entry->ptr, false );
+#endif
+   }
+
+   return entry->ptr;
+}
+
+/**
+ * @brief Undo a ArrayArenaHandleLock().
+ */
+STATIC void ArrayArenaHandleUnlock(struct ArrayArena_S * arena, ArrayArenaHandle_T handle)
+{
+   struct ArrayArenaHandle_S * entry = Helper_HandleEntry( arena, handle );
+   if ( (NULL == entry) || (0 == entry->pins) )   return;
+
+   if ( 0 == --entry->pins )
+   {
+#ifdef ARRAY_ARENA_DEFRAG
+      (void)ArrayArenaSetMovable( arena, entry->ptr, true );
+#endif
+   }
+}
+
+static struct ArrayArenaHandle_S * Helper_HandleEntry( struct ArrayArena_S * arena, ArrayArenaHandle_T handle )
+{
+   if ( (ARRAY_ARENA_NULL_HANDLE == handle) || (handle > ARRAY_ARENA_MAX_HANDLES) )   return NULL;
+
+   struct ArrayArenaHandle_S * entry = &arena->handles.entries[handle];
+   return (entry->ptr != NULL) ? entry : NULL;
+}
+
+static void Helper_SetHandleBlock( struct ArrayArena_S * arena, ArrayArenaHandle_T handle, void * ptr )
+{
+   struct ArrayArenaHandle_S * entry = &arena->handles.entries[handle];
+
+#ifdef ARRAY_ARENA_DEFRAG
+   if ( entry->ptr != NULL )
+   {
+      arena->granule_handles[ ((uint8_t *)entry->ptr - arena->pool) / ARRAY_ARENA_GRANULE_SIZE ] = ARRAY_ARENA_NULL_HANDLE;
+   }
+   if ( ptr != NULL )
+   {
+      arena->granule_handles[ ((uint8_t *)ptr - arena->pool) / ARRAY_ARENA_GRANULE_SIZE ] = handle;
+   }
+#endif
+
+   entry->ptr = ptr;
+}
+
+#endif // ARRAY_ARENA_HANDLES
+
+#ifdef ARRAY_ARENA_DEFRAG
+
+// Default budget for StaticArrayDefragment(), i.e., for the Defragable trait
+#ifndef ARRAY_ARENA_DEFRAG_MAX_BYTES
+#define ARRAY_ARENA_DEFRAG_MAX_BYTES     LARGEST_BLOCK_SIZE
+#endif
+#ifndef ARRAY_ARENA_DEFRAG_MAX_GRANULES
+#define ARRAY_ARENA_DEFRAG_MAX_GRANULES  64
+#endif
+
+STATIC const struct Defragable ArrayArenaDefragable =
+{
+   .IsFragmented = StaticArrayIsFragmented,
+   .Defragment = StaticArrayDefragment
+};
+
+/**
+ * @brief Local helper function to move an allocated block lower into the arena.
+ * @return true if the block was moved; false if there is no lower free block for it
+ */
+static bool Helper_MoveBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk );
+
+STATIC void StaticArraySetRelocateCb(ArrayArenaRelocateCb_T cb, void * ctx)
+{
+   ArrayArenaSetRelocateCb( &ArrayArena, cb, ctx );
+}
+
+STATIC bool StaticArraySetMovable(const void * ptr, bool movable)
+{
+   return ArrayArenaSetMovable( &ArrayArena, ptr, movable );
+}
+
+STATIC bool StaticArrayIsFragmented(void)
+{
+   return ArrayArenaIsFragmented( &ArrayArena );
+}
+
+STATIC bool StaticArrayDefragStep(size_t max_bytes, size_t max_granules)
+{
+   return ArrayArenaDefragStep( &ArrayArena, max_bytes, max_granules );
+}
+
+/**
+ * @brief Set the callback to be told whenever compaction relocates a block.
+ * @note The callback is called after the contents have been copied over, and
+ *       before anything else can be allocated in the old block's place.
+ */
+STATIC void ArrayArenaSetRelocateCb(struct ArrayArena_S * arena, ArrayArenaRelocateCb_T cb, void * ctx)
+{
+   arena->defrag.relocate_cb = cb;
+   arena->defrag.relocate_ctx = ctx;
+}
+
+/**
+ * @brief Mark whether the allocated block at ptr may be relocated by compaction.
+ * @note Blocks are not movable by default. The mark follows the block through
+ *       ArrayArenaRealloc(), and is cleared when the block is freed.
+ * @return true if ptr is an allocated block; false otherwise
+ */
+STATIC bool ArrayArenaSetMovable(struct ArrayArena_S * arena, const void * ptr, bool movable)
+{
+   if ( !Helper_FindBlock( arena, ptr, NULL ) )   return false;
+
+   // Only the flag changes, so the block is not indexed (or charged to its tag) again
+   uint8_t * entry = &arena->granules[ ((const uint8_t *)ptr - arena->pool) / ARRAY_ARENA_GRANULE_SIZE ];
+   if ( movable )   *entry |= GRANULE_ENTRY_MOVABLE;
+   else             *entry &= (uint8_t)~GRANULE_ENTRY_MOVABLE;
+   return true;
+}
+
+/**
+ * @brief Determine whether there is at least a largest block's worth of free
+ *        space that could not be allocated as one.
+ */
+STATIC bool ArrayArenaIsFragmented(const struct ArrayArena_S * arena)
+{
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+   if ( Helper_HasUnmerged( arena ) )   return true;
+#endif
+   size_t largest_free_bytes = arena->lists[BLKS_LARGEST_SIZE].len * LARGEST_BLOCK_SIZE;
+   return (arena->space_available - largest_free_bytes) >= LARGEST_BLOCK_SIZE;
+}
+
+/**
+ * @brief Do a bounded amount of compaction.
+ * @param[in] max_bytes    Most bytes to copy in this call
+ * @param[in] max_granules Most granule table entries to look at in this call,
+ *                         which bounds the time spent on blocks that can't move
+ * @return true if a full walk over the arena found nothing to move, i.e., the
+ *         arena is as compact as it is going to get; false otherwise
+ */
+STATIC bool ArrayArenaDefragStep(struct ArrayArena_S * arena, size_t max_bytes, size_t max_granules)
+{
+   size_t bytes_moved = 0;
+
+   for ( size_t granules_seen = 0; granules_seen < max_granules; granules_seen++ )
+   {
+      if ( 0 == arena->defrag.cursor )
+      {
+         arena->defrag.cursor = ARENA_NUM_OF_GRANULES(arena);
+         if ( !arena->defrag.moved_this_pass )   return true;
+         arena->defrag.moved_this_pass = false;
+      }
+      arena->defrag.cursor--;
+
+      if ( !(arena->granules[arena->defrag.cursor] & GRANULE_ENTRY_MOVABLE) )   continue;
+
+      struct ArrayPoolBlock_S blk;
+      if ( !Helper_FindBlock( arena, &arena->pool[arena->defrag.cursor * ARRAY_ARENA_GRANULE_SIZE], &blk ) )   continue;
+
+      size_t blk_bytes = Helper_BlockBytes( &blk );
+      if ( blk_bytes > max_bytes )   continue; // This budget is never going to be enough for it
+      if ( (bytes_moved + blk_bytes) > max_bytes )
+      {
+         // Come back to it next time
+         arena->defrag.cursor++;
+         break;
+      }
+
+      if ( Helper_MoveBlock( arena, &blk ) )
+      {
+         bytes_moved += blk_bytes;
+         arena->defrag.moved_this_pass = true;
+      }
+   }
+
+   return false;
+}
+
+/**
+ * @brief Do compaction within the default budget (see ARRAY_ARENA_DEFRAG_MAX_*).
+ * @return Same as ArrayArenaDefragStep()
+ */
+STATIC bool StaticArrayDefragment(void)
+{
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+   // Merging moves nothing, and may leave less to move
+   (void)ArrayArenaCoalesce( &ArrayArena );
+#endif
+   return ArrayArenaDefragStep( &ArrayArena, ARRAY_ARENA_DEFRAG_MAX_BYTES, ARRAY_ARENA_DEFRAG_MAX_GRANULES );
+}
+
+static bool Helper_MoveBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk )
+{
+   struct ArrayPoolBlock_S new_blk = *blk;
+   if ( !Helper_TakeBlock( arena, &new_blk ) )   return false;
+
+   size_t old_offset = blk->idx * BlockSize_E_to_Int[blk->sz];
+   size_t new_offset = new_blk.idx * BlockSize_E_to_Int[new_blk.sz];
+   if ( new_offset > old_offset )
+   {
+      Helper_ReleaseBlock( arena, &new_blk );
+      return false;
+   }
+
+   HARDEN_CHECK_CANARY( arena, &arena->pool[old_offset], Helper_BlockBytes( blk ) );
+   memcpy( &arena->pool[new_offset], &arena->pool[old_offset], Helper_BlockBytes( blk ) );
+   HARDEN_SET_CANARY( arena, &arena->pool[new_offset], Helper_BlockBytes( blk ) );
+   HARDEN_POISON( arena, &arena->pool[old_offset], Helper_BlockBytes( blk ) );
+   TAGS_ALLOC_AS( arena, TAG_AT( arena, old_offset ) );
+   Helper_UnindexBlock( arena, blk );
+   Helper_ReleaseBlock( arena, blk );
+   Helper_IndexBlock( arena, &new_blk );
+   TAGS_ALLOC_AS( arena, ARRAY_ARENA_UNTAGGED );
+   TELEM_MOVE( arena, blk->sz, old_offset, new_offset );
+
+#ifdef ARRAY_ARENA_HANDLES
+   // Blocks behind a handle only need their table entry updated
+   ArrayArenaHandle_T handle = arena->granule_handles[old_offset / ARRAY_ARENA_GRANULE_SIZE];
+   if ( handle != ARRAY_ARENA_NULL_HANDLE )
+   {
+      Helper_SetHandleBlock( arena, handle, &arena->pool[new_offset] );
+      return true;
+   }
+#endif
+
+   if ( arena->defrag.relocate_cb != NULL )
+   {
+      arena->defrag.relocate_cb( &arena->pool[old_offset], &arena->pool[new_offset],
+                                 arena->defrag.relocate_ctx );
+   }
+
+   return true;
+}
+
+#endif // ARRAY_ARENA_DEFRAG
+
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+
+#ifndef ARRAY_ARENA_DEFRAG
+STATIC const struct Defragable ArrayArenaDefragable =
+{
+   .IsFragmented = StaticArrayIsFragmented,
+   .Defragment = StaticArrayDefragment
+};
+
+STATIC bool StaticArrayIsFragmented(void)
+{
+   return ArrayArenaIsFragmented( &ArrayArena );
+}
+
+/**
+ * @brief Determine whether any blocks have been freed since the arena was last
+ *        merged, i.e., whether ArrayArenaCoalesce() may have anything to do.
+ */
+STATIC bool ArrayArenaIsFragmented(const struct ArrayArena_S * arena)
+{
+   return Helper_HasUnmerged( arena );
+}
+
+/**
+ * @brief Merge the blocks freed since the last time (see ArrayArenaCoalesce()).
+ * @return true, as there is no compaction to be done after that
+ */
+STATIC bool StaticArrayDefragment(void)
+{
+   (void)ArrayArenaCoalesce( &ArrayArena );
+   return true;
+}
+#endif // ARRAY_ARENA_DEFRAG
+
+STATIC bool StaticArrayCoalesce(void)
+{
+   return ArrayArenaCoalesce( &ArrayArena );
+}
+
+/**
+ * @brief Merge every block freed since the last time /w its buddy, for as long
+ *        as the buddies are free, as an eager free would have.
+ * @note Takes time in proportion to the free bitmaps of the lists that were
+ *       freed into, i.e. at most one word per 32 blocks of each size, and
+ *       nothing if nothing has been freed since the last time.
+ * @return true if any blocks were merged
+ */
+STATIC bool ArrayArenaCoalesce(struct ArrayArena_S * arena)
+{
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   ARRAY_ARENA_LOCK( arena );
+   bool merged_any = Helper_MergePending( arena );
+   ARRAY_ARENA_UNLOCK( arena );
+   return merged_any;
+#else
+   return Helper_MergePending( arena );
+#endif
+}
+
+static bool Helper_HasUnmerged( const struct ArrayArena_S * arena )
+{
+   for ( uint8_t sz = 0; sz < (uint8_t)NUM_OF_BLOCK_SIZES; sz++ )
+   {
+      if ( arena->lists[sz].unmerged > 0 )   return true;
+   }
+   return false;
+}
+
+#endif // ARRAY_ARENA_LAZY_COALESCE
+
+#ifdef ARRAY_ARENA_THREAD_SAFE
+
+/**
+ * @brief Return all of the blocks in the caller's cache to the shared free lists,
+ *        and (when there is a cache per thread) hand the cache itself back.
+ * @note Blocks from the cache that are still allocated are freed into it as
+ *       usual. They are taken back by the next thread to get the cache, or by
+ *       the next flush from any thread.
+ */
+STATIC void StaticArrayCacheFlush(void)
+{
+   struct ArrayArenaCache_S * cache = Helper_MyCache();
+   if ( NULL == cache )   return;
+
+   Helper_CacheFlush( &ArrayArena, cache );
+
+#ifndef ARRAY_ARENA_CACHE_ID
+   ArrayArenaMyCache = NULL;
+   ATOMIC_CLEAR( &cache->claimed );
+
+   // While we're at it, take back what has been freed into the caches that
+   // no thread has at the moment.
+   for ( uint8_t i = 0; i < ARRAY_ARENA_NUM_OF_CACHES; i++ )
+   {
+      cache = &ArrayArenaCaches[i];
+      if ( ATOMIC_TEST_AND_SET( &cache->claimed ) )   continue;
+
+      if ( cache->remote_ready )   Helper_CacheFlush( &ArrayArena, cache );
+      ATOMIC_CLEAR( &cache->claimed );
+   }
+#endif
+}
+
+static void Helper_CacheFlush( struct ArrayArena_S * arena, struct ArrayArenaCache_S * cache )
+{
+   Helper_CacheReclaim( arena, cache );
+
+   ARRAY_ARENA_LOCK( arena );
+   for ( uint8_t sz = 0; sz < (uint8_t)NUM_OF_BLOCK_SIZES; sz++ )
+   {
+      Helper_CacheDrain( arena, cache, (enum BlockSize)sz, cache->len[sz] );
+   }
+   ARRAY_ARENA_UNLOCK( arena );
+}
+
+static void Helper_CacheFlushMine( struct ArrayArena_S * arena )
+{
+   if ( arena != &ArrayArena )   return;
+
+   struct ArrayArenaCache_S * cache = Helper_MyCache();
+   if ( cache != NULL )   Helper_CacheFlush( arena, cache );
+}
+
+static struct ArrayArenaCache_S * Helper_MyCache( void )
+{
+#ifdef ARRAY_ARENA_CACHE_ID
+   struct ArrayArenaCache_S * cache = &ArrayArenaCaches[ARRAY_ARENA_CACHE_ID()];
+#else
+   struct ArrayArenaCache_S * cache = ArrayArenaMyCache;
+   if ( cache != NULL )   return cache;
+
+   for ( uint8_t i = 0; (i < ARRAY_ARENA_NUM_OF_CACHES) && (NULL == cache); i++ )
+   {
+      if ( !ATOMIC_TEST_AND_SET( &ArrayArenaCaches[i].claimed ) )   cache = &ArrayArenaCaches[i];
+   }
+   if ( NULL == cache )   return NULL;
+   ArrayArenaMyCache = cache;
+#endif
+
+   // Nothing can be pushed onto the queue before the owner has allocated from
+   // the cache, so the owner is free to set it up here.
+   if ( !cache->remote_ready )
+   {
+      cache->remote_stub.next = NULL;
+      cache->remote_head = &cache->remote_stub;
+      cache->remote_tail = &cache->remote_stub;
+      cache->remote_ready = true;
+   }
+
+   return cache;
+}
+
+static bool Helper_CacheAlloc( struct ArrayArena_S * arena, size_t req_bytes, void ** ptr )
+{
+   if ( arena != &ArrayArena )   return false;
+
+   struct ArrayPoolBlock_S blk;
+   if ( !Helper_RequestToBlock( arena, req_bytes, &blk ) )
+   {
+      STATS_FAIL( arena, req_bytes, 1 );
+      TELEM_FAIL( arena, req_bytes, 1 );
+      *ptr = NULL;
+      return true;
+   }
+
+   return Helper_CacheAllocAs( arena, &blk, req_bytes, ptr );
+}
+
+static bool Helper_CacheAllocAs( struct ArrayArena_S * arena, struct ArrayPoolBlock_S * blk, size_t req_bytes, void ** ptr )
+{
+   (void)req_bytes; // Only what stats and telemetry are told
+   if ( (arena != &ArrayArena) || blk->trimmed || (blk->run_len > 0) )   return false;
+
+   struct ArrayArenaCache_S * cache = Helper_MyCache();
+   if ( NULL == cache )   return false;
+
+   Helper_CacheReclaim( arena, cache );
+
+   if ( 0 == cache->len[blk->sz] )
+   {
+      // Refill /w half a cache's worth, so that a free right after doesn't
+      // immediately have to drain what we just took.
+      size_t blk_idx;
+      ARRAY_ARENA_LOCK( arena );
+      if ( !Helper_AllocBlock( arena, blk->sz, &blk_idx ) )
+      {
+         // Don't fail while this cache sits on free blocks of other sizes
+         // that could be merged into one of this size.
+         for ( uint8_t sz = 0; sz < (uint8_t)NUM_OF_BLOCK_SIZES; sz++ )
+         {
+            Helper_CacheDrain( arena, cache, (enum BlockSize)sz, cache->len[sz] );
+         }
+         if ( !Helper_AllocBlock( arena, blk->sz, &blk_idx ) )
+         {
+            ARRAY_ARENA_UNLOCK( arena );
+            STATS_FAIL( arena, req_bytes, 1 );
+            TELEM_FAIL( arena, req_bytes, 1 );
+            *ptr = NULL;
+            return true;
+         }
+      }
+      do
+      {
+         cache->blks[blk->sz][cache->len[blk->sz]++] = blk_idx;
+         arena->space_available -= BlockSize_E_to_Int[blk->sz];
+      } while ( (cache->len[blk->sz] < (ARRAY_ARENA_CACHE_SIZE / 2)) &&
+                Helper_AllocBlock( arena, blk->sz, &blk_idx ) );
+      ARRAY_ARENA_UNLOCK( arena );
+   }
+
+   blk->idx = cache->blks[blk->sz][--cache->len[blk->sz]];
+   Helper_IndexBlock( arena, blk );
+
+   size_t offset = blk->idx * arena->lists[blk->sz].block_size;
+   ArrayArenaBlockOwner[offset / ARRAY_ARENA_GRANULE_SIZE] = (uint8_t)(1 + (cache - ArrayArenaCaches));
+   STATS_ALLOC( arena, blk, req_bytes, 1 );
+   *ptr = &arena->pool[offset];
+   TELEM_ALLOC( arena, blk->sz, *ptr, req_bytes );
+   return true;
+}
+
+static bool Helper_CacheFree( struct ArrayArena_S * arena, const void * ptr )
+{
+   if ( arena != &ArrayArena )   return false;
+
+   // The granule table entry of a block is only ever touched by whoever holds
+   // the block, so there is no need for the lock to look it up.
+   struct ArrayPoolBlock_S blk;
+   if ( !Helper_FindBlock( arena, ptr, &blk ) )   return true;
+   if ( blk.trimmed || (blk.run_len > 0) )   return false;
+
+   size_t offset = blk.idx * arena->lists[blk.sz].block_size;
+   uint8_t owner = ArrayArenaBlockOwner[offset / ARRAY_ARENA_GRANULE_SIZE];
+   struct ArrayArenaCache_S * cache = Helper_MyCache();
+
+   if ( (owner != 0) && (&ArrayArenaCaches[owner - 1] != cache) )
+   {
+      // Some other thread's block. Hand it back to that thread's cache.
+      Helper_UnindexBlock( arena, &blk );
+      struct ArrayArenaRemoteFree_S * node = (struct ArrayArenaRemoteFree_S *)(void *)&arena->pool[offset];
+      node->sz = blk.sz;
+      Helper_RemotePush( &ArrayArenaCaches[owner - 1], node );
+      STATS_FREE( arena, &blk );
+      TELEM_FREE( arena, &blk );
+      return true;
+   }
+
+   if ( NULL == cache )   return false;
+
+   if ( ARRAY_ARENA_CACHE_SIZE == cache->len[blk.sz] )
+   {
+      ARRAY_ARENA_LOCK( arena );
+      Helper_CacheDrain( arena, cache, blk.sz, ARRAY_ARENA_CACHE_SIZE / 2 );
+      ARRAY_ARENA_UNLOCK( arena );
+   }
+
+   Helper_UnindexBlock( arena, &blk );
+   cache->blks[blk.sz][cache->len[blk.sz]++] = blk.idx;
+   STATS_FREE( arena, &blk );
+   TELEM_FREE( arena, &blk );
+   return true;
+}
+
+static void Helper_CacheDrain( struct ArrayArena_S * arena, struct ArrayArenaCache_S * cache,
+                               enum BlockSize blk_sz, uint8_t num_of_blks )
+{
+   assert( num_of_blks <= cache->len[blk_sz] );
+
+   for ( uint8_t i = 0; i < num_of_blks; i++ )
+   {
+      Helper_CoalesceBlock( arena, blk_sz, cache->blks[blk_sz][--cache->len[blk_sz]] );
+      arena->space_available += BlockSize_E_to_Int[blk_sz];
+   }
+}
+
+static void Helper_CacheReclaim( struct ArrayArena_S * arena, struct ArrayArenaCache_S * cache )
+{
+   bool locked = false;
+   struct ArrayArenaRemoteFree_S * node;
+
+   while ( (node = Helper_RemotePop( cache )) != NULL )
+   {
+      enum BlockSize blk_sz = node->sz;
+      if ( ARRAY_ARENA_CACHE_SIZE == cache->len[blk_sz] )
+      {
+         // Only take the lock once, however much there is to drain
+         if ( !locked )
+         {
+            ARRAY_ARENA_LOCK( arena );
+            locked = true;
+         }
+         Helper_CacheDrain( arena, cache, blk_sz, ARRAY_ARENA_CACHE_SIZE / 2 );
+      }
+
+      size_t offset = (size_t)((uint8_t *)node - arena->pool);
+      cache->blks[blk_sz][cache->len[blk_sz]++] = offset / arena->lists[blk_sz].block_size;
+   }
+
+   if ( locked )   ARRAY_ARENA_UNLOCK( arena );
+}
+
+static void Helper_RemotePush( struct ArrayArenaCache_S * cache, struct ArrayArenaRemoteFree_S * node )
+{
+   ATOMIC_STORE_PTR( &node->next, NULL );
+   struct ArrayArenaRemoteFree_S * prev = ATOMIC_XCHG_PTR( &cache->remote_tail, node );
+   ATOMIC_STORE_PTR( &prev->next, node );
+}
+
+static struct ArrayArenaRemoteFree_S * Helper_RemotePop( struct ArrayArenaCache_S * cache )
+{
+   struct ArrayArenaRemoteFree_S * head = cache->remote_head;
+   struct ArrayArenaRemoteFree_S * next = ATOMIC_LOAD_PTR( &head->next );
+
+   if ( &cache->remote_stub == head )
+   {
+      if ( NULL == next )   return NULL;
+      cache->remote_head = next;
+      head = next;
+      next = ATOMIC_LOAD_PTR( &head->next );
+   }
+
+   if ( next != NULL )
+   {
+      cache->remote_head = next;
+      return head;
+   }
+
+   // head is either the last node pushed, or a push after it is still under
+   // way (and will be seen next time).
+   if ( head != ATOMIC_LOAD_PTR( &cache->remote_tail ) )   return NULL;
+
+   // Put the stub back behind head, so that head can be popped /wout leaving
+   // the queue empty.
+   Helper_RemotePush( cache, &cache->remote_stub );
+   next = ATOMIC_LOAD_PTR( &head->next );
+   if ( next != NULL )
+   {
+      cache->remote_head = next;
+      return head;
+   }
+
+   return NULL;
+}
+
+#endif // ARRAY_ARENA_THREAD_SAFE
+
+/* Static Array Allocator Helper Implementations */
+
+static void * Helper_ArenaAlloc( struct ArrayArena_S * arena, size_t req_bytes )
+{
+   void * ptr = Helper_ArenaAllocUncounted( arena, req_bytes );
+   if ( NULL == ptr )
+   {
+      STATS_FAIL( arena, req_bytes, 1 );
+      TELEM_FAIL( arena, req_bytes, 1 );
+   }
+   return ptr;
+}
+
+static void * Helper_ArenaAllocUncounted( struct ArrayArena_S * arena, size_t req_bytes )
+{
+   assert( arena->arena_initialized );
+   SHARED_RECLAIM( arena );
+
+   if ( req_bytes > arena->space_available )   return NULL;
+
+   struct ArrayPoolBlock_S blk;
+   if ( !Helper_RequestToBlock( arena, req_bytes, &blk ) )   return NULL;
+
+   return Helper_ArenaAllocAs( arena, &blk, req_bytes );
+}
+
+static void * Helper_ArenaAllocClass( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t req_bytes )
+{
+   assert( arena->arena_initialized );
+   SHARED_RECLAIM( arena );
+
+   struct ArrayPoolBlock_S blk = { .sz = blk_sz, .idx = 0, .trimmed = false, .movable = false, .run_len = 0 };
+   void * ptr = Helper_ArenaAllocAs( arena, &blk, req_bytes );
+   if ( NULL == ptr )
+   {
+      STATS_FAIL( arena, req_bytes, 1 );
+      TELEM_FAIL( arena, req_bytes, 1 );
+   }
+   return ptr;
+}
+
+static void * Helper_ArenaAllocAs( struct ArrayArena_S * arena, struct ArrayPoolBlock_S * blk, size_t req_bytes )
+{
+   (void)req_bytes; // Only what stats and telemetry are told
+   if ( !Helper_TakeBlock( arena, blk ) )   return NULL;
+
+   Helper_IndexBlock( arena, blk );
+   arena->space_available -= Helper_BlockBytes( blk );
+   STATS_ALLOC( arena, blk, req_bytes, 1 );
+   void * ptr = &arena->pool[ blk->idx * arena->lists[blk->sz].block_size ];
+   HARDEN_CHECK_POISON( arena, ptr, Helper_BlockBytes( blk ) );
+   HARDEN_SET_CANARY( arena, ptr, Helper_BlockBytes( blk ) );
+   TELEM_ALLOC( arena, blk->sz, ptr, req_bytes );
+   return ptr;
+}
+
+static enum ArrayArenaStatus Helper_ArenaRealloc( struct ArrayArena_S * arena, void ** ptr_io, size_t req_bytes )
+{
+   enum ArrayArenaStatus status = Helper_ArenaReallocUncounted( arena, ptr_io, req_bytes );
+   if ( Helper_IsAllocFailure( status ) )
+   {
+      STATS_FAIL( arena, req_bytes, 1 );
+      TELEM_FAIL( arena, req_bytes, 1 );
+   }
+   return status;
+}
+
+static bool Helper_IsAllocFailure( enum ArrayArenaStatus status )
+{
+   return (ARRAY_ARENA_TOO_LARGE == status) || (ARRAY_ARENA_OUT_OF_SPACE == status) ||
+          (ARRAY_ARENA_FRAGMENTED == status);
+}
+
+static enum ArrayArenaStatus Helper_ArenaReallocUncounted( struct ArrayArena_S * arena, void ** ptr_io, size_t req_bytes )
+{
+   void * ptr = *ptr_io;
+   struct ArrayPoolBlock_S old_blk;
+   struct ArrayPoolBlock_S best_fit;
+   bool old_blk_found = Helper_FindBlock( arena, ptr, &old_blk );
+   bool best_fit_found = Helper_RequestToBlock( arena, req_bytes, &best_fit );
+
+   if ( !old_blk_found )
+   {
+      HARDEN_BAD_FREE( arena, ptr );
+      return Helper_BadPtrStatus( arena, ptr );
+   }
+   else if ( 0 == req_bytes )
+   {
+      *ptr_io = NULL;
+      return Helper_ArenaFree( arena, ptr );
+   }
+
+   HARDEN_CHECK_CANARY( arena, ptr, Helper_BlockBytes( &old_blk ) );
+   if ( best_fit_found &&
+             (best_fit.sz == old_blk.sz) && (best_fit.trimmed == old_blk.trimmed) &&
+             (best_fit.run_len == old_blk.run_len) )
+   {
+      // Not much point in reallocating if the size is the best fit.
+      return ARRAY_ARENA_OK;
+   }
+   else if ( best_fit_found && Helper_ResizeBlock( arena, &old_blk, &best_fit ) )
+   {
+#ifdef ARRAY_ARENA_HARDENED
+      size_t old_blk_size = Helper_BlockBytes( &old_blk );
+      size_t new_blk_size = Helper_BlockBytes( &best_fit );
+      if ( new_blk_size < old_blk_size )
+      {
+         HARDEN_POISON( arena, (uint8_t *)ptr + new_blk_size, old_blk_size - new_blk_size );
+      }
+      HARDEN_SET_CANARY( arena, ptr, new_blk_size );
+#endif
+      STATS_FREE( arena, &old_blk );
+      STATS_ALLOC( arena, &best_fit, req_bytes, 1 );
+      TELEM_FREE( arena, &old_blk );
+      TELEM_ALLOC( arena, best_fit.sz, ptr, req_bytes );
+      return ARRAY_ARENA_OK;
+   }
+
+   void * tmp = Helper_ArenaAllocUncounted( arena, req_bytes );
+   if ( tmp != NULL )
+   {
+      size_t old_blk_size = Helper_BlockBytes( &old_blk );
+      size_t num_of_bytes = (req_bytes > old_blk_size) ? old_blk_size : req_bytes;
+      memcpy( tmp, ptr, num_of_bytes );
+      HARDEN_POISON( arena, ptr, old_blk_size );
+      if ( old_blk.movable )
+      {
+         arena->granules[ ((uint8_t *)tmp - arena->pool) / ARRAY_ARENA_GRANULE_SIZE ] |= GRANULE_ENTRY_MOVABLE;
+      }
+
+      // We already know which block ptr is, so skip the lookup in Helper_ArenaFree()
+      Helper_UnindexBlock( arena, &old_blk );
+      arena->space_available += old_blk_size;
+      Helper_ReleaseBlock( arena, &old_blk );
+      STATS_FREE( arena, &old_blk );
+      TELEM_FREE( arena, &old_blk );
+      *ptr_io = tmp;
+      return ARRAY_ARENA_OK;
+   }
+
+   // The block is left as it was
+   return Helper_AllocFailure( arena, req_bytes, Helper_BlockBytes( &old_blk ) );
+}
+
+static enum ArrayArenaStatus Helper_ArenaFree( struct ArrayArena_S * arena, const void * ptr )
+{
+   struct ArrayPoolBlock_S blk;
+   bool blk_found = Helper_FindBlock( arena, ptr, &blk );
+
+   if ( !blk_found )
+   {
+      if ( NULL == ptr )   return ARRAY_ARENA_OK;
+      HARDEN_BAD_FREE( arena, ptr );
+      return Helper_BadPtrStatus( arena, ptr );
+   }
+
+#ifdef ARRAY_ARENA_HARDENED
+   uint8_t * blk_ptr = &arena->pool[ blk.idx * arena->lists[blk.sz].block_size ];
+   HARDEN_CHECK_CANARY( arena, blk_ptr, Helper_BlockBytes( &blk ) );
+   HARDEN_POISON( arena, blk_ptr, Helper_BlockBytes( &blk ) );
+#endif
+   Helper_UnindexBlock( arena, &blk );
+   arena->space_available += Helper_BlockBytes( &blk );
+   Helper_ReleaseBlock( arena, &blk );
+   STATS_FREE( arena, &blk );
+   TELEM_FREE( arena, &blk );
+   return ARRAY_ARENA_OK;
+}
+
+static size_t Helper_ArenaAllocBatch( struct ArrayArena_S * arena, size_t req_bytes, size_t n, void * out[] )
+{
+   assert( arena->arena_initialized );
+   SHARED_RECLAIM( arena );
+
+   struct ArrayPoolBlock_S blk;
+   size_t num_of_blks = 0;
+
+   if ( (n > 0) && (req_bytes <= arena->space_available) &&
+        Helper_RequestToBlock( arena, req_bytes, &blk ) )
+   {
+      if ( blk.trimmed || (blk.run_len > 0) )
+      {
+         // These are carved out of the free lists one by one regardless
+         while ( (num_of_blks < n) && Helper_TakeBlock( arena, &blk ) )
+         {
+            Helper_IndexBlock( arena, &blk );
+            out[num_of_blks++] = &arena->pool[ blk.idx * arena->lists[blk.sz].block_size ];
+         }
+      }
+      else
+      {
+         do
+         {
+            num_of_blks += Helper_TakeFreeBlocks( arena, blk.sz, n - num_of_blks, &out[num_of_blks] );
+
+            // Make up the rest from the nearest larger size that has any
+            int larger_sz = (int)blk.sz - 1;
+            while ( (num_of_blks < n) && (larger_sz >= (int)BLKS_LARGEST_SIZE) )
+            {
+               size_t larger_blk_idx;
+               if ( !Helper_TakeFreeBlock( arena, (enum BlockSize)larger_sz, &larger_blk_idx ) )
+               {
+                  larger_sz--;
+                  continue;
+               }
+               num_of_blks += Helper_CarveBlock( arena, (enum BlockSize)larger_sz, larger_blk_idx, blk.sz,
+                                                 n - num_of_blks, &out[num_of_blks] );
+            }
+         } while ( (num_of_blks < n) && LAZY_MERGE( arena ) );
+      }
+
+      arena->space_available -= num_of_blks * Helper_BlockBytes( &blk );
+      if ( num_of_blks > 0 )   STATS_ALLOC( arena, &blk, req_bytes, num_of_blks );
+#ifdef ARRAY_ARENA_HARDENED
+      for ( size_t i = 0; i < num_of_blks; i++ )
+      {
+         HARDEN_CHECK_POISON( arena, out[i], Helper_BlockBytes( &blk ) );
+         HARDEN_SET_CANARY( arena, out[i], Helper_BlockBytes( &blk ) );
+      }
+#endif
+#ifdef ARRAY_ARENA_TELEMETRY
+      for ( size_t i = 0; i < num_of_blks; i++ )   TELEM_ALLOC( arena, blk.sz, out[i], req_bytes );
+#endif
+   }
+
+   if ( num_of_blks < n )
+   {
+      STATS_FAIL( arena, req_bytes, n - num_of_blks );
+      TELEM_FAIL( arena, req_bytes, n - num_of_blks );
+   }
+   for ( size_t i = num_of_blks; i < n; i++ )   out[i] = NULL;
+   return num_of_blks;
+}
+
+static void Helper_ArenaFreeBatch( struct ArrayArena_S * arena, void * const ptrs[], size_t n )
+{
+   size_t bytes_freed = 0;
+
+   for ( size_t i = 0; i < n; i++ )
+   {
+      struct ArrayPoolBlock_S blk;
+      if ( !Helper_FindBlock( arena, ptrs[i], &blk ) )
+      {
+         HARDEN_BAD_FREE( arena, ptrs[i] );
+         continue;
+      }
+
+#ifdef ARRAY_ARENA_HARDENED
+      uint8_t * blk_ptr = &arena->pool[ blk.idx * arena->lists[blk.sz].block_size ];
+      HARDEN_CHECK_CANARY( arena, blk_ptr, Helper_BlockBytes( &blk ) );
+      HARDEN_POISON( arena, blk_ptr, Helper_BlockBytes( &blk ) );
+#endif
+      Helper_UnindexBlock( arena, &blk );
+      bytes_freed += Helper_BlockBytes( &blk );
+      Helper_ReleaseBlock( arena, &blk );
+      STATS_FREE( arena, &blk );
+      TELEM_FREE( arena, &blk );
+   }
+
+   arena->space_available += bytes_freed;
+}
+
+
+static bool Helper_RequestToBlock( struct ArrayArena_S * arena, size_t req_bytes, struct ArrayPoolBlock_S * blk )
+{
+   assert( blk != NULL );
+
+   blk->idx = 0;
+   blk->trimmed = false;
+   blk->movable = false;
+   blk->run_len = 0;
+
+#ifdef ARRAY_ARENA_HARDENED
+   // The canary takes up the end of the block, past what was asked for
+   if ( req_bytes > (SIZE_MAX - CANARY_BYTES) )   return false;
+   req_bytes += CANARY_BYTES;
+#endif
+
+#ifdef ARRAY_ARENA_CACHE_LINE_ISOLATION
+   // In a pool aligned to a line, a block of at least a line shares it /w no other
+   if ( req_bytes < ARRAY_ARENA_CACHE_LINE_SIZE )   req_bytes = ARRAY_ARENA_CACHE_LINE_SIZE;
+#endif
+
+#ifdef ARRAY_ARENA_REALTIME
+   // Finding a free run is a search, which has no bound
+   (void)arena;
+   if ( req_bytes > LARGEST_BLOCK_SIZE )   return false;
+#else
+   if ( req_bytes > LARGEST_BLOCK_SIZE )
+   {
+      size_t run_len = (req_bytes / LARGEST_BLOCK_SIZE) + ((req_bytes % LARGEST_BLOCK_SIZE) != 0);
+      if ( run_len > arena->lists[BLKS_LARGEST_SIZE].map_words * FREE_MAP_WORD_BITS )   return false;
+
+      blk->sz = BLKS_LARGEST_SIZE;
+      blk->run_len = run_len;
+      return true;
+   }
+#endif
+
+   // The smallest block size that holds req_bytes, in O(1) (see sara.h)
+   uint8_t sz = ArrayArenaBytesClass( req_bytes );
+
+   blk->sz = (enum BlockSize)sz;
+
+#ifdef ARRAY_ARENA_INTERMEDIATE_SIZES
+   // Would a half-size head plus a quarter-size tail do? Only if there is a
+   // block size for the quarter.
+   if ( ((sz + 2) < (uint8_t)NUM_OF_BLOCK_SIZES) &&
+        (req_bytes <= (BlockSize_E_to_Int[sz + 1] + BlockSize_E_to_Int[sz + 2])) )
+   {
+      blk->sz = (enum BlockSize)(sz + 1);
+      blk->trimmed = true;
+   }
+#endif
+
+   return true;
+}
+
+static enum ArrayArenaStatus Helper_AllocFailure( struct ArrayArena_S * arena, size_t req_bytes, size_t reusable_bytes )
+{
+   struct ArrayPoolBlock_S blk;
+   if ( !Helper_RequestToBlock( arena, req_bytes, &blk ) )   return ARRAY_ARENA_TOO_LARGE;
+
+   size_t blk_bytes = Helper_BlockBytes( &blk );
+   if ( blk_bytes > arena->pool_size )   return ARRAY_ARENA_TOO_LARGE;
+   if ( (blk_bytes > arena->space_available) &&
+        ((blk_bytes - arena->space_available) > reusable_bytes) )
+   {
+      return ARRAY_ARENA_OUT_OF_SPACE;
+   }
+   return ARRAY_ARENA_FRAGMENTED;
+}
+
+static enum ArrayArenaStatus Helper_BadPtrStatus( struct ArrayArena_S * arena, const void * ptr )
+{
+   uintptr_t addr = (uintptr_t)ptr;
+   uintptr_t base = (uintptr_t)arena->pool;
+   if ( (NULL == ptr) || (addr < base) || (addr >= (base + arena->pool_size)) )   return ARRAY_ARENA_INVALID_PTR;
+
+   // Free blocks never overlap, so free memory is inside exactly one free
+   // block, of whichever size that is
+   size_t offset = (size_t)(addr - base);
+   for ( uint8_t i = 0; i < (uint8_t)NUM_OF_BLOCK_SIZES; i++ )
+   {
+      size_t blk_idx = offset / arena->lists[i].block_size;
+      if ( ((blk_idx / FREE_MAP_WORD_BITS) < arena->lists[i].map_words) &&
+           Helper_IsBlockFree( arena, (enum BlockSize)i, blk_idx ) )
+      {
+         return ARRAY_ARENA_DOUBLE_FREE;
+      }
+   }
+
+   return ARRAY_ARENA_INVALID_PTR;
+}
+
+static size_t Helper_GrantedBytes( struct ArrayArena_S * arena, const void * ptr )
+{
+   struct ArrayPoolBlock_S blk;
+   if ( !Helper_FindBlock( arena, ptr, &blk ) )   return 0;
+
+   return Helper_BlockBytes( &blk ) - CANARY_BYTES;
+}
+
+static size_t Helper_BlockBytes( const struct ArrayPoolBlock_S * blk )
+{
+   size_t bytes = BlockSize_E_to_Int[blk->sz];
+   if ( blk->run_len > 0 )   return blk->run_len * bytes;
+   return blk->trimmed ? (bytes + (bytes / 2)) : bytes;
+}
+
+static bool Helper_FindBlock( struct ArrayArena_S * arena, const void * ptr, struct ArrayPoolBlock_S * blk )
+{
+   assert( arena->arena_initialized );
+
+   if ( NULL == ptr )   return false;
+
+   // 🗒: Should I allow for an address _inside_ a block?
+   //     That would just be a matter of walking back to the block's granule.
+   uintptr_t addr = (uintptr_t)ptr;
+   uintptr_t base = (uintptr_t)arena->pool;
+   if ( (addr < base) || (addr >= (base + arena->pool_size)) )   return false;
+
+   size_t offset = (size_t)(addr - base);
+   if ( (offset % ARRAY_ARENA_GRANULE_SIZE) != 0 )   return false;
+
+   size_t granule = offset / ARRAY_ARENA_GRANULE_SIZE;
+   if ( granule >= ARENA_NUM_OF_GRANULES(arena) )   return false;
+
+   uint8_t entry = arena->granules[granule];
+   if ( BLOCK_SZ_NONE == entry )   return false;
+
+   enum BlockSize sz = GRANULE_ENTRY_TO_BLOCK_SZ(entry);
+   assert( sz < NUM_OF_BLOCK_SIZES );
+   if ( blk != NULL )
+   {
+      blk->sz = sz;
+      blk->idx = offset / arena->lists[sz].block_size;
+      blk->trimmed = (entry & GRANULE_ENTRY_TRIMMED) != 0;
+      blk->movable = (entry & GRANULE_ENTRY_MOVABLE) != 0;
+      blk->run_len = (BLKS_LARGEST_SIZE == sz) ? arena->run_lens[blk->idx] : 0;
+   }
+
+   return true;
+}
+
+static bool Helper_IsBlockFree( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx )
+{
+   const struct ArrayPoolBlockList_S * list = &arena->lists[blk_sz];
+   assert( (blk_idx / FREE_MAP_WORD_BITS) < list->map_words );
+
+   return ( list->free_map[blk_idx / FREE_MAP_WORD_BITS] >> (blk_idx % FREE_MAP_WORD_BITS) ) & 1u;
+}
+
+static void Helper_MarkBlockFree( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx )
+{
+   struct ArrayPoolBlockList_S * list = &arena->lists[blk_sz];
+   assert( (blk_idx / FREE_MAP_WORD_BITS) < list->map_words );
+
+   uint32_t mask = (uint32_t)1u << (blk_idx % FREE_MAP_WORD_BITS);
+   if ( !(list->free_map[blk_idx / FREE_MAP_WORD_BITS] & mask) )  list->len++;
+   list->free_map[blk_idx / FREE_MAP_WORD_BITS] |= mask;
+   FREE_SUMMARY_SYNC( list, blk_idx / FREE_MAP_WORD_BITS );
+   VIZ_MARK_DIRTY( arena, blk_idx * list->block_size, list->block_size );
+}
+
+static void Helper_MarkBlockAllocated( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx )
+{
+   struct ArrayPoolBlockList_S * list = &arena->lists[blk_sz];
+   assert( (blk_idx / FREE_MAP_WORD_BITS) < list->map_words );
+
+   uint32_t mask = (uint32_t)1u << (blk_idx % FREE_MAP_WORD_BITS);
+   if ( list->free_map[blk_idx / FREE_MAP_WORD_BITS] & mask )  list->len--;
+   list->free_map[blk_idx / FREE_MAP_WORD_BITS] &= ~mask;
+   FREE_SUMMARY_SYNC( list, blk_idx / FREE_MAP_WORD_BITS );
+   VIZ_MARK_DIRTY( arena, blk_idx * list->block_size, list->block_size );
+}
+
+#ifdef ARRAY_ARENA_REALTIME
+static void Helper_SyncFreeSummary( struct ArrayPoolBlockList_S * list, size_t w )
+{
+   size_t s = w / FREE_MAP_WORD_BITS;
+   uint32_t word_mask = (uint32_t)1u << (w % FREE_MAP_WORD_BITS);
+   uint32_t summary_mask = (uint32_t)1u << s;
 
-#elif defined(VEC_USE_BUILT_IN_STATIC_ALLOC)
-   if ( !StaticArrayPoolIsInitialized() ) StaticArrayPoolInit();
-   struct Vector_S * NewVec = StaticVectorArenaAlloc();
+   if ( list->free_map[w] != 0 )
+   {
+      list->free_summary[s] |= word_mask;
+      list->free_top |= summary_mask;
+   }
+   else
+   {
+      list->free_summary[s] &= ~word_mask;
+      if ( 0 == list->free_summary[s] )   list->free_top &= ~summary_mask;
+   }
+}
 #endif
 
-// Macro constants for the capacity of each free list.
-// The lists are statically sized so that theoretically, the full static array
-// arena can be owned by any single list. This is done because we have to account
-// for the run-time dynamics of these lists shifting ownership of the arena in
-// all sorts of strange and mysterious ways in practice. We may start off with
-// the 1024 list owning the majority of the arena, and over time, each 1024
-// blocks may be split off, theoretically until all the blocks are 32-byte sized.
-// Of course, we cannot dynamically size the memory used by these lists because,
-// these lists are the handlers of dynamic memory, so their overhead must be set
-// up front!
-#define BLOCKS_1024_LIST_CAPACITY (( VEC_ARRAY_ARENA_SIZE / 1024 ) + 1)
-#define BLOCKS_512_LIST_CAPACITY  (( VEC_ARRAY_ARENA_SIZE / 512  ) + 1)
-#define BLOCKS_256_LIST_CAPACITY  (( VEC_ARRAY_ARENA_SIZE / 256  ) + 1)
-#define BLOCKS_128_LIST_CAPACITY  (( VEC_ARRAY_ARENA_SIZE / 128  ) + 1)
-#define BLOCKS_64_LIST_CAPACITY   (( VEC_ARRAY_ARENA_SIZE / 64   ) + 1)
-#define BLOCKS_32_LIST_CAPACITY   (( VEC_ARRAY_ARENA_SIZE / 32   ) + 1)
+static bool Helper_TakeFreeBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t * blk_idx )
+{
+   const struct ArrayPoolBlockList_S * list = &arena->lists[blk_sz];
+   assert( blk_idx != NULL );
 
-// Macro constants for the iniital length of each free list.
-// Ideally, the distribution of the initial lengths will match the distribution
-// of requests during runtime. This minimizes the amount of times splitting and
-// coalescing has to happen.
-// Since that's not really going to be possible up front, one can either go
-// through the discretize_arena.py Python script, write their own initial lens,
-// or use the default below which starts at the largest size and goes down.
-#ifdef USE_EXTERNAL_INIT_LENS
-#include "array_arena_cfg.h"
-#else
-#define BLOCKS_1024_LIST_INIT_LEN (((VEC_ARRAY_ARENA_SIZE)        / 1024) + 1)
-#define BLOCKS_512_LIST_INIT_LEN  (((VEC_ARRAY_ARENA_SIZE % 1024) / 512)  + 1)
-#define BLOCKS_256_LIST_INIT_LEN  (((VEC_ARRAY_ARENA_SIZE % 512)  / 256)  + 1)
-#define BLOCKS_128_LIST_INIT_LEN  (((VEC_ARRAY_ARENA_SIZE % 256)  / 128)  + 1)
-#define BLOCKS_64_LIST_INIT_LEN   (((VEC_ARRAY_ARENA_SIZE % 128)  / 64)   + 1)
-#define BLOCKS_32_LIST_INIT_LEN   (((VEC_ARRAY_ARENA_SIZE % 64)   / 32)   + 1)
-#endif // USE_EXTERNAL_INIT_LENS
+   if ( 0 == list->len )   return false;
+
+#ifdef ARRAY_ARENA_REALTIME
+   size_t s = Helper_Ctz32( list->free_top );
+   size_t w = (s * FREE_MAP_WORD_BITS) + Helper_Ctz32( list->free_summary[s] );
+   *blk_idx = (w * FREE_MAP_WORD_BITS) + Helper_Ctz32( list->free_map[w] );
+   Helper_MarkBlockAllocated( arena, blk_sz, *blk_idx );
+   return true;
+#else
+   for ( size_t w = 0; w < list->map_words; w++ )
+   {
+      if ( 0 == list->free_map[w] )   continue;
+
+      *blk_idx = (w * FREE_MAP_WORD_BITS) + Helper_Ctz32( list->free_map[w] );
+      Helper_MarkBlockAllocated( arena, blk_sz, *blk_idx );
+      return true;
+   }
+
+   assert( false ); // len said there was a free block...
+   return false;
+#endif
+}
+
+static size_t Helper_TakeFreeBlocks( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t max,
+                                     void * out[] )
+{
+   struct ArrayPoolBlockList_S * list = &arena->lists[blk_sz];
+   struct ArrayPoolBlock_S blk = { .sz = blk_sz, .idx = 0, .trimmed = false, .movable = false, .run_len = 0 };
+   size_t num_taken = 0;
+
+   for ( size_t w = 0; (w < list->map_words) && (num_taken < max) && (list->len > 0); w++ )
+   {
+#ifdef ARRAY_ARENA_REALTIME
+      // Straight to the lowest word /w a free block, rather than past the empty ones
+      size_t s = Helper_Ctz32( list->free_top );
+      w = (s * FREE_MAP_WORD_BITS) + Helper_Ctz32( list->free_summary[s] );
+#endif
+      uint32_t word = list->free_map[w];
+      if ( 0 == word )   continue;
+
+      while ( (word != 0) && (num_taken < max) )
+      {
+         blk.idx = (w * FREE_MAP_WORD_BITS) + Helper_Ctz32( word );
+         word &= word - 1u; // Clear the lowest set bit
+         list->len--;
+         Helper_IndexBlock( arena, &blk );
+         out[num_taken++] = &arena->pool[ blk.idx * list->block_size ];
+      }
+      list->free_map[w] = word;
+      FREE_SUMMARY_SYNC( list, w );
+   }
+
+   return num_taken;
+}
+
+static size_t Helper_CarveBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx,
+                                 enum BlockSize target_sz, size_t max, void * out[] )
+{
+   assert( target_sz > blk_sz );
+   assert( max > 0 );
+
+   // The block spans the target size blocks from (blk_idx << depth) up to,
+   // but not including, the one at ((blk_idx + 1) << depth).
+   uint8_t depth = (uint8_t)(target_sz - blk_sz);
+   STATS_COUNT( arena, blk_sz, splits );
+   TELEM_BLOCK( arena, ARRAY_ARENA_TELEM_SPLIT, blk_sz, blk_idx );
+   size_t end_idx = (blk_idx + 1) << depth;
+   struct ArrayPoolBlock_S blk = { .sz = target_sz, .idx = blk_idx << depth,
+                                   .trimmed = false, .movable = false, .run_len = 0 };
+   size_t num_taken = 0;
+
+   for ( ; (blk.idx < end_idx) && (num_taken < max); blk.idx++ )
+   {
+      Helper_IndexBlock( arena, &blk );
+      out[num_taken++] = &arena->pool[ blk.idx * BlockSize_E_to_Int[target_sz] ];
+   }
+
+   // Hand back what's left as the fewest blocks that cover it, i.e., each time
+   // the largest block that starts where the last one ended. The buddy of each
+   // of those lies below it, where the blocks are either taken or smaller, so
+   // there is nothing for any of them to merge /w.
+   for ( size_t idx = blk.idx; idx < end_idx; )
+   {
+      uint8_t sz = (uint8_t)target_sz;
+      size_t span = 1; // In target size blocks
+      while ( ((idx % (2 * span)) == 0) && ((idx + (2 * span)) <= end_idx) )
+      {
+         sz--;
+         span *= 2;
+      }
+      Helper_MarkBlockFree( arena, (enum BlockSize)sz, idx / span );
+      idx += span;
+   }
+
+   return num_taken;
+}
+
+static bool Helper_AllocBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t * blk_idx )
+{
+   // Allocate the lowest-addressed free block of the list. This helps
+   // maintain (but does not guarantee) a convenient descending order of
+   // block sizes, which will make for more efficient allocating, freeing,
+   // splitting, and coalescing.
+   // Failing that, merging what has been freed lazily may make one, but the
+   // lists are only merged when nothing of the size or larger is free as is.
+   do
+   {
+      if ( Helper_TakeFreeBlock( arena, blk_sz, blk_idx ) )   return true;
+
+      // Look in the free lists of the larger block sizes, starting from the
+      // nearest one so that we split as few blocks as possible.
+      for ( int larger_sz = (int)blk_sz - 1; larger_sz >= (int)BLKS_LARGEST_SIZE; larger_sz-- )
+      {
+         size_t larger_blk_idx;
+         if ( !Helper_TakeFreeBlock( arena, (enum BlockSize)larger_sz, &larger_blk_idx ) )  continue;
+
+         *blk_idx = Helper_SplitBlock( arena, (enum BlockSize)larger_sz, larger_blk_idx, blk_sz );
+         return true;
+      }
+   } while ( LAZY_MERGE( arena ) );
+
+   return false;
+}
+
+static bool Helper_TakeBlock( struct ArrayArena_S * arena, struct ArrayPoolBlock_S * blk )
+{
+   if ( blk->run_len > 0 )
+   {
+      // Large allocations bypass the block sizes entirely and come straight
+      // from the largest block list. Nothing is split to make a run.
+      return Helper_TakeFreeRun( arena, blk->run_len, &blk->idx ) ||
+             ( LAZY_MERGE( arena ) && Helper_TakeFreeRun( arena, blk->run_len, &blk->idx ) );
+   }
+
+   // A trimmed block is carved out of a block twice the size of its head
+   enum BlockSize whole_sz = blk->trimmed ? (enum BlockSize)(blk->sz - 1) : blk->sz;
+   size_t whole_idx;
+   if ( !Helper_AllocBlock( arena, whole_sz, &whole_idx ) )   return false;
+
+   blk->idx = whole_idx;
+   if ( blk->trimmed )
+   {
+      // Keep the lower half and the quarter after it, and hand back the last
+      // quarter. Its buddy is the quarter we kept, so there is nothing to merge.
+      blk->idx = whole_idx * 2;
+      Helper_MarkBlockFree( arena, (enum BlockSize)(blk->sz + 1), (whole_idx * 4) + 3 );
+      STATS_COUNT( arena, whole_sz, splits );
+      STATS_COUNT( arena, blk->sz, splits );
+      TELEM_BLOCK( arena, ARRAY_ARENA_TELEM_SPLIT, whole_sz, whole_idx );
+      TELEM_BLOCK( arena, ARRAY_ARENA_TELEM_SPLIT, blk->sz, (whole_idx * 2) + 1 );
+   }
+
+   return true;
+}
+
+static bool Helper_TakeFreeRun( struct ArrayArena_S * arena, size_t run_len, size_t * blk_idx )
+{
+   assert( run_len > 0 );
+   assert( blk_idx != NULL );
+
+   struct ArrayPoolBlockList_S * list = &arena->lists[BLKS_LARGEST_SIZE];
+   if ( list->len < run_len )   return false;
+
+   // Find the lowest-addressed run of run_len set bits, skipping over
+   // all-allocated and all-free words a word at a time.
+   size_t run_start = 0;
+   size_t run_found = 0;
+   for ( size_t word_idx = 0; (word_idx < list->map_words) && (run_found < run_len); word_idx++ )
+   {
+      uint32_t word = list->free_map[word_idx];
+
+      if ( 0 == word )
+      {
+         run_found = 0;
+         continue;
+      }
+      else if ( UINT32_MAX == word )
+      {
+         if ( 0 == run_found )   run_start = word_idx * FREE_MAP_WORD_BITS;
+         run_found += FREE_MAP_WORD_BITS;
+         continue;
+      }
+
+      for ( uint8_t bit = 0; (bit < FREE_MAP_WORD_BITS) && (run_found < run_len); bit++ )
+      {
+         if ( word & (1u << bit) )
+         {
+            if ( 0 == run_found )   run_start = (word_idx * FREE_MAP_WORD_BITS) + bit;
+            run_found++;
+         }
+         else
+         {
+            run_found = 0;
+         }
+      }
+   }
+
+   if ( run_found < run_len )   return false;
+
+   for ( size_t i = 0; i < run_len; i++ )
+   {
+      Helper_MarkBlockAllocated( arena, BLKS_LARGEST_SIZE, run_start + i );
+   }
+
+   *blk_idx = run_start;
+   return true;
+}
+
+static size_t Helper_SplitBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx,
+                                 enum BlockSize target_sz )
+{
+   assert( target_sz > blk_sz );
+   assert( !Helper_IsBlockFree( arena, blk_sz, blk_idx ) );
+
+   // A block at idx i of one size spans the blocks at idx (2 * i) and
+   // (2 * i + 1) of the next size down.
+   for ( uint8_t sz = (uint8_t)(blk_sz + 1); sz <= (uint8_t)target_sz; sz++ )
+   {
+      STATS_COUNT( arena, sz - 1, splits );
+      TELEM_BLOCK( arena, ARRAY_ARENA_TELEM_SPLIT, sz - 1, blk_idx );
+      blk_idx *= 2;
+      Helper_MarkBlockFree( arena, (enum BlockSize)sz, blk_idx + 1 );
+   }
+
+   return blk_idx;
+}
+
+static void Helper_CoalesceBlock( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx )
+{
+   // The buddy of the block at offset o is at o ^ block_size, which in terms
+   // of list idx is just the idx /w its lowest bit flipped. If the buddy is a
+   // free block of the same size, the pair merges into the block one size up.
+   // The buddy of a block at the tail of the arena may lie past the end of it,
+   // but then its free bit is never set, so only the bitmap itself bounds it.
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+   if ( blk_sz != BLKS_LARGEST_SIZE )   arena->lists[blk_sz].unmerged++;
+#else
+   while ( blk_sz != BLKS_LARGEST_SIZE )
+   {
+      size_t buddy_idx = blk_idx ^ 1u;
+      if ( ((buddy_idx / FREE_MAP_WORD_BITS) >= arena->lists[blk_sz].map_words) ||
+           !Helper_IsBlockFree( arena, blk_sz, buddy_idx ) )
+      {
+         break;
+      }
+
+      Helper_MarkBlockAllocated( arena, blk_sz, buddy_idx );
+      STATS_COUNT( arena, blk_sz, coalesces );
+      blk_idx /= 2;
+      blk_sz = (enum BlockSize)(blk_sz - 1);
+      TELEM_BLOCK( arena, ARRAY_ARENA_TELEM_COALESCE, blk_sz, blk_idx );
+   }
+#endif
+
+   Helper_MarkBlockFree( arena, blk_sz, blk_idx );
+}
+
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+
+static size_t Helper_MergeList( struct ArrayArena_S * arena, enum BlockSize blk_sz )
+{
+   assert( blk_sz != BLKS_LARGEST_SIZE );
+
+   // Buddies are the blocks at idx 2k and 2k + 1, which are always in the same
+   // word, so the pairs of a word are its even bits whose odd bit is also set.
+   // As in Helper_CoalesceBlock(), the pair merges into the block at idx k of
+   // the next size up.
+   struct ArrayPoolBlockList_S * list = &arena->lists[blk_sz];
+   size_t num_merged = 0;
+
+   for ( size_t w = 0; (w < list->map_words) && (list->len >= 2); w++ )
+   {
+      uint32_t word = list->free_map[w];
+      uint32_t pairs = word & (word >> 1) & 0x55555555u;
+      if ( 0 == pairs )   continue;
+
+      list->free_map[w] = word & ~(pairs | (pairs << 1));
+      FREE_SUMMARY_SYNC( list, w );
+      for ( ; pairs != 0; pairs &= (pairs - 1u) )
+      {
+         size_t blk_idx = ((w * FREE_MAP_WORD_BITS) + Helper_Ctz32( pairs )) / 2;
+         list->len -= 2;
+         STATS_COUNT( arena, blk_sz, coalesces );
+         Helper_MarkBlockFree( arena, (enum BlockSize)(blk_sz - 1), blk_idx );
+         TELEM_BLOCK( arena, ARRAY_ARENA_TELEM_COALESCE, blk_sz - 1, blk_idx );
+         num_merged++;
+      }
+   }
+
+   return num_merged;
+}
+
+static bool Helper_MergePending( struct ArrayArena_S * arena )
+{
+   bool merged_any = false;
+
+   for ( uint8_t sz = (uint8_t)(NUM_OF_BLOCK_SIZES - 1); sz > (uint8_t)BLKS_LARGEST_SIZE; sz-- )
+   {
+      if ( 0 == arena->lists[sz].unmerged )   continue;
+
+      arena->lists[sz].unmerged = 0;
+      size_t num_merged = Helper_MergeList( arena, (enum BlockSize)sz );
+      arena->lists[sz - 1].unmerged += num_merged;
+      merged_any = merged_any || (num_merged > 0);
+   }
+   arena->lists[BLKS_LARGEST_SIZE].unmerged = 0;
+
+   return merged_any;
+}
+
+static bool Helper_MergeInto( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx )
+{
+   if ( (blk_idx / FREE_MAP_WORD_BITS) >= arena->lists[blk_sz].map_words )   return false;
+   if ( Helper_IsBlockFree( arena, blk_sz, blk_idx ) )   return true;
+   if ( (NUM_OF_BLOCK_SIZES - 1) == blk_sz )   return false;
+
+   // The halves are the blocks at idx (2 * i) and (2 * i + 1) one size down
+   enum BlockSize half_sz = (enum BlockSize)(blk_sz + 1);
+   if ( !Helper_MergeInto( arena, half_sz, 2 * blk_idx ) ||
+        !Helper_MergeInto( arena, half_sz, (2 * blk_idx) + 1 ) )
+   {
+      return false;
+   }
+
+   Helper_MarkBlockAllocated( arena, half_sz, 2 * blk_idx );
+   Helper_MarkBlockAllocated( arena, half_sz, (2 * blk_idx) + 1 );
+   STATS_COUNT( arena, half_sz, coalesces );
+   Helper_MarkBlockFree( arena, blk_sz, blk_idx );
+   TELEM_BLOCK( arena, ARRAY_ARENA_TELEM_COALESCE, blk_sz, blk_idx );
+   // Its own buddy may be free too, for the next pass to find
+   if ( blk_sz != BLKS_LARGEST_SIZE )   arena->lists[blk_sz].unmerged++;
+   return true;
+}
+
+static bool Helper_MergeCovered( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk )
+{
+   bool merged_any = false;
+
+   if ( blk->run_len > 0 )
+   {
+      for ( size_t i = 0; i < blk->run_len; i++ )
+      {
+         merged_any = Helper_MergeInto( arena, BLKS_LARGEST_SIZE, blk->idx + i ) || merged_any;
+      }
+      return merged_any;
+   }
+
+   merged_any = Helper_MergeInto( arena, blk->sz, blk->idx );
+   if ( blk->trimmed )
+   {
+      merged_any = Helper_MergeInto( arena, (enum BlockSize)(blk->sz + 1), (blk->idx * 2) + 2 ) || merged_any;
+   }
+   return merged_any;
+}
+
+#endif // ARRAY_ARENA_LAZY_COALESCE
+
+static void Helper_ReleaseBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk )
+{
+   if ( blk->run_len > 0 )
+   {
+      // Largest blocks have no buddies to merge /w
+      for ( size_t i = 0; i < blk->run_len; i++ )
+      {
+         Helper_MarkBlockFree( arena, BLKS_LARGEST_SIZE, blk->idx + i );
+      }
+      return;
+   }
+
+   if ( blk->trimmed )
+   {
+      // Free the tail first. It may merge /w the quarter handed back when the
+      // block was allocated, which rebuilds the head's buddy, so that the head
+      // can then merge all the way back up.
+      Helper_CoalesceBlock( arena, (enum BlockSize)(blk->sz + 1), (blk->idx * 2) + 2 );
+   }
+   Helper_CoalesceBlock( arena, blk->sz, blk->idx );
+}
+
+static bool Helper_ClaimBlockAt( struct ArrayArena_S * arena, enum BlockSize blk_sz, size_t blk_idx )
+{
+   // Walk up to the free block that contains the one wanted, if there is one.
+   // Free buddies are always merged, so if the block wanted is entirely free,
+   // it is either free itself or inside exactly one larger free block. /w
+   // ARRAY_ARENA_LAZY_COALESCE, it may also be made up of smaller free blocks
+   // that are yet to be merged, in which case it is not had.
+   uint8_t free_sz = (uint8_t)blk_sz;
+   size_t free_idx = blk_idx;
+   while ( true )
+   {
+      if ( (free_idx / FREE_MAP_WORD_BITS) >= arena->lists[free_sz].map_words )   return false;
+      if ( Helper_IsBlockFree( arena, (enum BlockSize)free_sz, free_idx ) )   break;
+      if ( (uint8_t)BLKS_LARGEST_SIZE == free_sz )   return false;
+
+      free_sz--;
+      free_idx /= 2;
+   }
+
+   // Split it back down, handing back each half that is not on the way down
+   Helper_MarkBlockAllocated( arena, (enum BlockSize)free_sz, free_idx );
+   while ( free_sz < (uint8_t)blk_sz )
+   {
+      STATS_COUNT( arena, free_sz, splits );
+      TELEM_BLOCK( arena, ARRAY_ARENA_TELEM_SPLIT, free_sz, free_idx );
+      free_sz++;
+      free_idx = blk_idx >> ((uint8_t)blk_sz - free_sz);
+      Helper_MarkBlockFree( arena, (enum BlockSize)free_sz, free_idx ^ 1 );
+   }
+
+   return true;
+}
+
+static bool Helper_ClaimBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk )
+{
+   if ( blk->run_len > 0 )
+   {
+      for ( size_t i = 0; i < blk->run_len; i++ )
+      {
+         if ( Helper_ClaimBlockAt( arena, BLKS_LARGEST_SIZE, blk->idx + i ) )   continue;
+
+         // Give back the part of the run we did manage to take
+         while ( i-- > 0 )   Helper_MarkBlockFree( arena, BLKS_LARGEST_SIZE, blk->idx + i );
+         return false;
+      }
+      return true;
+   }
+
+   if ( !Helper_ClaimBlockAt( arena, blk->sz, blk->idx ) )   return false;
+
+   if ( blk->trimmed &&
+        !Helper_ClaimBlockAt( arena, (enum BlockSize)(blk->sz + 1), (blk->idx * 2) + 2 ) )
+   {
+      Helper_CoalesceBlock( arena, blk->sz, blk->idx );
+      return false;
+   }
+
+   return true;
+}
+
+static bool Helper_ResizeBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * old_blk,
+                                struct ArrayPoolBlock_S * new_blk )
+{
+   // The new block has to be able to start where the old one does. A trimmed
+   // block is carved out of a block twice the size of its head, so it needs
+   // to be aligned to that.
+   size_t offset = old_blk->idx * BlockSize_E_to_Int[old_blk->sz];
+   size_t new_blk_size = BlockSize_E_to_Int[new_blk->sz];
+   size_t alignment = new_blk->trimmed ? (2 * new_blk_size) : new_blk_size;
+   if ( (offset % alignment) != 0 )   return false;
+
+   new_blk->idx = offset / new_blk_size;
+   new_blk->movable = old_blk->movable;
+
+   // The bitmaps are all kept apart from the blocks themselves, so handing
+   // back the old block and taking the new one leaves the contents untouched.
+   // If the new one cannot be had, the old one is still free to take back.
+   Helper_UnindexBlock( arena, old_blk );
+   Helper_ReleaseBlock( arena, old_blk );
+
+   bool claimed = Helper_ClaimBlock( arena, new_blk );
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+   // What is in the way may only be free buddies that are yet to be merged
+   // (the old block's own among them), so merge those the new block covers
+   if ( !claimed && Helper_MergeCovered( arena, new_blk ) )
+   {
+      claimed = Helper_ClaimBlock( arena, new_blk );
+   }
+#endif
+   if ( !claimed )
+   {
+      bool reclaimed = Helper_ClaimBlock( arena, old_blk );
+      assert( reclaimed );
+      (void)reclaimed;
+      Helper_IndexBlock( arena, old_blk );
+      return false;
+   }
+
+   Helper_IndexBlock( arena, new_blk );
+   arena->space_available += Helper_BlockBytes( old_blk );
+   arena->space_available -= Helper_BlockBytes( new_blk );
+   return true;
+}
+
+static void Helper_IndexBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk )
+{
+   size_t offset = blk->idx * arena->lists[blk->sz].block_size;
+
+   assert( (offset % ARRAY_ARENA_GRANULE_SIZE) == 0 );
+   assert( (offset / ARRAY_ARENA_GRANULE_SIZE) < ARENA_NUM_OF_GRANULES(arena) );
+
+   uint8_t entry = BLOCK_SZ_TO_GRANULE_ENTRY(blk->sz);
+   if ( blk->trimmed )   entry |= GRANULE_ENTRY_TRIMMED;
+   if ( blk->movable )   entry |= GRANULE_ENTRY_MOVABLE;
+   arena->granules[offset / ARRAY_ARENA_GRANULE_SIZE] = entry;
+
+   if ( BLKS_LARGEST_SIZE == blk->sz )   arena->run_lens[blk->idx] = blk->run_len;
+   TAGS_INDEX( arena, offset / ARRAY_ARENA_GRANULE_SIZE, Helper_BlockBytes( blk ) );
+   VIZ_MARK_DIRTY( arena, offset, Helper_BlockBytes( blk ) );
+}
+
+static void Helper_UnindexBlock( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk )
+{
+   size_t offset = blk->idx * arena->lists[blk->sz].block_size;
+
+   assert( (offset / ARRAY_ARENA_GRANULE_SIZE) < ARENA_NUM_OF_GRANULES(arena) );
+
+   arena->granules[offset / ARRAY_ARENA_GRANULE_SIZE] = BLOCK_SZ_NONE;
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   if ( &ArrayArena == arena )   ArrayArenaBlockOwner[offset / ARRAY_ARENA_GRANULE_SIZE] = 0;
+#endif
+
+   if ( BLKS_LARGEST_SIZE == blk->sz )   arena->run_lens[blk->idx] = 0;
+   TAGS_UNINDEX( arena, offset / ARRAY_ARENA_GRANULE_SIZE, Helper_BlockBytes( blk ) );
+   VIZ_MARK_DIRTY( arena, offset, Helper_BlockBytes( blk ) );
+}
+
+#ifdef ARRAY_ARENA_TAGS
+static void Helper_TagsIndex( struct ArrayArena_S * arena, size_t granule, size_t bytes )
+{
+   ArrayArenaTag_T tag = arena->alloc_tag;
+   assert( tag < ARRAY_ARENA_MAX_TAGS );
+
+   struct ArrayArenaTagStats_S * stats = &arena->tag_stats[tag];
+   arena->granule_tags[granule] = tag;
+   stats->live_blocks++;
+   stats->live_bytes += bytes;
+   if ( stats->live_bytes > stats->peak_bytes )   stats->peak_bytes = stats->live_bytes;
+#ifdef ARRAY_ARENA_TELEMETRY
+   // The drain clears these from its own task
+   __atomic_or_fetch( &arena->tags_dirty, (uint32_t)1u << tag, __ATOMIC_RELAXED );
+#endif
+}
+
+static void Helper_TagsUnindex( struct ArrayArena_S * arena, size_t granule, size_t bytes )
+{
+   ArrayArenaTag_T tag = arena->granule_tags[granule];
+   assert( tag < ARRAY_ARENA_MAX_TAGS );
+
+   struct ArrayArenaTagStats_S * stats = &arena->tag_stats[tag];
+   assert( (stats->live_blocks > 0) && (stats->live_bytes >= bytes) );
+   arena->granule_tags[granule] = ARRAY_ARENA_UNTAGGED;
+   stats->live_blocks--;
+   stats->live_bytes -= bytes;
+#ifdef ARRAY_ARENA_TELEMETRY
+   __atomic_or_fetch( &arena->tags_dirty, (uint32_t)1u << tag, __ATOMIC_RELAXED );
+#endif
+}
 
-enum BlockSize
+static ArrayArenaTag_T Helper_BlockTag( struct ArrayArena_S * arena, const void * ptr )
 {
-   BLKS_LARGEST_SIZE,
-   BLKS_1024 = BLKS_LARGEST_SIZE,
-   BLKS_512,
-   BLKS_256,
-   BLKS_128,
-   BLKS_64,
-   BLKS_32,
-   NUM_OF_BLOCK_SIZES
-};
-
-static size_t BlockSize_E_to_Int[NUM_OF_BLOCK_SIZES] = { 1024, 512, 256, 128, 64, 32 };
+   if ( !Helper_FindBlock( arena, ptr, NULL ) )   return ARRAY_ARENA_UNTAGGED;
+   return TAG_AT( arena, (size_t)((const uint8_t *)ptr - arena->pool) );
+}
+#endif // ARRAY_ARENA_TAGS
 
-struct ArrayPoolBlock_S
+#ifdef ARRAY_ARENA_HARDENED
+static void Helper_Fault( struct ArrayArena_S * arena, enum ArrayArenaFault fault, const void * ptr )
 {
-   void * ptr; // Pointer to block
-   bool is_free;  // Flag to clear when allocating this block
-};
-struct ArrayPoolBlockList_S
+   arena->faults[fault]++;
+   if ( arena->fault_cb != NULL )   arena->fault_cb( fault, ptr, arena->fault_ctx );
+}
+
+static void Helper_CanarySet( struct ArrayArena_S * arena, void * ptr, size_t blk_bytes )
 {
-   struct ArrayPoolBlock_S * blocks; // Array of blocks of this list
-   uint16_t block_size; // Size of blocks in this list in bytes
-   size_t len; // How many blocks are in this list
-};
-struct ArrayArena_S
+   size_t offset = (size_t)((uint8_t *)ptr - arena->pool);
+   uint32_t canary = ARRAY_ARENA_CANARY ^ (uint32_t)offset;
+   memcpy( (uint8_t *)ptr + blk_bytes - CANARY_BYTES, &canary, CANARY_BYTES );
+}
+
+static void Helper_CanaryCheck( struct ArrayArena_S * arena, const void * ptr, size_t blk_bytes )
 {
-   struct ArrayPoolBlockList_S lists[NUM_OF_BLOCK_SIZES];
-   bool arena_initialized;
-   size_t space_available;
-};
+   size_t offset = (size_t)((const uint8_t *)ptr - arena->pool);
+   uint32_t canary;
+   memcpy( &canary, (const uint8_t *)ptr + blk_bytes - CANARY_BYTES, CANARY_BYTES );
+   if ( canary != (ARRAY_ARENA_CANARY ^ (uint32_t)offset) )   Helper_Fault( arena, ARRAY_ARENA_FAULT_CANARY, ptr );
+}
 
-//! The arena of contiguous bytes from which we allocate from.
-STATIC uint8_t ArrayArenaPool[VEC_ARRAY_ARENA_SIZE];
+static void Helper_BadFree( struct ArrayArena_S * arena, const void * ptr )
+{
+   if ( NULL == ptr )   return;
 
-// These shall be the list of allocatable blocks (the "free lists").
-struct ArrayPoolBlock_S blocks_1024[BLOCKS_1024_LIST_CAPACITY];
-struct ArrayPoolBlock_S blocks_512[BLOCKS_512_LIST_CAPACITY];
-struct ArrayPoolBlock_S blocks_256[BLOCKS_256_LIST_CAPACITY];
-struct ArrayPoolBlock_S blocks_128[BLOCKS_128_LIST_CAPACITY];
-struct ArrayPoolBlock_S blocks_64[BLOCKS_64_LIST_CAPACITY];
-struct ArrayPoolBlock_S blocks_32[BLOCKS_32_LIST_CAPACITY];
+   bool double_free = ( ARRAY_ARENA_DOUBLE_FREE == Helper_BadPtrStatus( arena, ptr ) );
+   Helper_Fault( arena, double_free ? ARRAY_ARENA_FAULT_DOUBLE_FREE : ARRAY_ARENA_FAULT_BAD_FREE, ptr );
+}
 
-STATIC struct ArrayArena_S ArrayArena =
+#ifdef ARRAY_ARENA_HARDENED_POISON
+static void Helper_PoisonCheck( struct ArrayArena_S * arena, const void * ptr, size_t blk_bytes )
 {
-   .lists =
-   {
-      [ BLKS_1024 ] = { .blocks = blocks_1024, .len = (BLOCKS_1024_LIST_INIT_LEN - 1), .block_size = 1024 },
-      [ BLKS_512  ] = { .blocks = blocks_512,  .len = (BLOCKS_512_LIST_INIT_LEN  - 1), .block_size = 512  },
-      [ BLKS_256  ] = { .blocks = blocks_256,  .len = (BLOCKS_256_LIST_INIT_LEN  - 1), .block_size = 256  },
-      [ BLKS_128  ] = { .blocks = blocks_128,  .len = (BLOCKS_128_LIST_INIT_LEN  - 1), .block_size = 128  },
-      [ BLKS_64   ] = { .blocks = blocks_64,   .len = (BLOCKS_64_LIST_INIT_LEN   - 1), .block_size = 64   },
-      [ BLKS_32   ] = { .blocks = blocks_32,   .len = (BLOCKS_32_LIST_INIT_LEN   - 1), .block_size = 32   }
-   },
-   .arena_initialized = false,
-   .space_available = VEC_ARRAY_ARENA_SIZE - (VEC_ARRAY_ARENA_SIZE % 32)
-};
+   const uint32_t poison = 0x01010101u * (uint32_t)ARRAY_ARENA_POISON_BYTE;
+   uint32_t first;
+   uint32_t last;
+   memcpy( &first, ptr, sizeof(first) );
+   memcpy( &last, (const uint8_t *)ptr + blk_bytes - sizeof(last), sizeof(last) );
 
-/**
- * @brief Local helper function to find the block that corresponds to the pointer passed in.
- * 
- * @note The enum BlockSize * and size_t * parameters are optional and may be
- *       set to NULL if all the user cares about is if there exists a block that
- *       lives at the address passed in.
- * @param[in]  ptr     Address to look for among the allocatable blocks
- * @param[out] blk_sz  (Ptr) Enum for which block list the ptr belongs to (optional)
- * @param[out] blk_idx (Ptr) Idx within the block list that the ptr belongs to (optional)
- * @return true if successful in finding a block; false otherwise
- */
-static bool Helper_FindBlock( const void *,
-     /* Return Parameters */  enum BlockSize *, size_t * );
+   if ( ((first != poison) && (first != 0)) || ((last != poison) && (last != 0)) )
+   {
+      Helper_Fault( arena, ARRAY_ARENA_FAULT_POISON, ptr );
+   }
+}
+#endif
+#endif // ARRAY_ARENA_HARDENED
 
-/**
- * @brief Initializes the static array pool arena structures.
- */
-STATIC void StaticArrayPoolInit(void)
+static void Helper_LayoutFreeLists( struct ArrayArena_S * arena, const size_t list_init_lens[] )
 {
-   // Initialize the pointers within the arena free lists, calculating an offset
-   // into the ArrayArenaPool for each.
-   // TODO: This can be done at compile-time. If the macro magic isn't too crazy, let's try that.
-   assert( ArrayArena.lists != NULL );
-   assert( !ArrayArena.arena_initialized );
-
    size_t accumulating_offset = 0;
    for ( uint8_t i = 0; i < (uint8_t)NUM_OF_BLOCK_SIZES; i++ )
    {
-      struct ArrayPoolBlockList_S * list = &ArrayArena.lists[i];
-      assert( list != NULL );
-      for ( size_t j = 0; j < list->len; j++ )
+      const struct ArrayPoolBlockList_S * list = &arena->lists[i];
+      for ( size_t j = 0; j < list_init_lens[i]; j++ )
       {
-         assert( accumulating_offset < VEC_ARRAY_ARENA_SIZE );
-         list->blocks[j].ptr = &ArrayArenaPool[ accumulating_offset ];
-         list->blocks[j].is_free = true;
+         assert( accumulating_offset < arena->pool_size );
+         assert( (accumulating_offset % list->block_size) == 0 );
+         Helper_MarkBlockFree( arena, (enum BlockSize)i, accumulating_offset / list->block_size );
          accumulating_offset += list->block_size;
-         assert( accumulating_offset <= VEC_ARRAY_ARENA_SIZE );
+         assert( accumulating_offset <= arena->pool_size );
       }
    }
 
-   ArrayArena.arena_initialized = true;
+   arena->space_available = accumulating_offset;
+   arena->arena_initialized = true;
 }
 
-/**
- * Check that the static array pool is initialized.
- */
-STATIC bool StaticArrayPoolIsInitialized(void)
+static size_t Helper_MetadataBytes( size_t pool_size )
 {
-   return ArrayArena.arena_initialized;
+   size_t bytes = LIST_CAPACITY( pool_size, LARGEST_BLOCK_SIZE ) * sizeof(size_t);
+#ifdef ARRAY_ARENA_TELEMETRY
+   bytes += ARRAY_ARENA_TELEMETRY_RING_LEN * sizeof(struct ArrayArenaTelemRec_S);
+#endif
+   for ( uint8_t i = 0; i < (uint8_t)NUM_OF_BLOCK_SIZES; i++ )
+   {
+      size_t map_words = FREE_MAP_WORDS( LIST_CAPACITY( pool_size, BlockSize_E_to_Int[i] ) );
+      bytes += map_words * sizeof(uint32_t);
+#ifdef ARRAY_ARENA_REALTIME
+      bytes += FREE_SUMMARY_WORDS( map_words ) * sizeof(uint32_t);
+#endif
+   }
+#if defined(ARRAY_ARENA_HANDLES) && defined(ARRAY_ARENA_DEFRAG)
+   bytes += (pool_size / ARRAY_ARENA_GRANULE_SIZE) * sizeof(ArrayArenaHandle_T);
+#endif
+#ifdef ARRAY_ARENA_TAGS
+   bytes += (pool_size / ARRAY_ARENA_GRANULE_SIZE) * sizeof(ArrayArenaTag_T);
+#endif
+   bytes += pool_size / ARRAY_ARENA_GRANULE_SIZE;
+   return bytes;
 }
 
-/**
- * @brief Allocates a contiguous block that can accomodate req_bytes from
- *        a static arena. Block size guaranteed to be ≥req_bytes.
- * @note Presently uses the "Buddy System" as described in:
- *          memorymanagement.org/mmref/alloc.html
- * @return Pointer to the allocated block if successful, NULL otherwise.
- */
-STATIC void * StaticArrayAlloc(size_t req_bytes)
+static bool Helper_CarveArena( struct ArrayArena_S * arena, void * buffer, size_t len )
 {
-   assert( ArrayArena.arena_initialized );
+   size_t align_gap = ALIGN_UP_GAP( buffer, ARENA_POOL_ALIGNMENT );
+   if ( align_gap >= len )   return false;
+   buffer = (uint8_t *)buffer + align_gap;
+   len -= align_gap;
+#ifdef ARRAY_ARENA_PERSISTENT
+   if ( PERSIST_HDR_BYTES >= len )   return false;
+   buffer = (uint8_t *)buffer + PERSIST_HDR_BYTES;
+   len -= PERSIST_HDR_BYTES;
+#endif
+
+   // The metadata never grows as the pool shrinks, so taking what a pool of
+   // the whole buffer would need off the end always leaves enough room for it.
+   size_t max_metadata_bytes = Helper_MetadataBytes( len - (len % ARRAY_ARENA_GRANULE_SIZE) );
+   if ( max_metadata_bytes >= len )   return false;
+   size_t pool_size = len - max_metadata_bytes;
+   pool_size -= pool_size % ARRAY_ARENA_GRANULE_SIZE;
+   if ( pool_size < SMALLEST_BLOCK_SIZE )   return false;
+#ifdef ARRAY_ARENA_SHARED
+   if ( pool_size > UINT32_MAX )   return false; // Peers queue blocks up by 32-bit offset
+#endif
+#ifdef ARRAY_ARENA_REALTIME
+   if ( FREE_MAP_WORDS( LIST_CAPACITY( pool_size, SMALLEST_BLOCK_SIZE ) ) > REALTIME_MAX_MAP_WORDS )   return false;
+#endif
 
-   if ( req_bytes > ArrayArena.space_available )
+   uint8_t * metadata = (uint8_t *)buffer + pool_size;
+   arena->pool = buffer;
+   arena->pool_size = pool_size;
+   arena->run_lens = (size_t *)(void *)metadata;
+   metadata += LIST_CAPACITY( pool_size, LARGEST_BLOCK_SIZE ) * sizeof(size_t);
+#ifdef ARRAY_ARENA_TELEMETRY
+   arena->telem.recs = (struct ArrayArenaTelemRec_S *)(void *)metadata;
+   metadata += ARRAY_ARENA_TELEMETRY_RING_LEN * sizeof(struct ArrayArenaTelemRec_S);
+#endif
+   for ( uint8_t i = 0; i < (uint8_t)NUM_OF_BLOCK_SIZES; i++ )
    {
-      // TODO: Return result type that specifies requested bytes was greater than space available
-      return NULL;
+      struct ArrayPoolBlockList_S * list = &arena->lists[i];
+      list->block_size = (uint16_t)BlockSize_E_to_Int[i];
+      list->map_words = FREE_MAP_WORDS( LIST_CAPACITY( pool_size, list->block_size ) );
+      list->free_map = (uint32_t *)(void *)metadata;
+      list->len = 0;
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+      list->unmerged = 0;
+#endif
+      metadata += list->map_words * sizeof(uint32_t);
+#ifdef ARRAY_ARENA_REALTIME
+      list->free_summary = (uint32_t *)(void *)metadata;
+      list->free_top = 0;
+      metadata += FREE_SUMMARY_WORDS( list->map_words ) * sizeof(uint32_t);
+#endif
    }
+#if defined(ARRAY_ARENA_HANDLES) && defined(ARRAY_ARENA_DEFRAG)
+   arena->granule_handles = (ArrayArenaHandle_T *)(void *)metadata;
+   metadata += ARENA_NUM_OF_GRANULES(arena) * sizeof(ArrayArenaHandle_T);
+#endif
+#ifdef ARRAY_ARENA_TAGS
+   arena->granule_tags = metadata;
+   metadata += ARENA_NUM_OF_GRANULES(arena) * sizeof(ArrayArenaTag_T);
+#endif
+   arena->granules = metadata;
+#ifdef ARRAY_ARENA_SHARED
+   arena->remote_free_head = (uint32_t *)(void *)(PERSIST_HDR_AT(arena) + sizeof(struct ArrayArenaPersistHdr_S));
+#endif
+   return true;
+}
+
+static void Helper_ResetArenaState( struct ArrayArena_S * arena )
+{
+   (void)arena;
+
+#ifdef ARRAY_ARENA_DEFRAG
+   arena->defrag.relocate_cb = NULL;
+   arena->defrag.relocate_ctx = NULL;
+   arena->defrag.cursor = ARENA_NUM_OF_GRANULES(arena);
+   arena->defrag.moved_this_pass = false;
+#endif
+#ifdef ARRAY_ARENA_HANDLES
+   memset( &arena->handles, 0, sizeof(arena->handles) );
+   arena->handles.free_head = ARRAY_ARENA_NULL_HANDLE;
+   arena->handles.num_untouched = ARRAY_ARENA_NULL_HANDLE + 1;
+#endif
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   arena->lock_flag = false;
+#endif
+#ifdef ARRAY_ARENA_STATS
+   memset( &arena->stats, 0, sizeof(arena->stats) );
+#endif
+#ifdef ARRAY_ARENA_VIZ
+   ArrayArenaVizRefresh( arena );
+#endif
+#ifdef ARRAY_ARENA_TELEMETRY
+   arena->telem.head = 0;
+   arena->telem.tail = 0;
+   arena->telem.dropped = 0;
+   arena->telem.info_pending = true;
+#endif
+#ifdef ARRAY_ARENA_HARDENED
+   arena->fault_cb = NULL;
+   arena->fault_ctx = NULL;
+   memset( arena->faults, 0, sizeof(arena->faults) );
+#endif
+#ifdef ARRAY_ARENA_TAGS
+   arena->alloc_tag = ARRAY_ARENA_UNTAGGED;
+   memset( arena->tag_stats, 0, sizeof(arena->tag_stats) );
+#ifdef ARRAY_ARENA_TELEMETRY
+   arena->tags_dirty = 0;
+#endif
+#endif
+}
 
-   #ifndef NDEBUG
-   // Confirm assumption that the lists are sorted in order of descending block size
-   uint16_t prev_sz = ArrayArena.lists[0].block_size;
-   for ( uint8_t sz = 1; sz < (uint8_t)NUM_OF_BLOCK_SIZES; sz++ )
+#ifdef ARRAY_ARENA_PERSISTENT
+static uint32_t Helper_Fnv1a( uint32_t hash, const void * bytes, size_t len )
+{
+   for ( size_t i = 0; i < len; i++ )
    {
-      assert( ArrayArena.lists[sz].block_size > prev_sz );
-      prev_sz = ArrayArena.lists[sz].block_size;
+      hash ^= ((const uint8_t *)bytes)[i];
+      hash *= FNV1A_PRIME;
    }
-   #endif
+   return hash;
+}
 
-   void * block_ptr = NULL;
-   size_t space_allocated = 0;
+static uint32_t Helper_PersistChecksum( const struct ArrayArenaPersistHdr_S * hdr )
+{
+   struct ArrayArenaPersistHdr_S copy = *hdr;
+   copy.checksum = 0;
+   return Helper_Fnv1a( FNV1A_OFFSET_BASIS, &copy, sizeof(copy) );
+}
 
-   // TODO: Accomodate block requests larger than 1024
-   assert( req_bytes <= 1024 );
-   // TODO: Reduce internal fragmentation /w block requests that are in between powers of 2
-   // Start checking from the largest block sizes down
-   for ( uint8_t sz = 0; sz < (uint8_t)NUM_OF_BLOCK_SIZES; sz++ )
+static uint32_t Helper_PersistLayout( void )
+{
+   const uint32_t config[] =
    {
-      // Skip until we find the nearest block size that accomodates the request
-      if ( req_bytes < (ArrayArena.lists[sz].block_size / 2) ) continue;
+      (uint32_t)sizeof(size_t),
+      (uint32_t)ARRAY_ARENA_GRANULE_SIZE,
+      (uint32_t)ARENA_POOL_ALIGNMENT,
+      (uint32_t)NUM_OF_BLOCK_SIZES,
+#ifdef ARRAY_ARENA_TELEMETRY
+      (uint32_t)ARRAY_ARENA_TELEMETRY_RING_LEN,
+#else
+      0u,
+#endif
+#ifdef ARRAY_ARENA_TAGS
+      (uint32_t)ARRAY_ARENA_MAX_TAGS,
+#else
+      0u,
+#endif
+      // What else changes what is in the metadata (or in the blocks)
+      0u
+#ifdef ARRAY_ARENA_REALTIME
+      | 0x01u
+#endif
+#ifdef ARRAY_ARENA_INTERMEDIATE_SIZES
+      | 0x02u
+#endif
+#ifdef ARRAY_ARENA_DEFRAG
+      | 0x04u
+#endif
+#ifdef ARRAY_ARENA_HARDENED
+      | 0x08u
+#endif
+#ifdef ARRAY_ARENA_HARDENED_POISON
+      | 0x10u
+#endif
+#ifdef ARRAY_ARENA_SHARED
+      | 0x20u
+#endif
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+      | 0x40u // Free buddies may be left unmerged
+#endif
+   };
+
+   uint32_t hash = Helper_Fnv1a( FNV1A_OFFSET_BASIS, config, sizeof(config) );
+   return Helper_Fnv1a( hash, BlockSize_E_to_Int, sizeof(BlockSize_E_to_Int) );
+}
+
+static bool Helper_PersistHdrIsValid( const struct ArrayArena_S * arena, size_t len )
+{
+   struct ArrayArenaPersistHdr_S hdr;
+   memcpy( &hdr, PERSIST_HDR_AT(arena), sizeof(hdr) );
+
+   return (hdr.magic == ARRAY_ARENA_PERSIST_MAGIC) &&
+          (hdr.version == ARRAY_ARENA_PERSIST_VERSION) &&
+          (hdr.hdr_size == sizeof(struct ArrayArenaPersistHdr_S)) &&
+          (hdr.layout == Helper_PersistLayout()) &&
+          (hdr.len == (uint64_t)len) &&
+          (hdr.pool_size == (uint64_t)arena->pool_size) &&
+          (hdr.space <= hdr.pool_size) &&
+          (hdr.checksum == Helper_PersistChecksum( &hdr ));
+}
+
+static bool Helper_PersistRebuild( struct ArrayArena_S * arena )
+{
+   // Every byte laid out is in exactly one free or allocated block
+   size_t bytes_covered = 0;
 
-      struct ArrayPoolBlockList_S * list = &ArrayArena.lists[sz];
-      bool found_block = false;
-      // Allocate from the beginning of the block list. This helps maintain
-      // (but does not guarantee) a convenient descending order of block sizes,
-      // which will make for more efficient allocating, freeing, splitting, and
-      // coalescing.
-      for ( size_t i = 0; i < list->len; i++ )
+   for ( uint8_t i = 0; i < (uint8_t)NUM_OF_BLOCK_SIZES; i++ )
+   {
+      struct ArrayPoolBlockList_S * list = &arena->lists[i];
+      list->len = 0;
+#ifdef ARRAY_ARENA_REALTIME
+      memset( list->free_summary, 0, FREE_SUMMARY_WORDS( list->map_words ) * sizeof(uint32_t) );
+      list->free_top = 0;
+#endif
+      for ( size_t w = 0; w < list->map_words; w++ )
       {
-         if ( list->blocks[i].is_free )
+         for ( uint32_t word = list->free_map[w]; word != 0; word &= (word - 1u) )
          {
-            found_block = true;
-            space_allocated = list->block_size;
-            block_ptr = list->blocks[i].ptr;
-            list->blocks[i].is_free = false;
+            size_t offset = ((w * FREE_MAP_WORD_BITS) + Helper_Ctz32( word )) * list->block_size;
+            if ( (offset > (arena->pool_size - list->block_size)) ||
+                 (arena->granules[offset / ARRAY_ARENA_GRANULE_SIZE] != BLOCK_SZ_NONE) ||
+                 (list->block_size > (arena->pool_size - bytes_covered)) )
+            {
+               return false;
+            }
+            list->len++;
+            bytes_covered += list->block_size;
          }
+         FREE_SUMMARY_SYNC( list, w );
       }
+#ifdef ARRAY_ARENA_LAZY_COALESCE
+      // Whatever was left unmerged is not known, so any of it may be
+      list->unmerged = list->len;
+#endif
+   }
+   arena->space_available = bytes_covered;
 
-      if ( (!found_block) && (sz != (uint8_t)BLKS_LARGEST_SIZE) )
-      {
-         // Look in the free lists of the larger block sizes
-         // TODO: Loop through the block sizes up to the largest block size, not just the next size up.
+   struct ArrayArenaPersistHdr_S hdr;
+   memcpy( &hdr, PERSIST_HDR_AT(arena), sizeof(hdr) );
+   for ( size_t granule = 0; granule < ARENA_NUM_OF_GRANULES(arena); granule++ )
+   {
+      uint8_t entry = arena->granules[granule];
+      if ( BLOCK_SZ_NONE == entry )   continue;
 
-         // Initially, the lists are of adjacent blocks, and the lists are organized
-         // in descending order. So, the end of one list's large blocks is the start of
-         // the next list's smaller blocks. If we split the block at the end, this
-         // convenient descending order is maintained. This is also why I allocate
-         // from the beginning of a list.
-         struct ArrayPoolBlockList_S * larger_size_list = &ArrayArena.lists[sz + 1];
-         for ( int i = (int)(larger_size_list->len - 1); i >= 0; i-- )
-         {
-            if ( !larger_size_list->blocks[i].is_free )  continue;
-
-            // Split the larger block and assign its info to the smaller size free list
-            larger_size_list->len--;
-            list->blocks[list->len].ptr = larger_size_list->blocks[i].ptr;
-            list->blocks[list->len + 1].ptr = (uint8_t *)larger_size_list->blocks[i].ptr + larger_size_list->block_size;
-            list->blocks[list->len].is_free = false;
-            list->blocks[list->len + 1].is_free = true;
-            list->len += 2;
-            block_ptr = list->blocks[list->len - 2].ptr;
-            // Assign 
-            found_block = true;
-            space_allocated = list->block_size;
-         }
+      size_t sz = (size_t)(entry & ~GRANULE_ENTRY_FLAGS);
+      size_t offset = granule * ARRAY_ARENA_GRANULE_SIZE;
+      if ( (BLOCK_SZ_NONE == sz) || (sz > NUM_OF_BLOCK_SIZES) ||
+           ((offset % BlockSize_E_to_Int[sz - 1]) != 0) )
+      {
+         return false;
       }
 
-      break;
+      struct ArrayPoolBlock_S blk;
+      (void)Helper_FindBlock( arena, &arena->pool[offset], &blk );
+      if ( blk.run_len > (arena->pool_size / BlockSize_E_to_Int[blk.sz]) )   return false;
+      size_t bytes = Helper_BlockBytes( &blk );
+      if ( (bytes > (arena->pool_size - offset)) || (bytes > (arena->pool_size - bytes_covered)) )   return false;
+      bytes_covered += bytes;
+
+#ifdef ARRAY_ARENA_STATS
+      struct ArrayArenaClassStats_S * class_stats = &arena->stats.classes[blk.sz];
+      Helper_StatsPeak( &class_stats->peak_live_blocks, STATS_ADD( class_stats->live_blocks, 1u ) );
+      Helper_StatsPeak( &arena->stats.peak_bytes_in_use, STATS_ADD( arena->stats.bytes_in_use, bytes ) );
+#endif
+#ifdef ARRAY_ARENA_TAGS
+      if ( arena->granule_tags[granule] >= ARRAY_ARENA_MAX_TAGS )   return false;
+      arena->alloc_tag = arena->granule_tags[granule];
+      Helper_TagsIndex( arena, granule, bytes );
+      arena->alloc_tag = ARRAY_ARENA_UNTAGGED;
+#endif
    }
 
-   ArrayArena.space_available -= space_allocated;
-   return block_ptr;
+   // A block in the middle of an alloc or free (e.g., taken off its free list
+   // but not yet indexed) is in neither, which shows as bytes gone missing
+   return (uint64_t)bytes_covered == hdr.space;
 }
+#endif // ARRAY_ARENA_PERSISTENT
 
-STATIC void * StaticArrayRealloc(void * ptr, size_t req_bytes)
+#ifdef ARRAY_ARENA_SHARED
+static void Helper_RemoteFreePush( uint8_t * pool, uint32_t * head, uint32_t offset )
 {
-   enum BlockSize old_blk_sz;
-   size_t old_blk_idx;
-   bool old_blk_found = Helper_FindBlock( ptr, &old_blk_sz, &old_blk_idx );
+   uint32_t * link = (uint32_t *)(void *)&pool[offset];
+   uint32_t top = __atomic_load_n( head, __ATOMIC_RELAXED );
 
-   if ( !old_blk_found )
+   do
    {
-      // TODO: Raise exception that user tried to realloc an unallocated block
-      return NULL;
+      __atomic_store_n( link, top, __ATOMIC_RELAXED );
+   } while ( !__atomic_compare_exchange_n( head, &top, offset, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED ) );
+}
+
+static size_t Helper_SharedReclaim( struct ArrayArena_S * arena )
+{
+   if ( NULL == arena->remote_free_head )   return 0;
+
+   uint32_t offset = __atomic_exchange_n( arena->remote_free_head, ARRAY_ARENA_NO_REMOTE_FREE, __ATOMIC_ACQUIRE );
+   size_t num_of_blks = 0;
+
+   // The links are written by other processes, so a corrupt one ends the walk
+   // (and at most one block per granule can be on the queue).
+   while ( (offset < arena->pool_size) && ((offset % ARRAY_ARENA_GRANULE_SIZE) == 0) &&
+           (num_of_blks < ARENA_NUM_OF_GRANULES(arena)) )
+   {
+      uint8_t * blk = &arena->pool[offset];
+      offset = __atomic_load_n( (uint32_t *)(void *)blk, __ATOMIC_RELAXED );
+      Helper_ArenaFree( arena, blk );
+      num_of_blks++;
    }
-   else if ( ArrayArena.lists[old_blk_sz].blocks[old_blk_idx].is_free )
+
+   return num_of_blks;
+}
+#endif // ARRAY_ARENA_SHARED
+
+#ifdef ARRAY_ARENA_VIZ
+static void Helper_VizMarkDirty( struct ArrayArena_S * arena, size_t offset, size_t len )
+{
+   if ( arena->viz_dirty_lo >= arena->viz_dirty_hi )
    {
-      // TODO: Raise exception that user tried to realloc a block that was free
-      return NULL;
+      arena->viz_dirty_lo = offset;
+      arena->viz_dirty_hi = offset + len;
+      return;
    }
-   else if ( req_bytes >  (ArrayArena.lists[old_blk_sz].block_size / 2) &&
-             req_bytes <= ArrayArena.lists[old_blk_sz].block_size )
+
+   if ( offset < arena->viz_dirty_lo )   arena->viz_dirty_lo = offset;
+   if ( (offset + len) > arena->viz_dirty_hi )   arena->viz_dirty_hi = offset + len;
+}
+
+// Changes are marked as they happen
+static void Helper_VizSync( struct ArrayArena_S * arena )
+{
+   (void)arena;
+}
+
+static size_t Helper_VizBlockAt( const struct ArrayArena_S * arena, size_t offset, enum ArenaVizBlkState * state )
+{
+   // The default pool may end in less than a granule, which no block can use
+   if ( (offset / ARRAY_ARENA_GRANULE_SIZE) >= ARENA_NUM_OF_GRANULES(arena) )
    {
-      // Not much point in reallocating if the size is the best fit.
-      // TODO: Accomodate realloc size requests in between powers of 2 using combo of block sizes
-      return ptr;
+      *state = ARENA_VIZ_BLK_UNLISTED;
+      return arena->pool_size - offset;
    }
-   else if ( 0 == req_bytes )
+
+   const uint8_t entry = arena->granules[offset / ARRAY_ARENA_GRANULE_SIZE];
+   if ( entry != BLOCK_SZ_NONE )
    {
-      StaticArrayFree( ptr );
-      return NULL;
+      struct ArrayPoolBlock_S blk = { .sz = GRANULE_ENTRY_TO_BLOCK_SZ(entry),
+                                      .idx = offset / BlockSize_E_to_Int[GRANULE_ENTRY_TO_BLOCK_SZ(entry)],
+                                      .trimmed = (entry & GRANULE_ENTRY_TRIMMED) != 0,
+                                      .movable = false, .run_len = 0 };
+      if ( BLKS_LARGEST_SIZE == blk.sz )   blk.run_len = arena->run_lens[blk.idx];
+      *state = ARENA_VIZ_BLK_ALLOCATED;
+      return Helper_BlockBytes( &blk );
    }
 
-   void * tmp = StaticArrayAlloc( req_bytes );
-   if ( tmp != NULL )
+   // Free blocks never overlap, so at most one size can have one starting here
+   for ( uint8_t sz = 0; sz < (uint8_t)NUM_OF_BLOCK_SIZES; sz++ )
    {
-      size_t old_blk_size = BlockSize_E_to_Int[old_blk_sz];
-      size_t num_of_bytes = (req_bytes > old_blk_size) ? old_blk_size : req_bytes;
-      memcpy( tmp, ptr, num_of_bytes );
-      StaticArrayFree( ptr );
-      return tmp;
+      const struct ArrayPoolBlockList_S * list = &arena->lists[sz];
+      size_t blk_idx = offset / list->block_size;
+      if ( ((offset % list->block_size) != 0) || ((blk_idx / FREE_MAP_WORD_BITS) >= list->map_words) )   continue;
+      if ( (list->free_map[blk_idx / FREE_MAP_WORD_BITS] >> (blk_idx % FREE_MAP_WORD_BITS)) & 1u )
+      {
+         *state = ARENA_VIZ_BLK_FREE;
+         return list->block_size;
+      }
    }
 
-   // Must not have been able to allocate new block...
-   // TODO: Need a better way to express that we failed to realloc. Probably add void ** new_ptr param and return bool/exception/result type.
-   return ptr;
+   *state = ARENA_VIZ_BLK_UNLISTED;
+   return ARRAY_ARENA_GRANULE_SIZE;
 }
+#endif // ARRAY_ARENA_VIZ
 
-/**
- * @brief Free the block at the address passed in, if applicable.
- * @note If the address passed in is not one that a block lives at, the fcn simply returns.
- * @param[in] Address of block to free
- */
-STATIC void StaticArrayFree(const void * ptr)
+#ifdef ARRAY_ARENA_STATS
+static void Helper_StatsAlloc( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk,
+                               size_t req_bytes, size_t n )
 {
-   enum BlockSize blk_sz;
-   size_t blk_idx;
-   bool blk_found = Helper_FindBlock( ptr, &blk_sz, &blk_idx );
+   struct ArrayArenaClassStats_S * class_stats = &arena->stats.classes[blk->sz];
+   size_t bytes = n * Helper_BlockBytes( blk );
 
-   if ( !blk_found ) return;  // TODO: Raise exception that user tried to free an unallocated block?
-
-   ArrayArena.lists[blk_sz].blocks[blk_idx].is_free = true;
-   ArrayArena.space_available += BlockSize_E_to_Int[blk_sz];
+   STATS_ADD( class_stats->allocs, n );
+   Helper_StatsPeak( &class_stats->peak_live_blocks, STATS_ADD( class_stats->live_blocks, n ) );
+   Helper_StatsPeak( &arena->stats.peak_bytes_in_use, STATS_ADD( arena->stats.bytes_in_use, bytes ) );
+   STATS_ADD( arena->stats.bytes_requested, n * req_bytes );
+   STATS_ADD( arena->stats.bytes_granted, bytes );
 }
 
-/**
- * @brief Determine whether an address is associated with a block that is allocated.
- */
-STATIC bool StaticArrayIsAlloc(const void * ptr)
+static void Helper_StatsFree( struct ArrayArena_S * arena, const struct ArrayPoolBlock_S * blk )
 {
-   enum BlockSize blk_sz;
-   size_t blk_idx;
-   bool blk_found = Helper_FindBlock( ptr, &blk_sz, &blk_idx );
+   struct ArrayArenaClassStats_S * class_stats = &arena->stats.classes[blk->sz];
+
+   STATS_ADD( class_stats->frees, 1u );
+   STATS_SUB( class_stats->live_blocks, 1u );
+   STATS_SUB( arena->stats.bytes_in_use, Helper_BlockBytes( blk ) );
+}
 
-   if ( !blk_found ) return false;
+static void Helper_StatsFail( struct ArrayArena_S * arena, size_t req_bytes, size_t n )
+{
+   // Too large a request for any run is counted against the largest size
+   struct ArrayPoolBlock_S blk;
+   if ( !Helper_RequestToBlock( arena, req_bytes, &blk ) )   blk.sz = BLKS_LARGEST_SIZE;
 
-   return !ArrayArena.lists[blk_sz].blocks[blk_idx].is_free;
+   STATS_ADD( arena->stats.classes[blk.sz].fails, n );
 }
 
-/* Static Array Allocator Helper Implementations */
+static void Helper_StatsPeak( size_t * peak, size_t val )
+{
+#ifdef ARRAY_ARENA_THREAD_SAFE
+   size_t seen = STATS_LOAD( *peak );
+   while ( (val > seen) &&
+           !__atomic_compare_exchange_n( peak, &seen, val, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+   {
+      // seen has been refreshed /w whatever beat us to it
+   }
+#else
+   if ( val > *peak )   *peak = val;
+#endif
+}
 
-static bool Helper_FindBlock( const void * ptr,
-                              enum BlockSize * blk_sz, size_t * blk_idx )
+#ifdef ARRAY_ARENA_STATS_CYCLES
+static void Helper_StatsCycles( size_t hist[], uint32_t cycles )
 {
-   assert( ArrayArena.arena_initialized );
+   uint8_t bucket = ( 0 == cycles ) ? 0 : Helper_Log2_32( cycles );
+   if ( bucket >= ARRAY_ARENA_CYCLE_BUCKETS )   bucket = ARRAY_ARENA_CYCLE_BUCKETS - 1;
 
-   if ( NULL == ptr )   return false;
+   STATS_ADD( hist[bucket], 1u );
+}
 
-#ifndef NDEBUG
-   bool blk_found = false;
+static uint8_t Helper_Log2_32( uint32_t word )
+{
+   assert( word != 0 );
+#if defined(__GNUC__)
+   return (uint8_t)(31 - __builtin_clz( word ));
+#else
+   uint8_t log2 = 0;
+   while ( word >>= 1 )   log2++;
+   return log2;
 #endif
-   for ( uint8_t sz = 0; sz < (uint8_t)NUM_OF_BLOCK_SIZES; sz++ )
+}
+#endif // ARRAY_ARENA_STATS_CYCLES
+#endif // ARRAY_ARENA_STATS
+
+#ifdef ARRAY_ARENA_TELEMETRY
+static void Helper_TelemEmit( struct ArrayArena_S * arena, enum ArrayArenaTelemType type,
+                              uint8_t blk_sz, size_t offset, size_t arg )
+{
+   struct ArrayArenaTelemRing_S * ring = &arena->telem;
+   size_t pos = __atomic_load_n( &ring->head, __ATOMIC_RELAXED );
+
+   while ( true )
    {
-      const struct ArrayPoolBlockList_S * list = &ArrayArena.lists[sz];
-      for ( size_t i = 0; i < list->len; i++ )
+      if ( (pos - __atomic_load_n( &ring->tail, __ATOMIC_ACQUIRE )) >= ARRAY_ARENA_TELEMETRY_RING_LEN )
       {
-         // 🗒: Should I allow for an address _inside_ a block?
-         //     (ptr >= list->blocks[i].ptr) && (ptr < list->blocks[i+1].ptr)
-         if ( list->blocks[i].ptr == ptr )
-         {
-            if ( blk_sz != NULL ) *blk_sz = (enum BlockSize)sz;
-            if ( blk_idx != NULL ) *blk_idx = i;
-
-#ifndef NDEBUG
-            // Assert that this is the only block that has this address. For
-            // the debug build, keep searching to make sure this assertion holds.
-            // We should only enter this if statement once, so blk_found should
-            // still be false.
-            assert(!blk_found);
-            blk_found = true;
+         __atomic_add_fetch( &ring->dropped, 1u, __ATOMIC_RELAXED );
+         return;
+      }
+#ifdef ARRAY_ARENA_THREAD_SAFE
+      // If some other thread claimed pos first, pos is refreshed to the new head
+      if ( __atomic_compare_exchange_n( &ring->head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )   break;
 #else
-            return true;
+      ring->head = pos + 1;
+      break;
 #endif
-
-         }
-      }
    }
 
-#ifndef NDEBUG
-   return blk_found;
+   struct ArrayArenaTelemRec_S * rec = &ring->recs[ pos & (ARRAY_ARENA_TELEMETRY_RING_LEN - 1) ];
+   rec->type = (uint8_t)(ARRAY_ARENA_TELEM_SYNC | (uint8_t)type);
+   rec->blk_sz = blk_sz;
+   rec->timestamp = (uint32_t)ARRAY_ARENA_TELEMETRY_TIMESTAMP();
+   rec->offset = (uint32_t)offset;
+   rec->arg = (uint32_t)arg;
+   __atomic_store_n( &rec->seq, (uint16_t)(pos + 1), __ATOMIC_RELEASE ); // Now it may be drained
+}
+
+static bool Helper_TelemSendOne( ArrayArenaTelemSink_T sink, void * ctx, enum ArrayArenaTelemType type,
+                                 uint8_t blk_sz, size_t offset, size_t arg )
+{
+   struct ArrayArenaTelemRec_S rec =
+   {
+      .type = (uint8_t)(ARRAY_ARENA_TELEM_SYNC | (uint8_t)type), .blk_sz = blk_sz, .seq = 0,
+      .timestamp = (uint32_t)ARRAY_ARENA_TELEMETRY_TIMESTAMP(),
+      .offset = (uint32_t)offset, .arg = (uint32_t)arg
+   };
+   return ( 1 == sink( ctx, &rec, 1 ) );
+}
+#endif // ARRAY_ARENA_TELEMETRY
+
+static uint8_t Helper_Ctz32( uint32_t word )
+{
+   assert( word != 0 );
+#if defined(__GNUC__)
+   // RBIT + CLZ on ARMv7-M and up, BSF/TZCNT on x86
+   return (uint8_t)__builtin_ctz( word );
 #else
-   return false;
+   // De Bruijn multiply-and-lookup on the isolated lowest set bit
+   static const uint8_t DeBruijnBitPos[32] =
+   {
+      0,  1,  28, 2,  29, 14, 24, 3,  30, 22, 20, 15, 25, 17, 4,  8,
+      31, 27, 13, 23, 21, 19, 16, 7,  26, 12, 18, 6,  11, 5,  10, 9
+   };
+   return DeBruijnBitPos[ ((word & (~word + 1u)) * 0x077CB531u) >> 27 ];
 #endif
 }
 
+#endif // ARRAY_ARENA_SCHEME_BUMP
+
+/**
+ * @brief Offset of ptr from the start of an arena's pool (e.g., for a layout
+ *        export), which stays good across attaches and mappings where ptr
+ *        would not.
+ * @return The offset; ARRAY_ARENA_NO_OFFSET if ptr is not within the pool
+ */
+STATIC size_t ArrayArenaOffsetOf(const struct ArrayArena_S * arena, const void * ptr)
+{
+   uintptr_t addr = (uintptr_t)ptr;
+   uintptr_t base = (uintptr_t)arena->pool;
+   if ( (NULL == ptr) || (addr < base) || (addr >= (base + arena->pool_size)) )   return ARRAY_ARENA_NO_OFFSET;
+
+   return (size_t)(addr - base);
+}
+
+/**
+ * @brief The address of offset within an arena's pool, as mapped for this arena.
+ * @return The address; NULL if offset is not within the pool
+ */
+STATIC void * ArrayArenaAtOffset(const struct ArrayArena_S * arena, size_t offset)
+{
+   if ( offset >= arena->pool_size )   return NULL;
+
+   return &arena->pool[offset];
+}
+
 #ifdef ARRAY_ARENA_VIZ
 
-// TODO: Implement arena viz API
+// Each scheme provides:
+//    - Helper_VizSync(): bring the dirty range up to date (if it is not kept
+//      up to date as the arena changes)
+//    - Helper_VizBlockAt(): the state and length of the block starting at an
+//      offset the dirty range starts at, or that the previous one ended at
+
+STATIC const struct Vizable ArrayArenaVizable =
+{
+   .ArenaLayout = StaticArrayVizLayout,
+   .ArenaSize = StaticArrayVizSize
+};
+
+STATIC size_t StaticArrayVizLayout(struct ArenaVizList * viz_list, size_t max_entries)
+{
+   return ArrayArenaVizLayout( &ArrayArena, viz_list, max_entries );
+}
+
+STATIC size_t StaticArrayVizSize(void)
+{
+   return ArrayArena.pool_size;
+}
+
+// Layout entries of allocated blocks carry the owner's tag, when there are tags
+#ifdef ARRAY_ARENA_TAGS
+#define VIZ_BLOCK_TAG(arena, offset, state) \
+   ( (ARENA_VIZ_BLK_ALLOCATED == (state)) ? TAG_AT( (arena), (offset) ) : ARRAY_ARENA_UNTAGGED )
+#else
+#define VIZ_BLOCK_TAG(arena, offset, state) 0u
+#endif
+
+/**
+ * @brief Export the layout of the part of an arena that has changed since the
+ *        last export into viz_list->list[0..max_entries).
+ * @note The walk starts at the first block that changed, and goes a block at
+ *       a time up through the last, so the cost is bound by the size of the
+ *       change and by max_entries, not by the size of the arena. If it stops
+ *       on max_entries, the next export carries on from there. Call until 0
+ *       is returned to catch up fully.
+ * @return How many entries were written (also left in viz_list->len)
+ */
+STATIC size_t ArrayArenaVizLayout(struct ArrayArena_S * arena, struct ArenaVizList * viz_list, size_t max_entries)
+{
+   if ( NULL == viz_list )   return 0;
+
+   Helper_VizSync( arena );
+
+   size_t num_of_entries = 0;
+   size_t offset = arena->viz_dirty_lo;
+   while ( (offset < arena->viz_dirty_hi) && (offset < arena->pool_size) )
+   {
+      enum ArenaVizBlkState state;
+      size_t len = Helper_VizBlockAt( arena, offset, &state );
+      uint8_t tag = (uint8_t)VIZ_BLOCK_TAG( arena, offset, state );
+
+      struct ArenaVizBlk * last = (num_of_entries > 0) ? &viz_list->list[num_of_entries - 1] : NULL;
+      if ( (last != NULL) && (last->state == state) && (last->tag == tag) )
+      {
+         last->blk_len += len;
+      }
+      else
+      {
+         if ( num_of_entries == max_entries )   break;
+         viz_list->list[num_of_entries].blk_offset = offset;
+         viz_list->list[num_of_entries].blk_len = len;
+         viz_list->list[num_of_entries].state = state;
+         viz_list->list[num_of_entries].tag = tag;
+         num_of_entries++;
+      }
+      offset += len;
+   }
+
+   // Whatever was not reached is still to be exported
+   arena->viz_dirty_lo = offset;
+   if ( offset >= arena->viz_dirty_hi )
+   {
+      arena->viz_dirty_lo = 0;
+      arena->viz_dirty_hi = 0;
+   }
+
+   viz_list->len = num_of_entries;
+   return num_of_entries;
+}
+
+/**
+ * @brief Have the next export cover the whole arena (e.g., for a visualizer
+ *        that has just connected).
+ */
+STATIC void ArrayArenaVizRefresh(struct ArrayArena_S * arena)
+{
+   arena->viz_dirty_lo = 0;
+   arena->viz_dirty_hi = arena->pool_size;
+}
 
 #endif // ARRAY_ARENA_VIZ
 
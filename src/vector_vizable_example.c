@@ -1,9 +1,11 @@
 #include "vector_vizable_example.h"
-#include <stdlib.h>
 #include <string.h>
 
+// The arena API used below (and ArrayArena, the default arena) comes from
+// sara.c, which is built in ahead of this file (see vector_vizable_example.h).
+
 /**
- * @brief Vector vtable implementation
+ * @brief Vtable implementations
  */
 const struct VizableVTable VizableVector_VTable = {
     .type_name = "Vector",
@@ -15,6 +17,82 @@ const struct VizableVTable VizableVector_VTable = {
     .destroy = Vector_Destroy
 };
 
+const struct VizableVTable VizableRing_VTable = {
+    .type_name = "Ring",
+    .get_arena_layout = Ring_GetArenaLayout,
+    .get_arena_size = Ring_GetArenaSize,
+    .get_element_count = Ring_GetElementCount,
+    .get_element_size = Ring_GetElementSize,
+    .is_empty = Ring_IsEmpty,
+    .destroy = Ring_Destroy
+};
+
+const struct VizableVTable VizableMap_VTable = {
+    .type_name = "Map",
+    .get_arena_layout = Map_GetArenaLayout,
+    .get_arena_size = Map_GetArenaSize,
+    .get_element_count = Map_GetElementCount,
+    .get_element_size = Map_GetElementSize,
+    .is_empty = Map_IsEmpty,
+    .destroy = Map_Destroy
+};
+
+// Each slot of a map is one of these, followed by the value
+struct VizableMapSlot {
+    uint32_t key;
+    uint32_t used;  // 0 if the slot is empty
+};
+
+// Values start (and slots are padded) to this, for values of any scalar type
+#define MAP_VALUE_ALIGN 8u
+
+/**
+ * @brief Shared helpers of the containers
+ */
+static void* Container_AllocHeader(struct ArrayArena_S* arena, size_t size) {
+    void* obj = NULL;
+    if (arena == NULL || ArrayArenaTryAlloc(arena, size, &obj, NULL) != ARRAY_ARENA_OK) {
+        return NULL;
+    }
+    return obj;
+}
+
+/**
+ * @brief (Re)size the block at *data (if any) to hold at least bytes > 0, in
+ *        place if the arena can manage it.
+ * @return How many bytes the block was granted; 0 if it could not be had, in
+ *         which case *data and its block are left as they were
+ */
+static size_t Container_Resize(struct ArrayArena_S* arena, void** data, size_t bytes) {
+    void* block = *data;
+    size_t granted = 0;
+    enum ArrayArenaStatus status = (block == NULL) ?
+        ArrayArenaTryAlloc(arena, bytes, &block, &granted) :
+        ArrayArenaTryRealloc(arena, &block, bytes, &granted);
+    if (status != ARRAY_ARENA_OK) {
+        return 0;
+    }
+
+    *data = block;
+    return granted;
+}
+
+/**
+ * @brief Add an entry to a layout export, if it is not empty and there is room.
+ */
+static void VizList_Add(struct ArenaVizList* viz_list, size_t max_entries,
+                        size_t offset, size_t len, enum ArenaVizBlkState state) {
+    if (len == 0 || viz_list->len >= max_entries) {
+        return;
+    }
+
+    struct ArenaVizBlk* blk = &viz_list->list[viz_list->len++];
+    blk->blk_offset = offset;
+    blk->blk_len = len;
+    blk->state = state;
+    blk->tag = 0;
+}
+
 /**
  * @brief Implementation of Vector's vizable methods
  */
@@ -23,12 +101,20 @@ size_t Vector_GetArenaLayout(const void* self, struct ArenaVizList* viz_list, si
     if (vec == NULL || viz_list == NULL) {
         return 0;
     }
-    
-    // TODO: Implement actual arena layout logic
-    // This would populate viz_list with information about memory layout
-    // For now, return a placeholder
-    (void)max_entries; // Suppress unused parameter warning
-    return 1; // Number of entries added to viz_list
+    viz_list->len = 0;
+
+    // The header, then the elements, then the room left for more
+    VizList_Add(viz_list, max_entries, ArrayArenaOffsetOf(vec->arena, vec),
+                sizeof(struct VizableVector), ARENA_VIZ_BLK_ALLOCATED);
+    if (vec->data != NULL) {
+        size_t data_offset = ArrayArenaOffsetOf(vec->arena, vec->data);
+        size_t used_bytes = vec->length * vec->element_size;
+        VizList_Add(viz_list, max_entries, data_offset, used_bytes, ARENA_VIZ_BLK_ALLOCATED);
+        VizList_Add(viz_list, max_entries, data_offset + used_bytes,
+                    (vec->capacity - vec->length) * vec->element_size, ARENA_VIZ_BLK_FREE);
+    }
+
+    return viz_list->len;
 }
 
 size_t Vector_GetArenaSize(const void* self) {
@@ -36,7 +122,7 @@ size_t Vector_GetArenaSize(const void* self) {
     if (vec == NULL) {
         return 0;
     }
-    
+
     // Return total memory used by this vector
     return sizeof(struct VizableVector) + (vec->capacity * vec->element_size);
 }
@@ -46,7 +132,7 @@ size_t Vector_GetElementCount(const void* self) {
     if (vec == NULL) {
         return 0;
     }
-    
+
     return vec->length;
 }
 
@@ -55,7 +141,7 @@ size_t Vector_GetElementSize(const void* self) {
     if (vec == NULL) {
         return 0;
     }
-    
+
     return vec->element_size;
 }
 
@@ -64,7 +150,7 @@ bool Vector_IsEmpty(const void* self) {
     if (vec == NULL) {
         return true;
     }
-    
+
     return vec->length == 0;
 }
 
@@ -73,62 +159,551 @@ void Vector_Destroy(void* self) {
     if (vec == NULL) {
         return;
     }
-    
-    if (vec->data != NULL) {
-        free(vec->data);
-    }
-    free(vec);
+
+    ArrayArenaFree(vec->arena, vec->data);
+    ArrayArenaFree(vec->arena, vec);
 }
 
 /**
- * @brief Constructor implementation
+ * @brief Vector operations
  */
-struct VizableVector* VizableVector_Create(size_t element_size, size_t initial_capacity) {
-    struct VizableVector* vec = malloc(sizeof(struct VizableVector));
+struct VizableVector* VizableVector_Create(struct ArrayArena_S* arena, size_t element_size, size_t initial_capacity) {
+    if (element_size == 0) {
+        return NULL;
+    }
+
+    struct VizableVector* vec = Container_AllocHeader(arena, sizeof(struct VizableVector));
     if (vec == NULL) {
         return NULL;
     }
-    
+
     // Initialize the vizable base
     VizableVector_InitVizable(vec);
-    
-    // Initialize vector fields
+
+    vec->arena = arena;
+    vec->data = NULL;
     vec->element_size = element_size;
     vec->length = 0;
-    vec->capacity = initial_capacity;
-    vec->max_capacity = initial_capacity * 10; // Example
-    
-    vec->data = malloc(element_size * initial_capacity);
-    if (vec->data == NULL) {
-        free(vec);
+    vec->capacity = 0;
+
+    if (initial_capacity > 0 && !VizableVector_Reserve(vec, initial_capacity)) {
+        ArrayArenaFree(arena, vec);
         return NULL;
     }
-    
+
     return vec;
 }
 
+bool VizableVector_Reserve(struct VizableVector* vec, size_t min_capacity) {
+    if (vec == NULL) {
+        return false;
+    }
+    if (min_capacity <= vec->capacity) {
+        return true;
+    }
+    if (min_capacity > (SIZE_MAX / vec->element_size)) {
+        return false;
+    }
+
+    size_t granted = Container_Resize(vec->arena, &vec->data, min_capacity * vec->element_size);
+    if (granted == 0) {
+        return false;
+    }
+
+    // Whatever the block has room for beyond what was asked is capacity too
+    vec->capacity = granted / vec->element_size;
+    return true;
+}
+
+bool VizableVector_Push(struct VizableVector* vec, const void* element) {
+    if (vec == NULL || element == NULL) {
+        return false;
+    }
+
+    if (vec->length == vec->capacity) {
+        // Double, so that pushes stay O(1) amortized, but settle for one more
+        // if the arena has no room for that many
+        size_t doubled = (vec->capacity == 0) ? 1 :
+                         (vec->capacity > (SIZE_MAX / 2)) ? SIZE_MAX : (vec->capacity * 2);
+        if (!VizableVector_Reserve(vec, doubled) && !VizableVector_Reserve(vec, vec->length + 1)) {
+            return false;
+        }
+    }
+
+    memcpy((uint8_t*)vec->data + (vec->length * vec->element_size), element, vec->element_size);
+    vec->length++;
+    return true;
+}
+
+bool VizableVector_Pop(struct VizableVector* vec, void* element_out) {
+    if (vec == NULL || vec->length == 0) {
+        return false;
+    }
+
+    vec->length--;
+    if (element_out != NULL) {
+        memcpy(element_out, (uint8_t*)vec->data + (vec->length * vec->element_size), vec->element_size);
+    }
+    return true;
+}
+
+void* VizableVector_At(const struct VizableVector* vec, size_t idx) {
+    if (vec == NULL || idx >= vec->length) {
+        return NULL;
+    }
+
+    return (uint8_t*)vec->data + (idx * vec->element_size);
+}
+
+void VizableVector_Clear(struct VizableVector* vec) {
+    // The block is kept, so that filling the vector back up allocates nothing
+    if (vec != NULL) {
+        vec->length = 0;
+    }
+}
+
+bool VizableVector_ShrinkToFit(struct VizableVector* vec) {
+    if (vec == NULL) {
+        return false;
+    }
+
+    if (vec->length == 0) {
+        ArrayArenaFree(vec->arena, vec->data);
+        vec->data = NULL;
+        vec->capacity = 0;
+        return true;
+    }
+
+    size_t granted = Container_Resize(vec->arena, &vec->data, vec->length * vec->element_size);
+    if (granted == 0) {
+        return false;
+    }
+
+    vec->capacity = granted / vec->element_size;
+    return true;
+}
+
+/**
+ * @brief Implementation of Ring's vizable methods
+ */
+size_t Ring_GetArenaLayout(const void* self, struct ArenaVizList* viz_list, size_t max_entries) {
+    const struct VizableRing* ring = (const struct VizableRing*)self;
+    if (ring == NULL || viz_list == NULL) {
+        return 0;
+    }
+    viz_list->len = 0;
+
+    VizList_Add(viz_list, max_entries, ArrayArenaOffsetOf(ring->arena, ring),
+                sizeof(struct VizableRing), ARENA_VIZ_BLK_ALLOCATED);
+
+    // The elements are either one stretch of the block, or two once they wrap
+    // around its end
+    size_t data_offset = ArrayArenaOffsetOf(ring->arena, ring->data);
+    size_t es = ring->element_size;
+    if (ring->length == 0) {
+        VizList_Add(viz_list, max_entries, data_offset, ring->capacity * es, ARENA_VIZ_BLK_FREE);
+    } else if ((ring->head + ring->length) <= ring->capacity) {
+        size_t tail = ring->head + ring->length;
+        VizList_Add(viz_list, max_entries, data_offset, ring->head * es, ARENA_VIZ_BLK_FREE);
+        VizList_Add(viz_list, max_entries, data_offset + (ring->head * es), ring->length * es,
+                    ARENA_VIZ_BLK_ALLOCATED);
+        VizList_Add(viz_list, max_entries, data_offset + (tail * es), (ring->capacity - tail) * es,
+                    ARENA_VIZ_BLK_FREE);
+    } else {
+        size_t tail = ring->head + ring->length - ring->capacity;
+        VizList_Add(viz_list, max_entries, data_offset, tail * es, ARENA_VIZ_BLK_ALLOCATED);
+        VizList_Add(viz_list, max_entries, data_offset + (tail * es), (ring->head - tail) * es,
+                    ARENA_VIZ_BLK_FREE);
+        VizList_Add(viz_list, max_entries, data_offset + (ring->head * es),
+                    (ring->capacity - ring->head) * es, ARENA_VIZ_BLK_ALLOCATED);
+    }
+
+    return viz_list->len;
+}
+
+size_t Ring_GetArenaSize(const void* self) {
+    const struct VizableRing* ring = (const struct VizableRing*)self;
+    if (ring == NULL) {
+        return 0;
+    }
+
+    return sizeof(struct VizableRing) + (ring->capacity * ring->element_size);
+}
+
+size_t Ring_GetElementCount(const void* self) {
+    const struct VizableRing* ring = (const struct VizableRing*)self;
+    if (ring == NULL) {
+        return 0;
+    }
+
+    return ring->length;
+}
+
+size_t Ring_GetElementSize(const void* self) {
+    const struct VizableRing* ring = (const struct VizableRing*)self;
+    if (ring == NULL) {
+        return 0;
+    }
+
+    return ring->element_size;
+}
+
+bool Ring_IsEmpty(const void* self) {
+    const struct VizableRing* ring = (const struct VizableRing*)self;
+    if (ring == NULL) {
+        return true;
+    }
+
+    return ring->length == 0;
+}
+
+void Ring_Destroy(void* self) {
+    struct VizableRing* ring = (struct VizableRing*)self;
+    if (ring == NULL) {
+        return;
+    }
+
+    ArrayArenaFree(ring->arena, ring->data);
+    ArrayArenaFree(ring->arena, ring);
+}
+
+/**
+ * @brief Ring buffer operations
+ */
+struct VizableRing* VizableRing_Create(struct ArrayArena_S* arena, size_t element_size, size_t capacity) {
+    if (element_size == 0 || capacity == 0 || capacity > (SIZE_MAX / element_size)) {
+        return NULL;
+    }
+
+    struct VizableRing* ring = Container_AllocHeader(arena, sizeof(struct VizableRing));
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    VizableRing_InitVizable(ring);
+
+    void* data = NULL;
+    size_t granted = Container_Resize(arena, &data, capacity * element_size);
+    if (granted == 0) {
+        ArrayArenaFree(arena, ring);
+        return NULL;
+    }
+
+    ring->arena = arena;
+    ring->data = data;
+    ring->element_size = element_size;
+    ring->head = 0;
+    ring->length = 0;
+    ring->capacity = granted / element_size;
+    return ring;
+}
+
+bool VizableRing_Push(struct VizableRing* ring, const void* element) {
+    if (ring == NULL || element == NULL || ring->length == ring->capacity) {
+        return false;
+    }
+
+    size_t idx = ring->head + ring->length;
+    if (idx >= ring->capacity) {
+        idx -= ring->capacity;
+    }
+    memcpy(ring->data + (idx * ring->element_size), element, ring->element_size);
+    ring->length++;
+    return true;
+}
+
+bool VizableRing_Pop(struct VizableRing* ring, void* element_out) {
+    if (ring == NULL || ring->length == 0) {
+        return false;
+    }
+
+    if (element_out != NULL) {
+        memcpy(element_out, ring->data + (ring->head * ring->element_size), ring->element_size);
+    }
+    ring->head++;
+    if (ring->head == ring->capacity) {
+        ring->head = 0;
+    }
+    ring->length--;
+    return true;
+}
+
+void* VizableRing_Peek(const struct VizableRing* ring) {
+    if (ring == NULL || ring->length == 0) {
+        return NULL;
+    }
+
+    return ring->data + (ring->head * ring->element_size);
+}
+
+/**
+ * @brief Map helpers
+ */
+static struct VizableMapSlot* Map_Slot(const struct VizableMap* map, size_t idx) {
+    return (struct VizableMapSlot*)(void*)(map->slots + (idx * map->slot_size));
+}
+
+static uint32_t Map_Hash(uint32_t key) {
+    // Finalizer of MurmurHash3, so that keys that only differ in their high
+    // bits (e.g., ids /w a type in the top byte) still spread over the table
+    key ^= key >> 16;
+    key *= 0x85EBCA6Bu;
+    key ^= key >> 13;
+    key *= 0xC2B2AE35u;
+    key ^= key >> 16;
+    return key;
+}
+
+/**
+ * @return Idx of the slot key is in, or of the empty slot it would go in
+ */
+static size_t Map_Probe(const struct VizableMap* map, uint32_t key) {
+    size_t mask = map->num_slots - 1;
+    size_t idx = Map_Hash(key) & mask;
+    while (Map_Slot(map, idx)->used && Map_Slot(map, idx)->key != key) {
+        idx = (idx + 1) & mask;
+    }
+    return idx;
+}
+
+/**
+ * @brief Move the entries of a map into a new table of at least min_slots
+ *        slots (a power of 2), as many as the block granted holds.
+ * @return false if the arena has no room for it, in which case the map is
+ *         left as it was
+ */
+static bool Map_Rebuild(struct VizableMap* map, size_t min_slots) {
+    if (min_slots > (SIZE_MAX / map->slot_size)) {
+        return false;
+    }
+
+    // The entries have to be rehashed anyway, so this is a fresh block rather
+    // than a realloc of the old one
+    void* block = NULL;
+    size_t granted = Container_Resize(map->arena, &block, min_slots * map->slot_size);
+    if (granted == 0) {
+        return false;
+    }
+
+    size_t num_slots = min_slots;
+    while ((num_slots * 2) <= (granted / map->slot_size)) {
+        num_slots *= 2;
+    }
+    memset(block, 0, num_slots * map->slot_size);
+
+    struct VizableMap old = *map;
+    map->slots = block;
+    map->num_slots = num_slots;
+    for (size_t i = 0; i < old.num_slots; i++) {
+        const struct VizableMapSlot* slot = Map_Slot(&old, i);
+        if (slot->used) {
+            memcpy(Map_Slot(map, Map_Probe(map, slot->key)), slot, map->slot_size);
+        }
+    }
+    ArrayArenaFree(map->arena, old.slots);
+    return true;
+}
+
+/**
+ * @brief Implementation of Map's vizable methods
+ */
+size_t Map_GetArenaLayout(const void* self, struct ArenaVizList* viz_list, size_t max_entries) {
+    const struct VizableMap* map = (const struct VizableMap*)self;
+    if (map == NULL || viz_list == NULL) {
+        return 0;
+    }
+    viz_list->len = 0;
+
+    VizList_Add(viz_list, max_entries, ArrayArenaOffsetOf(map->arena, map),
+                sizeof(struct VizableMap), ARENA_VIZ_BLK_ALLOCATED);
+
+    // Runs of used and of empty slots, in table order
+    size_t table_offset = ArrayArenaOffsetOf(map->arena, map->slots);
+    for (size_t i = 0; i < map->num_slots && viz_list->len < max_entries; ) {
+        bool used = Map_Slot(map, i)->used != 0;
+        size_t run = 1;
+        while ((i + run) < map->num_slots && (Map_Slot(map, i + run)->used != 0) == used) {
+            run++;
+        }
+        VizList_Add(viz_list, max_entries, table_offset + (i * map->slot_size), run * map->slot_size,
+                    used ? ARENA_VIZ_BLK_ALLOCATED : ARENA_VIZ_BLK_FREE);
+        i += run;
+    }
+
+    return viz_list->len;
+}
+
+size_t Map_GetArenaSize(const void* self) {
+    const struct VizableMap* map = (const struct VizableMap*)self;
+    if (map == NULL) {
+        return 0;
+    }
+
+    return sizeof(struct VizableMap) + (map->num_slots * map->slot_size);
+}
+
+size_t Map_GetElementCount(const void* self) {
+    const struct VizableMap* map = (const struct VizableMap*)self;
+    if (map == NULL) {
+        return 0;
+    }
+
+    return map->length;
+}
+
+size_t Map_GetElementSize(const void* self) {
+    const struct VizableMap* map = (const struct VizableMap*)self;
+    if (map == NULL) {
+        return 0;
+    }
+
+    return map->value_size;
+}
+
+bool Map_IsEmpty(const void* self) {
+    const struct VizableMap* map = (const struct VizableMap*)self;
+    if (map == NULL) {
+        return true;
+    }
+
+    return map->length == 0;
+}
+
+void Map_Destroy(void* self) {
+    struct VizableMap* map = (struct VizableMap*)self;
+    if (map == NULL) {
+        return;
+    }
+
+    ArrayArenaFree(map->arena, map->slots);
+    ArrayArenaFree(map->arena, map);
+}
+
+/**
+ * @brief Hash map operations
+ */
+struct VizableMap* VizableMap_Create(struct ArrayArena_S* arena, size_t value_size, size_t initial_capacity) {
+    if (value_size > (SIZE_MAX - sizeof(struct VizableMapSlot) - MAP_VALUE_ALIGN)) {
+        return NULL;
+    }
+
+    struct VizableMap* map = Container_AllocHeader(arena, sizeof(struct VizableMap));
+    if (map == NULL) {
+        return NULL;
+    }
+
+    VizableMap_InitVizable(map);
+
+    map->arena = arena;
+    map->slots = NULL;
+    map->value_size = value_size;
+    map->slot_size = (sizeof(struct VizableMapSlot) + value_size + (MAP_VALUE_ALIGN - 1)) & ~(size_t)(MAP_VALUE_ALIGN - 1);
+    map->num_slots = 0;
+    map->length = 0;
+
+    // Enough slots to hold initial_capacity entries at most 3/4 full
+    size_t min_slots = 2;
+    while ((min_slots * 3) < (initial_capacity * 4) && min_slots < (SIZE_MAX / 8)) {
+        min_slots *= 2;
+    }
+    if (initial_capacity > 0 && !Map_Rebuild(map, min_slots)) {
+        ArrayArenaFree(arena, map);
+        return NULL;
+    }
+
+    return map;
+}
+
+bool VizableMap_Put(struct VizableMap* map, uint32_t key, const void* value) {
+    if (map == NULL || (value == NULL && map->value_size > 0)) {
+        return false;
+    }
+
+    struct VizableMapSlot* slot = (map->num_slots > 0) ? Map_Slot(map, Map_Probe(map, key)) : NULL;
+    if (slot == NULL || !slot->used) {
+        if (((map->length + 1) * 4) > (map->num_slots * 3)) {
+            if (!Map_Rebuild(map, (map->num_slots > 0) ? (map->num_slots * 2) : 2)) {
+                return false;
+            }
+        }
+        slot = Map_Slot(map, Map_Probe(map, key));
+        slot->key = key;
+        slot->used = 1;
+        map->length++;
+    }
+
+    if (map->value_size > 0) {
+        memcpy(slot + 1, value, map->value_size);
+    }
+    return true;
+}
+
+void* VizableMap_Get(const struct VizableMap* map, uint32_t key) {
+    if (map == NULL || map->num_slots == 0) {
+        return NULL;
+    }
+
+    struct VizableMapSlot* slot = Map_Slot(map, Map_Probe(map, key));
+    return slot->used ? (void*)(slot + 1) : NULL;
+}
+
+bool VizableMap_Remove(struct VizableMap* map, uint32_t key) {
+    if (map == NULL || map->num_slots == 0) {
+        return false;
+    }
+
+    size_t mask = map->num_slots - 1;
+    size_t hole = Map_Probe(map, key);
+    if (!Map_Slot(map, hole)->used) {
+        return false;
+    }
+
+    // Pull each later entry of the probe run back into the hole, unless its
+    // home slot lies between the hole and it (then it has to stay past its home)
+    for (size_t idx = (hole + 1) & mask; Map_Slot(map, idx)->used; idx = (idx + 1) & mask) {
+        size_t home = Map_Hash(Map_Slot(map, idx)->key) & mask;
+        if (((idx - home) & mask) >= ((idx - hole) & mask)) {
+            memcpy(Map_Slot(map, hole), Map_Slot(map, idx), map->slot_size);
+            hole = idx;
+        }
+    }
+    Map_Slot(map, hole)->used = 0;
+    map->length--;
+    return true;
+}
+
 /**
  * @brief Example usage demonstration
  */
 void Example_VizableUsage(void) {
-    // Create a vizable vector
-    struct VizableVector* vec = VizableVector_Create(sizeof(int), 10);
+    // Create a vizable vector on the default arena (see StaticArrayPoolInit())
+    struct VizableVector* vec = VizableVector_Create(&ArrayArena, sizeof(int), 10);
     if (vec == NULL) {
         return;
     }
-    
-    // Use the vizable interface
+
+    for (int i = 0; i < 100; i++) {
+        if (!VizableVector_Push(vec, &i)) {
+            break;
+        }
+    }
+
+    // Use the vizable interface, e.g. to show where the vector sits in the arena
+    struct ArenaVizBlk blks[3];
+    struct ArenaVizList viz_list = { .list = blks, .len = 0 };
+    size_t num_entries = VIZABLE_GET_ARENA_LAYOUT(vec, &viz_list, 3);
     size_t arena_size = VIZABLE_GET_ARENA_SIZE(vec);
     size_t element_count = VIZABLE_GET_ELEMENT_COUNT(vec);
     const char* type_name = VIZABLE_GET_TYPE_NAME(vec);
-    
+
     // Example: Pass to a generic function that works with any vizable object
     // ProcessVizableObject(AS_VIZABLE(vec));
-    
+
     // Clean up
-    VIZABLE_CALL(vec, destroy);
-    
+    AS_VIZABLE(vec)->vtable->destroy(vec);
+
     // Suppress unused variable warnings for this example
+    (void)num_entries;
     (void)arena_size;
     (void)element_count;
     (void)type_name;
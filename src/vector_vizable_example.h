@@ -1,32 +1,83 @@
 #ifndef VECTOR_VIZABLE_EXAMPLE_H
 #define VECTOR_VIZABLE_EXAMPLE_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "vizable_vtable.h"
-#include "../inc/vector.h"
+#include "vizable.h"
 
-// Forward declaration for arena viz
-struct ArenaVizList;
+/**
+ * @brief Containers backed by an arena of sara.c, /w vizable support
+ *
+ * Each container, header and all, is allocated from the arena it is created
+ * on, and never from the heap. Capacities are sized from the bytes the arena
+ * actually grants (see ArrayArenaTryAlloc()), so the slack at the end of each
+ * block is used rather than wasted, and growing goes through a realloc, which
+ * stays in place whenever the arena can manage it. Once a container has grown
+ * to its working size, pushing and popping (or clearing and refilling) does
+ * not allocate at all.
+ *
+ * sara.c has to be built into the same translation unit, ahead of this
+ * example (as the vector lib does), e.g.:
+ *    #define STATIC static
+ *    #include "sara.c"
+ *    #include "vector_vizable_example.c"
+ *
+ * The layout each container exports through its vtable is that of its own
+ * blocks, at their offsets into the arena (see ArrayArenaOffsetOf()): what
+ * holds elements is "allocated", and what the container has room for but does
+ * not use (yet) is "free".
+ */
+struct ArrayArena_S;
 
 /**
- * @brief Enhanced Vector structure with vizable support
- * 
- * This shows how you could modify your existing Vector struct
- * to support the vizable interface using the vtable approach.
+ * @brief Dynamic array
  */
 struct VizableVector {
     VIZABLE_HEADER;  // Embeds struct VizableBase vizable_base
-    
-    // Your existing vector fields would go here
-    // (This is just an example structure)
+
+    struct ArrayArena_S* arena;  // Arena the vector and its elements live in
     void* data;
     size_t element_size;
     size_t length;
+    size_t capacity;  // Elements that fit in the block data was granted
+};
+
+/**
+ * @brief Ring buffer (FIFO) of a fixed capacity
+ */
+struct VizableRing {
+    VIZABLE_HEADER;
+
+    struct ArrayArena_S* arena;
+    uint8_t* data;
+    size_t element_size;
+    size_t head;  // Idx of the oldest element
+    size_t length;
     size_t capacity;
-    size_t max_capacity;
 };
 
 /**
- * @brief Vector-specific vizable function implementations
+ * @brief Hash map from 32-bit keys to values of a fixed size
+ *
+ * Open addressing /w linear probing, and backward-shift deletion, so that
+ * there are no tombstones to build up. The table is kept at most 3/4 full, and
+ * is rebuilt at twice the size (or as many slots as the block granted holds)
+ * when it would get any fuller.
+ */
+struct VizableMap {
+    VIZABLE_HEADER;
+
+    struct ArrayArena_S* arena;
+    uint8_t* slots;     // num_slots slots of slot_size bytes
+    size_t value_size;
+    size_t slot_size;   // Key and used flag, then the value, rounded up
+    size_t num_slots;   // A power of 2 (or 0 before the first put)
+    size_t length;
+};
+
+/**
+ * @brief Vizable function implementations of each container
  */
 size_t Vector_GetArenaLayout(const void* self, struct ArenaVizList* viz_list, size_t max_entries);
 size_t Vector_GetArenaSize(const void* self);
@@ -35,15 +86,56 @@ size_t Vector_GetElementSize(const void* self);
 bool Vector_IsEmpty(const void* self);
 void Vector_Destroy(void* self);
 
+size_t Ring_GetArenaLayout(const void* self, struct ArenaVizList* viz_list, size_t max_entries);
+size_t Ring_GetArenaSize(const void* self);
+size_t Ring_GetElementCount(const void* self);
+size_t Ring_GetElementSize(const void* self);
+bool Ring_IsEmpty(const void* self);
+void Ring_Destroy(void* self);
+
+size_t Map_GetArenaLayout(const void* self, struct ArenaVizList* viz_list, size_t max_entries);
+size_t Map_GetArenaSize(const void* self);
+size_t Map_GetElementCount(const void* self);
+size_t Map_GetElementSize(const void* self);
+bool Map_IsEmpty(const void* self);
+void Map_Destroy(void* self);
+
 /**
- * @brief Vector vtable declaration
+ * @brief Vtable declarations
  */
 DECLARE_VIZABLE_VTABLE(VizableVector);
+DECLARE_VIZABLE_VTABLE(VizableRing);
+DECLARE_VIZABLE_VTABLE(VizableMap);
+
+/**
+ * @brief Vector operations. Pushes fail (returning false) only when the arena
+ *        cannot grant the room; the vector is then left as it was.
+ */
+struct VizableVector* VizableVector_Create(struct ArrayArena_S* arena, size_t element_size, size_t initial_capacity);
+bool VizableVector_Reserve(struct VizableVector* vec, size_t min_capacity);
+bool VizableVector_Push(struct VizableVector* vec, const void* element);
+bool VizableVector_Pop(struct VizableVector* vec, void* element_out);
+void* VizableVector_At(const struct VizableVector* vec, size_t idx);
+void VizableVector_Clear(struct VizableVector* vec);
+bool VizableVector_ShrinkToFit(struct VizableVector* vec);
+
+/**
+ * @brief Ring buffer operations. The capacity is at least the one asked for,
+ *        and pushes fail (returning false) when the ring is full.
+ */
+struct VizableRing* VizableRing_Create(struct ArrayArena_S* arena, size_t element_size, size_t capacity);
+bool VizableRing_Push(struct VizableRing* ring, const void* element);
+bool VizableRing_Pop(struct VizableRing* ring, void* element_out);
+void* VizableRing_Peek(const struct VizableRing* ring);
 
 /**
- * @brief Constructor for vizable vector
+ * @brief Hash map operations. A put of a key that is already there replaces
+ *        its value.
  */
-struct VizableVector* VizableVector_Create(size_t element_size, size_t initial_capacity);
+struct VizableMap* VizableMap_Create(struct ArrayArena_S* arena, size_t value_size, size_t initial_capacity);
+bool VizableMap_Put(struct VizableMap* map, uint32_t key, const void* value);
+void* VizableMap_Get(const struct VizableMap* map, uint32_t key);
+bool VizableMap_Remove(struct VizableMap* map, uint32_t key);
 
 /**
  * @brief Example usage functions